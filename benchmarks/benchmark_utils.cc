@@ -0,0 +1,237 @@
+#include "benchmarks/benchmark_utils.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include "benchmark/benchmark.h"
+#include "libfbsdf/gzip_istream.h"
+#include "libfbsdf/test_bsdf_writer.h"
+#include "test_data/test_data.h"
+
+namespace {
+
+// Every allocation is prefixed with a header that records its size so that the
+// number of bytes currently allocated can be tracked on deallocation.
+constexpr size_t kHeaderSize = alignof(std::max_align_t);
+
+std::atomic<size_t> num_allocations = 0;
+std::atomic<size_t> allocated_bytes = 0;
+std::atomic<size_t> peak_allocated_bytes = 0;
+
+void* Allocate(size_t size, size_t alignment) {
+  size_t header_size = std::max(alignment, kHeaderSize);
+  if (size > std::numeric_limits<size_t>::max() - 2u * header_size) {
+    throw std::bad_alloc();
+  }
+
+  void* allocation;
+  if (alignment <= kHeaderSize) {
+    allocation = std::malloc(header_size + size);
+  } else {
+    size_t padded_size = (header_size + size + alignment - 1u) / alignment;
+    allocation = std::aligned_alloc(alignment, padded_size * alignment);
+  }
+
+  if (allocation == nullptr) {
+    throw std::bad_alloc();
+  }
+
+  std::byte* result = static_cast<std::byte*>(allocation) + header_size;
+  std::memcpy(result - sizeof(size_t), &size, sizeof(size_t));
+
+  num_allocations.fetch_add(1u, std::memory_order_relaxed);
+  size_t current = allocated_bytes.fetch_add(size) + size;
+  size_t peak = peak_allocated_bytes.load();
+  while (peak < current &&
+         !peak_allocated_bytes.compare_exchange_weak(peak, current)) {
+  }
+
+  return result;
+}
+
+void Deallocate(void* ptr, size_t alignment) {
+  if (ptr == nullptr) {
+    return;
+  }
+
+  std::byte* bytes = static_cast<std::byte*>(ptr);
+
+  size_t size;
+  std::memcpy(&size, bytes - sizeof(size_t), sizeof(size_t));
+  allocated_bytes.fetch_sub(size);
+
+  std::free(bytes - std::max(alignment, kHeaderSize));
+}
+
+}  // namespace
+
+void* operator new(size_t size) { return Allocate(size, kHeaderSize); }
+
+void* operator new[](size_t size) { return Allocate(size, kHeaderSize); }
+
+void* operator new(size_t size, std::align_val_t alignment) {
+  return Allocate(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+  return Allocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept { Deallocate(ptr, kHeaderSize); }
+
+void operator delete[](void* ptr) noexcept { Deallocate(ptr, kHeaderSize); }
+
+void operator delete(void* ptr, size_t size) noexcept {
+  Deallocate(ptr, kHeaderSize);
+}
+
+void operator delete[](void* ptr, size_t size) noexcept {
+  Deallocate(ptr, kHeaderSize);
+}
+
+void operator delete(void* ptr, std::align_val_t alignment) noexcept {
+  Deallocate(ptr, static_cast<size_t>(alignment));
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept {
+  Deallocate(ptr, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* ptr, size_t size,
+                     std::align_val_t alignment) noexcept {
+  Deallocate(ptr, static_cast<size_t>(alignment));
+}
+
+void operator delete[](void* ptr, size_t size,
+                       std::align_val_t alignment) noexcept {
+  Deallocate(ptr, static_cast<size_t>(alignment));
+}
+
+namespace libfbsdf {
+namespace benchmarks {
+
+using ::libfbsdf::testing::kTestDataFiles;
+using ::libfbsdf::testing::SyntheticBsdfParams;
+using ::libfbsdf::testing::WriteSyntheticBsdfFile;
+
+const std::string& LoadTestData(const std::string& filename) {
+  static std::mutex mutex;
+  static std::map<std::string, std::string> cache;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  if (auto iter = cache.find(filename); iter != cache.end()) {
+    return iter->second;
+  }
+
+  std::ifstream file(kTestDataFiles.at(filename).path,
+                     std::ios::in | std::ios::binary);
+  if (!file) {
+    throw std::runtime_error("Failed to open test data: " + filename);
+  }
+
+  GzipIstream input(file);
+  std::string contents((std::istreambuf_iterator<char>(input)),
+                       std::istreambuf_iterator<char>());
+  if (input.failed()) {
+    throw std::runtime_error("Failed to load test data: " + filename);
+  }
+
+  return cache.emplace(filename, std::move(contents)).first->second;
+}
+
+std::span<const std::byte> TestDataBytes(const std::string& filename) {
+  return std::as_bytes(std::span(LoadTestData(filename)));
+}
+
+size_t NumCoefficients(const std::string& filename) {
+  return kTestDataFiles.at(filename).num_coefficients;
+}
+
+size_t NumAllocations() {
+  return num_allocations.load(std::memory_order_relaxed);
+}
+
+size_t ResetPeakAllocatedBytes() {
+  size_t current = allocated_bytes.load();
+  peak_allocated_bytes.store(current);
+  return current;
+}
+
+size_t PeakAllocatedBytes() { return peak_allocated_bytes.load(); }
+
+const std::filesystem::path& SyntheticBsdfPath(
+    const SyntheticBsdfParams& params) {
+  // Removes the files that were generated when the process exits
+  struct SyntheticFiles {
+    ~SyntheticFiles() {
+      for (const auto& [key, path] : paths) {
+        std::error_code error;
+        std::filesystem::remove(path, error);
+      }
+    }
+
+    std::map<std::array<size_t, 4>, std::filesystem::path> paths;
+  };
+
+  static std::mutex mutex;
+  static SyntheticFiles files;
+
+  std::array<size_t, 4> key = {
+      params.num_elevational_samples, params.num_basis_functions,
+      params.num_color_channels, params.longest_series_length};
+
+  std::lock_guard<std::mutex> lock(mutex);
+  if (auto iter = files.paths.find(key); iter != files.paths.end()) {
+    return iter->second;
+  }
+
+  std::filesystem::path path =
+      std::filesystem::temp_directory_path() /
+      ("libfbsdf_synthetic_" + std::to_string(key[0]) + "_" +
+       std::to_string(key[1]) + "_" + std::to_string(key[2]) + "_" +
+       std::to_string(key[3]) + ".bsdf");
+
+  std::ofstream output(path, std::ios::out | std::ios::binary);
+  WriteSyntheticBsdfFile(output, params);
+  if (!output.flush()) {
+    throw std::runtime_error("Failed to write " + path.string());
+  }
+
+  return files.paths.emplace(key, std::move(path)).first->second;
+}
+
+void ReportCounters(benchmark::State& state, size_t num_bytes,
+                    size_t num_coefficients, size_t num_allocations) {
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(num_bytes));
+
+  if (num_coefficients != 0u) {
+    state.counters["coefficients/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations()) *
+            static_cast<double>(num_coefficients),
+        benchmark::Counter::kIsRate);
+  }
+
+  state.counters["allocs"] =
+      benchmark::Counter(static_cast<double>(num_allocations),
+                         benchmark::Counter::kAvgIterations);
+}
+
+}  // namespace benchmarks
+}  // namespace libfbsdf
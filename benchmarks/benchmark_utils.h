@@ -0,0 +1,70 @@
+#ifndef _BENCHMARKS_BENCHMARK_UTILS_
+#define _BENCHMARKS_BENCHMARK_UTILS_
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "libfbsdf/test_bsdf_writer.h"
+
+namespace libfbsdf {
+namespace benchmarks {
+
+// Returns the decompressed contents of a test data file by name. The contents
+// are loaded the first time they are requested and cached thereafter so that
+// decompression is not included in any measurements.
+//
+// NOTE: The storage backing the returned string is aligned to at least a 4 byte
+//       boundary which allows it to be passed to the zero-copy reader paths.
+const std::string& LoadTestData(const std::string& filename);
+
+// Returns the contents of a test data file as bytes
+std::span<const std::byte> TestDataBytes(const std::string& filename);
+
+// Returns the number of Fourier coefficients in a test data file
+size_t NumCoefficients(const std::string& filename);
+
+// Returns the total number of calls to the global `operator new` made by the
+// process so far.
+size_t NumAllocations();
+
+// Resets the peak number of bytes allocated by the global `operator new` to
+// the number of bytes currently allocated and returns that number.
+size_t ResetPeakAllocatedBytes();
+
+// Returns the largest number of bytes that were allocated by the global
+// `operator new` at any one time since the last call to
+// `ResetPeakAllocatedBytes`.
+size_t PeakAllocatedBytes();
+
+// Returns the path of a synthetic BSDF file generated by
+// `WriteSyntheticBsdfFile`. The file is written to the temporary directory the
+// first time it is requested and is removed when the process exits.
+const std::filesystem::path& SyntheticBsdfPath(
+    const testing::SyntheticBsdfParams& params);
+
+// Reports the results of a benchmark that reads an input of `num_bytes` bytes
+// containing `num_coefficients` coefficients once per iteration, making
+// `num_allocations` allocations in total across all iterations. This sets the
+// number of bytes processed along with "coefficients/s" and "allocs" (per
+// iteration) counters. The "coefficients/s" counter is omitted if
+// `num_coefficients` is zero.
+void ReportCounters(benchmark::State& state, size_t num_bytes,
+                    size_t num_coefficients, size_t num_allocations);
+
+}  // namespace benchmarks
+}  // namespace libfbsdf
+
+// Registers a benchmark taking the name of a test data file once for each of
+// the bundled test data files
+#define LIBFBSDF_BENCHMARK_TEST_DATA(func)                            \
+  BENCHMARK_CAPTURE(func, leather, std::string("leather"));           \
+  BENCHMARK_CAPTURE(func, paint, std::string("paint"));               \
+  BENCHMARK_CAPTURE(func, roughglass_alpha_0_2,                       \
+                    std::string("roughglass_alpha_0.2"));             \
+  BENCHMARK_CAPTURE(func, roughgold_alpha_0_2,                        \
+                    std::string("roughgold_alpha_0.2"))
+
+#endif  // _BENCHMARKS_BENCHMARK_UTILS_
@@ -0,0 +1,50 @@
+#include <cstddef>
+#include <span>
+#include <spanstream>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "benchmarks/benchmark_utils.h"
+#include "libfbsdf/bsdf_header_reader.h"
+
+namespace libfbsdf {
+namespace benchmarks {
+namespace {
+
+void BM_ReadBsdfHeaderFromStream(benchmark::State& state,
+                                 const std::string& filename) {
+  std::ispanstream input(LoadTestData(filename));
+
+  size_t num_allocations = NumAllocations();
+  for (auto _ : state) {
+    input.clear();
+    input.seekg(0);
+
+    auto header = ReadBsdfHeader(input);
+    benchmark::DoNotOptimize(header);
+  }
+
+  ReportCounters(state, kBsdfHeaderSizeBytes, 0u,
+                 NumAllocations() - num_allocations);
+}
+
+void BM_ReadBsdfHeaderFromMemory(benchmark::State& state,
+                                 const std::string& filename) {
+  std::span<const std::byte> input = TestDataBytes(filename);
+
+  size_t num_allocations = NumAllocations();
+  for (auto _ : state) {
+    auto header = ReadBsdfHeader(input);
+    benchmark::DoNotOptimize(header);
+  }
+
+  ReportCounters(state, kBsdfHeaderSizeBytes, 0u,
+                 NumAllocations() - num_allocations);
+}
+
+LIBFBSDF_BENCHMARK_TEST_DATA(BM_ReadBsdfHeaderFromStream);
+LIBFBSDF_BENCHMARK_TEST_DATA(BM_ReadBsdfHeaderFromMemory);
+
+}  // namespace
+}  // namespace benchmarks
+}  // namespace libfbsdf
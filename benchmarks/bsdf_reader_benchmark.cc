@@ -0,0 +1,109 @@
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <spanstream>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "benchmarks/benchmark_utils.h"
+#include "libfbsdf/bsdf_reader.h"
+
+namespace libfbsdf {
+namespace benchmarks {
+namespace {
+
+// A reader that parses every section of its input and discards the results.
+// Since the bulk callbacks are overridden this measures the cost of parsing
+// alone without any per-value virtual calls.
+class NoOpBsdfReader final : public BsdfReader {
+ private:
+  std::expected<Options, std::string> Start(
+      const Flags& flags, size_t num_elevational_samples,
+      size_t num_basis_functions, size_t num_coefficients,
+      size_t num_color_channels, size_t longest_series_length,
+      size_t num_parameters, size_t num_parameter_values,
+      size_t metadata_size_bytes, float index_of_refraction,
+      float roughness_top, float roughness_bottom) override {
+    return Options();
+  }
+
+  std::expected<void, std::string> HandleElevationalSampleChunk(
+      std::span<const float> values) override {
+    benchmark::DoNotOptimize(values.data());
+    return std::expected<void, std::string>();
+  }
+
+  std::expected<void, std::string> HandleSampleCountChunk(
+      std::span<const uint32_t> values) override {
+    benchmark::DoNotOptimize(values.data());
+    return std::expected<void, std::string>();
+  }
+
+  std::expected<void, std::string> HandleSamplePositionChunk(
+      std::span<const float> values) override {
+    benchmark::DoNotOptimize(values.data());
+    return std::expected<void, std::string>();
+  }
+
+  std::expected<void, std::string> HandleCdfChunk(
+      std::span<const float> values) override {
+    benchmark::DoNotOptimize(values.data());
+    return std::expected<void, std::string>();
+  }
+
+  std::expected<void, std::string> HandleSeriesChunk(
+      std::span<const uint32_t> offsets_and_lengths) override {
+    benchmark::DoNotOptimize(offsets_and_lengths.data());
+    return std::expected<void, std::string>();
+  }
+
+  std::expected<void, std::string> HandleCoefficientChunk(
+      std::span<const float> values) override {
+    benchmark::DoNotOptimize(values.data());
+    return std::expected<void, std::string>();
+  }
+};
+
+void BM_ReadFromStream(benchmark::State& state, const std::string& filename) {
+  const std::string& contents = LoadTestData(filename);
+  std::ispanstream input(contents);
+  NoOpBsdfReader reader;
+
+  size_t num_allocations = NumAllocations();
+  for (auto _ : state) {
+    input.clear();
+    input.seekg(0);
+
+    if (auto result = reader.ReadFrom(input); !result) {
+      state.SkipWithError(result.error().c_str());
+      return;
+    }
+  }
+
+  ReportCounters(state, contents.size(), NumCoefficients(filename),
+                 NumAllocations() - num_allocations);
+}
+
+void BM_ReadFromMemory(benchmark::State& state, const std::string& filename) {
+  std::span<const std::byte> input = TestDataBytes(filename);
+  NoOpBsdfReader reader;
+
+  size_t num_allocations = NumAllocations();
+  for (auto _ : state) {
+    if (auto result = reader.ReadFrom(input); !result) {
+      state.SkipWithError(result.error().c_str());
+      return;
+    }
+  }
+
+  ReportCounters(state, input.size(), NumCoefficients(filename),
+                 NumAllocations() - num_allocations);
+}
+
+LIBFBSDF_BENCHMARK_TEST_DATA(BM_ReadFromStream);
+LIBFBSDF_BENCHMARK_TEST_DATA(BM_ReadFromMemory);
+
+}  // namespace
+}  // namespace benchmarks
+}  // namespace libfbsdf
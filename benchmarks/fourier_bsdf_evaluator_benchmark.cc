@@ -0,0 +1,174 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <spanstream>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "benchmarks/benchmark_utils.h"
+#include "libfbsdf/evaluators/fourier_bsdf_evaluator.h"
+#include "libfbsdf/readers/reciprocal_series.h"
+#include "libfbsdf/readers/series_truncation.h"
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+
+namespace libfbsdf {
+namespace benchmarks {
+namespace {
+
+constexpr size_t kNumQueries = 1u << 16u;
+
+struct Queries {
+  std::vector<float> mu_in;
+  std::vector<float> mu_out;
+  std::vector<float> phi;
+};
+
+Queries MakeQueries() {
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<float> mu(-1.0f, 1.0f);
+  std::uniform_real_distribution<float> phi(0.0f, 3.14159265f);
+
+  Queries queries;
+  for (size_t i = 0; i < kNumQueries; i++) {
+    queries.mu_in.push_back(mu(rng));
+    queries.mu_out.push_back(mu(rng));
+    queries.phi.push_back(phi(rng));
+  }
+
+  return queries;
+}
+
+void Evaluate(benchmark::State& state, const std::string& filename,
+              const ReadFromStandardBsdfOptions& options,
+              double truncation_threshold, double fold_tolerance = 0.0) {
+  std::ispanstream input(LoadTestData(filename));
+  auto bsdf = ReadFromStandardBsdf(input, options);
+  if (!bsdf) {
+    state.SkipWithError(bsdf.error().c_str());
+    return;
+  }
+
+  if (truncation_threshold > 0.0) {
+    auto truncated = TruncateSeries(*bsdf, truncation_threshold);
+    if (!truncated) {
+      state.SkipWithError(truncated.error().c_str());
+      return;
+    }
+  }
+
+  if (fold_tolerance > 0.0) {
+    auto folded = FoldReciprocalSeries(*bsdf, fold_tolerance);
+    if (!folded) {
+      state.SkipWithError(folded.error().c_str());
+      return;
+    }
+  }
+
+  FourierBsdfEvaluator evaluator(*bsdf);
+  Queries queries = MakeQueries();
+
+  size_t num_allocations = NumAllocations();
+  for (auto _ : state) {
+    for (size_t i = 0; i < kNumQueries; i++) {
+      benchmark::DoNotOptimize(evaluator.Evaluate(
+          queries.mu_in[i], queries.mu_out[i], queries.phi[i]));
+    }
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(kNumQueries));
+  ReportCounters(state, 0, 0, NumAllocations() - num_allocations);
+}
+
+void BM_Evaluate(benchmark::State& state, const std::string& filename) {
+  Evaluate(state, filename, {}, /*truncation_threshold=*/0.0);
+}
+
+void BM_EvaluateWithElevationalGuide(benchmark::State& state,
+                                     const std::string& filename) {
+  Evaluate(state, filename, {.build_elevational_guide = true},
+           /*truncation_threshold=*/0.0);
+}
+
+void BM_EvaluateWithCompactSeriesExtents(benchmark::State& state,
+                                         const std::string& filename) {
+  Evaluate(state, filename, {.compact_series_extents = true},
+           /*truncation_threshold=*/0.0);
+}
+
+void BM_EvaluateWithSeriesPadding(benchmark::State& state,
+                                  const std::string& filename) {
+  Evaluate(state, filename, {.series_padding = 4},
+           /*truncation_threshold=*/0.0);
+}
+
+void BM_EvaluateWithInterleavedColorChannels(benchmark::State& state,
+                                             const std::string& filename) {
+  Evaluate(state, filename, {.interleave_color_channels = true},
+           /*truncation_threshold=*/0.0);
+}
+
+void BM_EvaluateFloat16(benchmark::State& state,
+                        const std::string& filename) {
+  Evaluate(state, filename,
+           {.coefficient_format = CoefficientFormat::kFloat16},
+           /*truncation_threshold=*/0.0);
+}
+
+void BM_EvaluateBFloat16(benchmark::State& state,
+                         const std::string& filename) {
+  Evaluate(state, filename,
+           {.coefficient_format = CoefficientFormat::kBFloat16},
+           /*truncation_threshold=*/0.0);
+}
+
+void BM_EvaluateTruncated(benchmark::State& state,
+                          const std::string& filename) {
+  Evaluate(state, filename, {}, /*truncation_threshold=*/0.01);
+}
+
+void BM_EvaluateFolded(benchmark::State& state, const std::string& filename) {
+  Evaluate(state, filename, {}, /*truncation_threshold=*/0.0,
+           /*fold_tolerance=*/1e-3);
+}
+
+void BM_EvaluateBatch(benchmark::State& state, const std::string& filename) {
+  std::ispanstream input(LoadTestData(filename));
+  auto bsdf = ReadFromStandardBsdf(input);
+  if (!bsdf) {
+    state.SkipWithError(bsdf.error().c_str());
+    return;
+  }
+
+  FourierBsdfEvaluator evaluator(*bsdf);
+  Queries queries = MakeQueries();
+  std::vector<float> y(kNumQueries), r(kNumQueries), b(kNumQueries);
+
+  size_t num_allocations = NumAllocations();
+  for (auto _ : state) {
+    evaluator.EvaluateBatch(queries.mu_in, queries.mu_out, queries.phi, y, r,
+                            b);
+    benchmark::DoNotOptimize(y.data());
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(kNumQueries));
+  ReportCounters(state, 0, 0, NumAllocations() - num_allocations);
+}
+
+LIBFBSDF_BENCHMARK_TEST_DATA(BM_Evaluate);
+LIBFBSDF_BENCHMARK_TEST_DATA(BM_EvaluateWithElevationalGuide);
+LIBFBSDF_BENCHMARK_TEST_DATA(BM_EvaluateWithCompactSeriesExtents);
+LIBFBSDF_BENCHMARK_TEST_DATA(BM_EvaluateWithSeriesPadding);
+LIBFBSDF_BENCHMARK_TEST_DATA(BM_EvaluateWithInterleavedColorChannels);
+LIBFBSDF_BENCHMARK_TEST_DATA(BM_EvaluateFloat16);
+LIBFBSDF_BENCHMARK_TEST_DATA(BM_EvaluateBFloat16);
+LIBFBSDF_BENCHMARK_TEST_DATA(BM_EvaluateTruncated);
+LIBFBSDF_BENCHMARK_TEST_DATA(BM_EvaluateFolded);
+LIBFBSDF_BENCHMARK_TEST_DATA(BM_EvaluateBatch);
+
+}  // namespace
+}  // namespace benchmarks
+}  // namespace libfbsdf
@@ -0,0 +1,55 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <spanstream>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "benchmarks/benchmark_utils.h"
+#include "libfbsdf/evaluators/fourier_bsdf_sampler.h"
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+
+namespace libfbsdf {
+namespace benchmarks {
+namespace {
+
+constexpr size_t kNumSamples = 1u << 14u;
+
+void BM_Sample(benchmark::State& state, const std::string& filename) {
+  std::ispanstream input(LoadTestData(filename));
+  auto bsdf = ReadFromStandardBsdf(input);
+  if (!bsdf) {
+    state.SkipWithError(bsdf.error().c_str());
+    return;
+  }
+
+  FourierBsdfSampler sampler(*bsdf);
+
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<float> mu(-1.0f, 1.0f);
+  std::uniform_real_distribution<float> u(0.0f, 1.0f);
+  std::vector<float> mu_out, u_mu, u_phi;
+  for (size_t i = 0; i < kNumSamples; i++) {
+    mu_out.push_back(mu(rng));
+    u_mu.push_back(u(rng));
+    u_phi.push_back(u(rng));
+  }
+
+  size_t num_allocations = NumAllocations();
+  for (auto _ : state) {
+    for (size_t i = 0; i < kNumSamples; i++) {
+      benchmark::DoNotOptimize(sampler.Sample(mu_out[i], u_mu[i], u_phi[i]));
+    }
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(kNumSamples));
+  ReportCounters(state, 0, 0, NumAllocations() - num_allocations);
+}
+
+LIBFBSDF_BENCHMARK_TEST_DATA(BM_Sample);
+
+}  // namespace
+}  // namespace benchmarks
+}  // namespace libfbsdf
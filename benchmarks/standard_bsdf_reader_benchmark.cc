@@ -0,0 +1,85 @@
+#include <span>
+#include <spanstream>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "benchmark/benchmark.h"
+#include "benchmarks/benchmark_utils.h"
+#include "libfbsdf/readers/bsdf_cache.h"
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+
+namespace libfbsdf {
+namespace benchmarks {
+namespace {
+
+void ReadFromStandardBsdf(benchmark::State& state, const std::string& filename,
+                          const ReadFromStandardBsdfOptions& options) {
+  const std::string& contents = LoadTestData(filename);
+  std::ispanstream input(contents);
+
+  size_t num_allocations = NumAllocations();
+  for (auto _ : state) {
+    input.clear();
+    input.seekg(0);
+
+    auto result = libfbsdf::ReadFromStandardBsdf(input, options);
+    if (!result) {
+      state.SkipWithError(result.error().c_str());
+      return;
+    }
+
+    benchmark::DoNotOptimize(result);
+  }
+
+  ReportCounters(state, contents.size(), NumCoefficients(filename),
+                 NumAllocations() - num_allocations);
+}
+
+void BM_ReadFromStandardBsdf(benchmark::State& state,
+                             const std::string& filename) {
+  ReadFromStandardBsdf(state, filename, {});
+}
+
+void BM_ReadFromStandardBsdfLuminanceOnly(benchmark::State& state,
+                                          const std::string& filename) {
+  ReadFromStandardBsdf(state, filename, {.luminance_only = true});
+}
+
+void BM_ReadBsdfCache(benchmark::State& state, const std::string& filename) {
+  std::ispanstream input(LoadTestData(filename));
+  auto bsdf = libfbsdf::ReadFromStandardBsdf(input);
+  if (!bsdf) {
+    state.SkipWithError(bsdf.error().c_str());
+    return;
+  }
+
+  std::ostringstream output;
+  if (auto written = WriteBsdfCache(*bsdf, 0, output); !written) {
+    state.SkipWithError(written.error().c_str());
+    return;
+  }
+  std::string cache = std::move(output).str();
+
+  size_t num_allocations = NumAllocations();
+  for (auto _ : state) {
+    auto result = ReadBsdfCache(std::as_bytes(std::span<const char>(cache)));
+    if (!result) {
+      state.SkipWithError(result.error().c_str());
+      return;
+    }
+
+    benchmark::DoNotOptimize(result);
+  }
+
+  ReportCounters(state, cache.size(), NumCoefficients(filename),
+                 NumAllocations() - num_allocations);
+}
+
+LIBFBSDF_BENCHMARK_TEST_DATA(BM_ReadFromStandardBsdf);
+LIBFBSDF_BENCHMARK_TEST_DATA(BM_ReadFromStandardBsdfLuminanceOnly);
+LIBFBSDF_BENCHMARK_TEST_DATA(BM_ReadBsdfCache);
+
+}  // namespace
+}  // namespace benchmarks
+}  // namespace libfbsdf
@@ -0,0 +1,82 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "benchmarks/benchmark_utils.h"
+#include "libfbsdf/bsdf_header_reader.h"
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+#include "libfbsdf/test_bsdf_writer.h"
+
+namespace libfbsdf {
+namespace benchmarks {
+namespace {
+
+using ::libfbsdf::testing::SyntheticBsdfParams;
+
+// Measures how the time and memory needed by `ReadFromStandardBsdf` scale with
+// the size of its input. The arguments of each run are the number of
+// elevational samples, basis functions and color channels in the input along
+// with the length of its longest series.
+void BM_ReadFromStandardBsdf(benchmark::State& state) {
+  SyntheticBsdfParams params{
+      .num_elevational_samples = static_cast<size_t>(state.range(0)),
+      .num_basis_functions = static_cast<size_t>(state.range(1)),
+      .num_color_channels = static_cast<size_t>(state.range(2)),
+      .longest_series_length = static_cast<size_t>(state.range(3))};
+
+  const std::filesystem::path& path = SyntheticBsdfPath(params);
+  std::ifstream input(path, std::ios::in | std::ios::binary);
+
+  auto header = ReadBsdfHeader(input);
+  if (!header) {
+    state.SkipWithError(std::string(header.error()).c_str());
+    return;
+  }
+
+  size_t peak_bytes = 0;
+  size_t num_allocations = NumAllocations();
+  for (auto _ : state) {
+    input.clear();
+    input.seekg(0);
+
+    size_t baseline_bytes = ResetPeakAllocatedBytes();
+
+    auto result = ReadFromStandardBsdf(input);
+    if (!result) {
+      state.SkipWithError(result.error().c_str());
+      return;
+    }
+
+    peak_bytes = std::max(peak_bytes, PeakAllocatedBytes() - baseline_bytes);
+  }
+
+  size_t file_size = std::filesystem::file_size(path);
+  ReportCounters(state, file_size, header->num_coefficients,
+                 NumAllocations() - num_allocations);
+  state.counters["peak_bytes"] =
+      benchmark::Counter(static_cast<double>(peak_bytes),
+                         benchmark::Counter::kDefaults,
+                         benchmark::Counter::OneK::kIs1024);
+  state.SetComplexityN(static_cast<int64_t>(file_size));
+}
+
+BENCHMARK(BM_ReadFromStandardBsdf)
+    ->ArgNames({"samples", "bases", "channels", "length"})
+    ->Args({250, 1, 3, 16})
+    ->Args({500, 1, 3, 16})
+    ->Args({1000, 1, 3, 16})
+    ->Args({2000, 1, 3, 16})
+    ->Args({500, 1, 3, 64})
+    ->Args({500, 1, 3, 256})
+    ->Args({500, 4, 3, 16})
+    ->Args({500, 8, 3, 16})
+    ->Unit(benchmark::kMillisecond)
+    ->Complexity(benchmark::oN);
+
+}  // namespace
+}  // namespace benchmarks
+}  // namespace libfbsdf
@@ -0,0 +1,74 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <spanstream>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "benchmarks/benchmark_utils.h"
+#include "libfbsdf/evaluators/tabulated_bsdf.h"
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+
+namespace libfbsdf {
+namespace benchmarks {
+namespace {
+
+constexpr size_t kNumPhiSamples = 64;
+constexpr size_t kNumQueries = 1u << 16u;
+
+void BM_Build(benchmark::State& state, const std::string& filename) {
+  std::ispanstream input(LoadTestData(filename));
+  auto bsdf = ReadFromStandardBsdf(input);
+  if (!bsdf) {
+    state.SkipWithError(bsdf.error().c_str());
+    return;
+  }
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(TabulatedBsdf::Build(*bsdf, kNumPhiSamples));
+  }
+}
+
+void BM_Lookup(benchmark::State& state, const std::string& filename) {
+  std::ispanstream input(LoadTestData(filename));
+  auto bsdf = ReadFromStandardBsdf(input);
+  if (!bsdf) {
+    state.SkipWithError(bsdf.error().c_str());
+    return;
+  }
+
+  auto table = TabulatedBsdf::Build(*bsdf, kNumPhiSamples);
+  if (!table) {
+    state.SkipWithError(table.error().c_str());
+    return;
+  }
+
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<float> mu(-1.0f, 1.0f);
+  std::uniform_real_distribution<float> phi(0.0f, 3.14159265f);
+  std::vector<float> mu_in, mu_out, angles;
+  for (size_t i = 0; i < kNumQueries; i++) {
+    mu_in.push_back(mu(rng));
+    mu_out.push_back(mu(rng));
+    angles.push_back(phi(rng));
+  }
+
+  size_t num_allocations = NumAllocations();
+  for (auto _ : state) {
+    for (size_t i = 0; i < kNumQueries; i++) {
+      benchmark::DoNotOptimize(table->Lookup(mu_in[i], mu_out[i], angles[i]));
+    }
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(kNumQueries));
+  ReportCounters(state, 0, 0, NumAllocations() - num_allocations);
+}
+
+LIBFBSDF_BENCHMARK_TEST_DATA(BM_Build);
+LIBFBSDF_BENCHMARK_TEST_DATA(BM_Lookup);
+
+}  // namespace
+}  // namespace benchmarks
+}  // namespace libfbsdf
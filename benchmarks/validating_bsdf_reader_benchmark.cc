@@ -0,0 +1,71 @@
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <spanstream>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "benchmarks/benchmark_utils.h"
+#include "libfbsdf/readers/validating_bsdf_reader.h"
+
+namespace libfbsdf {
+namespace benchmarks {
+namespace {
+
+// A reader that validates and aggregates every section of its input before
+// discarding the results.
+class NoOpValidatingBsdfReader final : public ValidatingBsdfReader {
+ private:
+  std::expected<Options, std::string> Start(const Flags& flags,
+                                            uint32_t num_basis_functions,
+                                            size_t num_color_channels,
+                                            float index_of_refraction,
+                                            float roughness_top,
+                                            float roughness_bottom) override {
+    return Options();
+  }
+};
+
+void BM_ReadFromStream(benchmark::State& state, const std::string& filename) {
+  const std::string& contents = LoadTestData(filename);
+  std::ispanstream input(contents);
+  NoOpValidatingBsdfReader reader;
+
+  size_t num_allocations = NumAllocations();
+  for (auto _ : state) {
+    input.clear();
+    input.seekg(0);
+
+    if (auto result = reader.ReadFrom(input); !result) {
+      state.SkipWithError(result.error().c_str());
+      return;
+    }
+  }
+
+  ReportCounters(state, contents.size(), NumCoefficients(filename),
+                 NumAllocations() - num_allocations);
+}
+
+void BM_ReadFromMemory(benchmark::State& state, const std::string& filename) {
+  std::span<const std::byte> input = TestDataBytes(filename);
+  NoOpValidatingBsdfReader reader;
+
+  size_t num_allocations = NumAllocations();
+  for (auto _ : state) {
+    if (auto result = reader.ReadFrom(input); !result) {
+      state.SkipWithError(result.error().c_str());
+      return;
+    }
+  }
+
+  ReportCounters(state, input.size(), NumCoefficients(filename),
+                 NumAllocations() - num_allocations);
+}
+
+LIBFBSDF_BENCHMARK_TEST_DATA(BM_ReadFromStream);
+LIBFBSDF_BENCHMARK_TEST_DATA(BM_ReadFromMemory);
+
+}  // namespace
+}  // namespace benchmarks
+}  // namespace libfbsdf
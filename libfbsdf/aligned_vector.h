@@ -0,0 +1,55 @@
+#ifndef _LIBFBSDF_ALIGNED_VECTOR_
+#define _LIBFBSDF_ALIGNED_VECTOR_
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace libfbsdf {
+
+// An allocator that aligns each allocation to `Alignment` bytes, which must be
+// at least the alignment of `T`.
+template <typename T, size_t Alignment>
+class AlignedAllocator {
+ public:
+  static_assert(Alignment >= alignof(T));
+
+  using value_type = T;
+
+  template <typename U>
+  struct rebind {
+    using other = AlignedAllocator<U, Alignment>;
+  };
+
+  AlignedAllocator() = default;
+
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+  T* allocate(size_t n) {
+    return static_cast<T*>(
+        ::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+  }
+
+  void deallocate(T* ptr, size_t n) {
+    ::operator delete(ptr, n * sizeof(T), std::align_val_t(Alignment));
+  }
+
+  template <typename U>
+  bool operator==(const AlignedAllocator<U, Alignment>&) const {
+    return true;
+  }
+};
+
+// The alignment of the coefficient arrays of BSDFs, a cache line on common
+// hardware and enough for aligned loads of any x86 vector register
+inline constexpr size_t kCoefficientAlignment = 64;
+
+// A vector whose elements start on a `kCoefficientAlignment` byte boundary
+template <typename T>
+using AlignedVector =
+    std::vector<T, AlignedAllocator<T, kCoefficientAlignment>>;
+
+}  // namespace libfbsdf
+
+#endif  // _LIBFBSDF_ALIGNED_VECTOR_
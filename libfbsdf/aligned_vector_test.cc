@@ -0,0 +1,39 @@
+#include "libfbsdf/aligned_vector.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "googletest/include/gtest/gtest.h"
+
+namespace libfbsdf {
+namespace {
+
+bool IsAligned(const void* ptr) {
+  return reinterpret_cast<uintptr_t>(ptr) % kCoefficientAlignment == 0;
+}
+
+TEST(AlignedVector, Aligned) {
+  for (size_t size : {1u, 3u, 16u, 17u, 1000u}) {
+    AlignedVector<float> values(size, 1.0f);
+    EXPECT_TRUE(IsAligned(values.data())) << size;
+
+    values.push_back(2.0f);
+    EXPECT_TRUE(IsAligned(values.data())) << size;
+  }
+}
+
+TEST(AlignedVector, CopyAndMove) {
+  AlignedVector<float> values = {1.0f, 2.0f, 3.0f};
+
+  AlignedVector<float> copy = values;
+  EXPECT_TRUE(IsAligned(copy.data()));
+  EXPECT_EQ(values, copy);
+
+  AlignedVector<float> moved = std::move(copy);
+  EXPECT_TRUE(IsAligned(moved.data()));
+  EXPECT_EQ(values, moved);
+}
+
+}  // namespace
+}  // namespace libfbsdf
@@ -1,11 +1,14 @@
 #include "libfbsdf/bsdf_header_reader.h"
 
+#include <algorithm>
 #include <bit>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <expected>
 #include <istream>
+#include <span>
+#include <spanstream>
 #include <string_view>
 
 namespace libfbsdf {
@@ -223,4 +226,12 @@ std::expected<BsdfHeader, std::string_view> ReadBsdfHeader(
   return header;
 }
 
+std::expected<BsdfHeader, std::string_view> ReadBsdfHeader(
+    std::span<const std::byte> input) {
+  std::ispanstream stream(std::span<const char>(
+      reinterpret_cast<const char*>(input.data()),
+      std::min(input.size(), kBsdfHeaderSizeBytes)));
+  return ReadBsdfHeader(stream);
+}
+
 }  // namespace libfbsdf
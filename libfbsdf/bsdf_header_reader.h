@@ -5,6 +5,7 @@
 #include <cstdint>
 #include <expected>
 #include <istream>
+#include <span>
 #include <string_view>
 
 namespace libfbsdf {
@@ -50,9 +51,17 @@ struct BsdfHeader final {
   float roughness[2];
 };
 
+// The size in bytes of the header at the start of every Fourier BSDF input
+constexpr size_t kBsdfHeaderSizeBytes = 64u;
+
 // NOTE: Behavior is undefined if input is not a binary stream
 std::expected<BsdfHeader, std::string_view> ReadBsdfHeader(std::istream& input);
 
+// Reads the header from the first `kBsdfHeaderSizeBytes` bytes of an input that
+// is stored in memory.
+std::expected<BsdfHeader, std::string_view> ReadBsdfHeader(
+    std::span<const std::byte> input);
+
 }  // namespace libfbsdf
 
 #endif  // _LIBFBSDF_BSDF_HEADER_READER_
@@ -5,6 +5,7 @@
 #include <cstdint>
 #include <fstream>
 #include <limits>
+#include <span>
 #include <sstream>
 #include <string>
 
@@ -145,6 +146,30 @@ TEST(BsdfHeaderReader, Succeeds) {
   EXPECT_EQ(result.roughness[1], 1.0f);
 }
 
+TEST(BsdfHeaderReader, SucceedsFromMemory) {
+  std::string header = MakeHeader(1.0, 2.0, 3.0);
+  EXPECT_EQ(kBsdfHeaderSizeBytes, header.size());
+
+  BsdfHeader result =
+      ReadBsdfHeader(std::as_bytes(std::span<const char>(header))).value();
+  EXPECT_EQ(result.version, 1u);
+  EXPECT_TRUE(result.is_bsdf);
+  EXPECT_EQ(result.num_elevational_samples, 0x04030201u);
+  EXPECT_EQ(result.index_of_refraction, 1.0f);
+  EXPECT_EQ(result.roughness[0], 2.0f);
+  EXPECT_EQ(result.roughness[1], 3.0f);
+}
+
+TEST(BsdfHeaderReader, UnexpectedEOFFromMemory) {
+  std::string header = MakeHeader(1.0, 1.0, 1.0);
+  for (size_t i = 7; i < header.size(); i++) {
+    EXPECT_EQ("Unexpected EOF",
+              ReadBsdfHeader(std::as_bytes(std::span<const char>(header))
+                                 .first(i))
+                  .error());
+  }
+}
+
 TEST(BsdfHeaderReader, BadHeader) {
   for (size_t i = 0; i < 7; i++) {
     std::string header = MakeHeader(1.0, 1.0, 1.0);
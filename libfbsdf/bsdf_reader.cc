@@ -1,98 +1,250 @@
 #include "libfbsdf/bsdf_reader.h"
 
+#include <algorithm>
 #include <bit>
-#include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <expected>
 #include <istream>
 #include <limits>
+#include <span>
+#include <string>
+#include <string_view>
 #include <utility>
 
 #include "libfbsdf/bsdf_header_reader.h"
+#include "libfbsdf/bsdf_section_index.h"
+#include "libfbsdf/float_decoding.h"
 
 namespace libfbsdf {
 namespace {
 
 const char* UnexpectedEOF() { return "Unexpected EOF"; }
 
-std::expected<void, const char*> ParseUInt32(std::istream& input,
-                                             uint32_t* value) {
-  input.read(reinterpret_cast<char*>(value), sizeof(*value));
-  if (!input) {
-    return std::unexpected(UnexpectedEOF());
+// The maximum number of values passed to a single bulk callback when values
+// must be copied out of the input.
+constexpr size_t kChunkSize = 4096u;
+
+// An input stored in memory. Bytes are consumed from the front of `remaining`
+// as the input is parsed.
+struct MemoryInput {
+  std::span<const std::byte> remaining;
+};
+
+const char* NonFiniteValue() {
+  return "Input contained a non-finite floating point value";
+}
+
+std::expected<void, const char*> DecodeValues(std::span<uint32_t> values) {
+  DecodeUint32s(values);
+  return std::expected<void, const char*>();
+}
+
+std::expected<void, const char*> DecodeValues(std::span<float> values) {
+  if (!DecodeFloats(values)) {
+    return std::unexpected(NonFiniteValue());
   }
 
-  if constexpr (std::endian::native != std::endian::little) {
-    *value = std::byteswap(*value);
+  return std::expected<void, const char*>();
+}
+
+std::expected<void, const char*> ValidateValues(
+    std::span<const uint32_t> values) {
+  return std::expected<void, const char*>();
+}
+
+std::expected<void, const char*> ValidateValues(std::span<const float> values) {
+  if (!AllFinite(values)) {
+    return std::unexpected(NonFiniteValue());
   }
 
   return std::expected<void, const char*>();
 }
 
-std::expected<void, const char*> ParseFloat(std::istream& input, float* value) {
-  uint32_t bytes;
-  input.read(reinterpret_cast<char*>(&bytes), sizeof(bytes));
+template <typename T>
+std::expected<void, const char*> ParseValues(std::istream& input,
+                                             std::span<T> values) {
+  input.read(reinterpret_cast<char*>(values.data()), values.size_bytes());
   if (!input) {
     return std::unexpected(UnexpectedEOF());
   }
 
-  if constexpr (std::endian::native != std::endian::little) {
-    bytes = std::byteswap(bytes);
+  return DecodeValues(values);
+}
+
+template <typename T>
+std::expected<void, const char*> ParseValues(MemoryInput& input,
+                                             std::span<T> values) {
+  if (input.remaining.size() < values.size_bytes()) {
+    return std::unexpected(UnexpectedEOF());
   }
 
-  *value = std::bit_cast<float>(bytes);
+  std::memcpy(values.data(), input.remaining.data(), values.size_bytes());
+  input.remaining = input.remaining.subspan(values.size_bytes());
+
+  return DecodeValues(values);
+}
 
-  if (!std::isfinite(*value)) {
-    return std::unexpected("Input contained a non-finite floating point value");
+// Parses `num_values` values from the input, passing them to `handler` in
+// chunks of at most `kChunkSize` values.
+template <typename T, typename Handler>
+std::expected<void, std::string> ParseChunks(std::istream& input,
+                                             size_t num_values,
+                                             Handler handler) {
+  T chunk[kChunkSize];
+  while (num_values != 0) {
+    std::span<T> values(chunk, std::min(num_values, kChunkSize));
+
+    if (auto result = ParseValues(input, values); !result) {
+      return std::unexpected(result.error());
+    }
+
+    if (std::expected<void, std::string> result =
+            handler(std::span<const T>(values));
+        !result) {
+      return result;
+    }
+
+    num_values -= values.size();
   }
 
-  return std::expected<void, const char*>();
+  return std::expected<void, std::string>();
 }
 
-std::expected<void, const char*> SkipElements(std::istream& input,
-                                              size_t dimension_0,
-                                              size_t element_size) {
-  for (size_t i = 0; i < element_size; i++) {
-    if (!input.seekg(dimension_0, std::ios_base::cur)) {
-      return std::unexpected(UnexpectedEOF());
+// Parses `num_values` values from the input. On little-endian hosts, inputs
+// that are suitably aligned are passed to `handler` in a single chunk that
+// refers directly to the memory backing the input instead of being copied.
+template <typename T, typename Handler>
+std::expected<void, std::string> ParseChunks(MemoryInput& input,
+                                             size_t num_values,
+                                             Handler handler) {
+  if (std::endian::native != std::endian::little ||
+      reinterpret_cast<uintptr_t>(input.remaining.data()) % alignof(T) != 0) {
+    T chunk[kChunkSize];
+    while (num_values != 0) {
+      std::span<T> values(chunk, std::min(num_values, kChunkSize));
+
+      if (auto result = ParseValues(input, values); !result) {
+        return std::unexpected(result.error());
+      }
+
+      if (std::expected<void, std::string> result =
+              handler(std::span<const T>(values));
+          !result) {
+        return result;
+      }
+
+      num_values -= values.size();
     }
+
+    return std::expected<void, std::string>();
   }
 
-  return std::expected<void, const char*>();
+  if (input.remaining.size() / sizeof(T) < num_values) {
+    return std::unexpected(UnexpectedEOF());
+  }
+
+  std::span<const T> values(reinterpret_cast<const T*>(input.remaining.data()),
+                            num_values);
+  input.remaining = input.remaining.subspan(values.size_bytes());
+
+  if (auto result = ValidateValues(values); !result) {
+    return std::unexpected(result.error());
+  }
+
+  if (values.empty()) {
+    return std::expected<void, std::string>();
+  }
+
+  return handler(values);
+}
+
+std::expected<BsdfHeader, std::string_view> ReadBsdfHeader(
+    MemoryInput& input) {
+  auto header = libfbsdf::ReadBsdfHeader(input.remaining);
+  if (header) {
+    input.remaining = input.remaining.subspan(kBsdfHeaderSizeBytes);
+  }
+
+  return header;
+}
+
+std::expected<std::string, const char*> ReadMetadata(std::istream& input,
+                                                     size_t size) {
+  std::string metadata(size, '\0');
+  if (!input.read(metadata.data(), size)) {
+    return std::unexpected(UnexpectedEOF());
+  }
+
+  return metadata;
+}
+
+std::expected<std::string, const char*> ReadMetadata(MemoryInput& input,
+                                                     size_t size) {
+  if (input.remaining.size() < size) {
+    return std::unexpected(UnexpectedEOF());
+  }
+
+  std::string metadata(reinterpret_cast<const char*>(input.remaining.data()),
+                       size);
+  input.remaining = input.remaining.subspan(size);
+
+  return metadata;
 }
 
-std::expected<void, const char*> SkipElements(std::istream& input,
-                                              size_t dimension_0,
-                                              size_t dimension_1,
-                                              size_t element_size) {
-  for (size_t i = 0; i < element_size; i++) {
-    SkipElements(input, dimension_0, dimension_1);
+// Skips over a section of the input with a single seek
+std::expected<void, const char*> SkipSection(std::istream& input,
+                                             const BsdfSection& section) {
+  if (section.size_bytes == 0) {
+    return std::expected<void, const char*>();
+  }
+
+  if (section.size_bytes >
+          static_cast<size_t>(std::numeric_limits<std::streamoff>::max()) ||
+      !input.seekg(static_cast<std::streamoff>(section.size_bytes),
+                   std::ios_base::cur)) {
+    return std::unexpected(UnexpectedEOF());
   }
 
   return std::expected<void, const char*>();
 }
 
-std::expected<void, const char*> SkipElements(std::istream& input,
-                                              size_t dimension_0,
-                                              size_t dimension_1,
-                                              size_t dimension_2,
-                                              size_t element_size) {
-  for (size_t i = 0; i < element_size; i++) {
-    SkipElements(input, dimension_0, dimension_1, dimension_2);
+std::expected<void, const char*> SkipSection(MemoryInput& input,
+                                             const BsdfSection& section) {
+  if (input.remaining.size() < section.size_bytes) {
+    return std::unexpected(UnexpectedEOF());
   }
 
+  input.remaining = input.remaining.subspan(section.size_bytes);
+
   return std::expected<void, const char*>();
 }
 
 }  // namespace
 
 std::expected<void, std::string> BsdfReader::ReadFrom(std::istream& input) {
+  return ReadFromInput(input);
+}
+
+std::expected<void, std::string> BsdfReader::ReadFrom(
+    std::span<const std::byte> input) {
+  MemoryInput memory_input{input};
+  return ReadFromInput(memory_input);
+}
+
+template <typename Input>
+std::expected<void, std::string> BsdfReader::ReadFromInput(Input& input) {
   auto header = ReadBsdfHeader(input);
   if (!header) {
     return std::unexpected(std::string(header.error()));
   }
 
+  auto index = ComputeBsdfSectionIndex(*header);
+  if (!index) {
+    return std::unexpected(std::string(index.error()));
+  }
+
   Flags flags{
       .is_bsdf = header->is_bsdf,
       .uses_harmonic_extrapolation = header->uses_harmonic_extrapolation};
@@ -108,137 +260,121 @@ std::expected<void, std::string> BsdfReader::ReadFrom(std::istream& input) {
   }
 
   if (options->parse_elevational_samples) {
-    for (uint32_t i = 0; i < header->num_elevational_samples; i++) {
-      float value;
-      if (auto result = ParseFloat(input, &value); !result) {
-        return std::unexpected(result.error());
-      }
-
-      if (auto result = HandleElevationalSample(value); !result) {
-        return result;
-      }
+    if (auto result = ParseChunks<float>(
+            input, header->num_elevational_samples,
+            [&](std::span<const float> values) {
+              return HandleElevationalSampleChunk(values);
+            });
+        !result) {
+      return result;
     }
-  } else if (auto result = SkipElements(input, header->num_elevational_samples,
-                                        sizeof(float));
+  } else if (auto result = SkipSection(input, index->elevational_samples);
              !result) {
     return std::unexpected(result.error());
   }
 
   if (options->parse_parameter_sample_counts) {
-    for (uint32_t i = 0; i < header->num_parameters; i++) {
-      uint32_t value;
-      if (auto result = ParseUInt32(input, &value); !result) {
-        return std::unexpected(result.error());
-      }
-
-      if (auto result = HandleSampleCount(value); !result) {
-        return result;
-      }
+    if (auto result = ParseChunks<uint32_t>(
+            input, header->num_parameters,
+            [&](std::span<const uint32_t> values) {
+              return HandleSampleCountChunk(values);
+            });
+        !result) {
+      return result;
     }
-  } else if (auto result =
-                 SkipElements(input, header->num_parameters, sizeof(uint32_t));
+  } else if (auto result = SkipSection(input, index->parameter_sample_counts);
              !result) {
     return std::unexpected(result.error());
   }
 
   if (options->parse_parameter_values) {
-    for (uint32_t i = 0; i < header->num_parameter_values; i++) {
-      float value;
-      if (auto result = ParseFloat(input, &value); !result) {
-        return std::unexpected(result.error());
-      }
-
-      if (auto result = HandleSamplePosition(value); !result) {
-        return result;
-      }
+    if (auto result = ParseChunks<float>(
+            input, header->num_parameter_values,
+            [&](std::span<const float> values) {
+              return HandleSamplePositionChunk(values);
+            });
+        !result) {
+      return result;
     }
-  } else if (auto result = SkipElements(input, header->num_parameter_values,
-                                        sizeof(float));
+  } else if (auto result = SkipSection(input, index->parameter_values);
              !result) {
     return std::unexpected(result.error());
   }
 
   if (options->parse_cdf_mu) {
-    for (size_t i = 0; i < header->num_basis_functions; i++) {
-      for (size_t j = 0; j < header->num_elevational_samples; j++) {
-        for (size_t k = 0; k < header->num_elevational_samples; k++) {
-          float value;
-          if (auto result = ParseFloat(input, &value); !result) {
-            return std::unexpected(result.error());
-          }
-
-          if (auto result = HandleCdf(value); !result) {
-            return result;
-          }
-        }
+    size_t num_cdf_values =
+        static_cast<size_t>(header->num_elevational_samples) *
+        static_cast<size_t>(header->num_elevational_samples);
+    size_t num_cdfs = std::min(static_cast<size_t>(header->num_basis_functions),
+                               options->max_cdf_basis_functions);
+    for (size_t i = 0; i < num_cdfs; i++) {
+      if (auto result = ParseChunks<float>(input, num_cdf_values,
+                                           [&](std::span<const float> values) {
+                                             return HandleCdfChunk(values);
+                                           });
+          !result) {
+        return result;
       }
     }
-  } else if (auto result =
-                 SkipElements(input, header->num_basis_functions,
-                              header->num_elevational_samples,
-                              header->num_elevational_samples, sizeof(float));
-             !result) {
+
+    size_t parsed_size_bytes = num_cdfs * num_cdf_values * sizeof(float);
+    BsdfSection skipped_cdfs{
+        .offset = index->cdf.offset + parsed_size_bytes,
+        .size_bytes = index->cdf.size_bytes - parsed_size_bytes};
+    if (auto result = SkipSection(input, skipped_cdfs); !result) {
+      return std::unexpected(result.error());
+    }
+  } else if (auto result = SkipSection(input, index->cdf); !result) {
     return std::unexpected(result.error());
   }
 
   if (options->parse_series) {
     for (size_t i = 0; i < header->num_elevational_samples; i++) {
-      for (size_t j = 0; j < header->num_elevational_samples; j++) {
-        uint32_t offset;
-        if (auto result = ParseUInt32(input, &offset); !result) {
-          return std::unexpected(result.error());
-        }
-
-        uint32_t length;
-        if (auto result = ParseUInt32(input, &length); !result) {
-          return std::unexpected(result.error());
-        }
-
-        if (auto result = HandleSeries(offset, length); !result) {
-          return result;
-        }
+      if (auto result = ParseChunks<uint32_t>(
+              input, 2u * static_cast<size_t>(header->num_elevational_samples),
+              [&](std::span<const uint32_t> values) {
+                return HandleSeriesChunk(values);
+              });
+          !result) {
+        return result;
       }
     }
-  } else if (auto result = SkipElements(input, header->num_elevational_samples,
-                                        header->num_elevational_samples,
-                                        2 * sizeof(float));
-             !result) {
+  } else if (auto result = SkipSection(input, index->series); !result) {
     return std::unexpected(result.error());
   }
 
   if (options->parse_coefficients) {
-    for (uint32_t i = 0; i < header->num_coefficients; i++) {
-      float value;
-      if (auto result = ParseFloat(input, &value); !result) {
-        return std::unexpected(result.error());
-      }
-
-      if (auto result = HandleCoefficient(value); !result) {
-        return result;
-      }
+    if (auto result = ParseChunks<float>(
+            input, header->num_coefficients,
+            [&](std::span<const float> values) {
+              return HandleCoefficientChunk(values);
+            });
+        !result) {
+      return result;
     }
-  } else if (auto result =
-                 SkipElements(input, header->num_coefficients, sizeof(float));
-             !result) {
+  } else if (auto result = SkipSection(input, index->coefficients); !result) {
     return std::unexpected(result.error());
   }
 
   if (options->parse_metadata && header->num_metadata_bytes != 0) {
-    std::string metadata(header->num_metadata_bytes, '\0');
-    if (!input.read(metadata.data(), header->num_metadata_bytes)) {
-      return std::unexpected(UnexpectedEOF());
+    auto metadata = ReadMetadata(input, header->num_metadata_bytes);
+    if (!metadata) {
+      return std::unexpected(metadata.error());
     }
 
-    if (auto result = HandleMetadata(std::move(metadata)); !result) {
+    if (auto result = HandleMetadata(std::move(*metadata)); !result) {
       return result;
     }
-  } else if (!input.seekg(header->num_metadata_bytes, std::ios_base::cur)) {
-    return std::unexpected(UnexpectedEOF());
+  } else if (auto result = SkipSection(input, index->metadata); !result) {
+    return std::unexpected(result.error());
   }
 
   return std::expected<void, std::string>();
 }
 
+// This ensures that series chunks never split an offset from its length
+static_assert(kChunkSize % 2u == 0u);
+
 // This allows us to assume that uint32_t -> size_t conversions are not lossy
 static_assert(std::numeric_limits<uint32_t>::max() <=
               std::numeric_limits<size_t>::max());
@@ -5,6 +5,8 @@
 #include <cstdint>
 #include <expected>
 #include <istream>
+#include <limits>
+#include <span>
 #include <string>
 
 namespace libfbsdf {
@@ -18,6 +20,12 @@ class BsdfReader {
   // NOTE: Behavior is undefined if input is not a binary stream
   std::expected<void, std::string> ReadFrom(std::istream& input);
 
+  // Reads from an input that is stored in memory (for example, a memory mapped
+  // file). On little-endian hosts, if `input` is aligned to a 4 byte boundary
+  // each section of the input is passed to the bulk callbacks as a single chunk
+  // that refers directly into `input` without any intermediate copies.
+  std::expected<void, std::string> ReadFrom(std::span<const std::byte> input);
+
  protected:
   // Flags from the header of the input.
   struct Flags {
@@ -36,9 +44,16 @@ class BsdfReader {
     bool parse_series = true;
     bool parse_coefficients = true;
     bool parse_metadata = true;
+
+    // The maximum number of basis functions for which the CDF is parsed. The
+    // CDFs of any remaining basis functions are skipped.
+    size_t max_cdf_basis_functions = std::numeric_limits<size_t>::max();
   };
 
  private:
+  template <typename Input>
+  std::expected<void, std::string> ReadFromInput(Input& input);
+
   // Called at the start of parsing an input and passes information parsed from
   // the header of the input. Returns the parts of the input that should
   // be parsed or an error if the input cannot be read by the reader.
@@ -110,6 +125,92 @@ class BsdfReader {
   virtual std::expected<void, std::string> HandleMetadata(std::string data) {
     return std::expected<void, std::string>();
   }
+
+  // The following callbacks provide the same values as the callbacks above but
+  // in bulk, with each call providing a contiguous chunk of a section of the
+  // input. Chunks are provided in the order that they appear in the input and
+  // the span passed to each callback is only valid for the duration of the
+  // call. By default, each of these callbacks forwards its values one at a time
+  // to the corresponding per-value callback above. Derived classes that
+  // override a bulk callback will no longer receive calls to its corresponding
+  // per-value callback.
+
+  // Provides a chunk of the values passed to `HandleElevationalSample`.
+  virtual std::expected<void, std::string> HandleElevationalSampleChunk(
+      std::span<const float> values) {
+    for (float value : values) {
+      if (auto result = HandleElevationalSample(value); !result) {
+        return result;
+      }
+    }
+
+    return std::expected<void, std::string>();
+  }
+
+  // Provides a chunk of the values passed to `HandleSampleCount`.
+  virtual std::expected<void, std::string> HandleSampleCountChunk(
+      std::span<const uint32_t> values) {
+    for (uint32_t value : values) {
+      if (auto result = HandleSampleCount(value); !result) {
+        return result;
+      }
+    }
+
+    return std::expected<void, std::string>();
+  }
+
+  // Provides a chunk of the values passed to `HandleSamplePosition`.
+  virtual std::expected<void, std::string> HandleSamplePositionChunk(
+      std::span<const float> values) {
+    for (float value : values) {
+      if (auto result = HandleSamplePosition(value); !result) {
+        return result;
+      }
+    }
+
+    return std::expected<void, std::string>();
+  }
+
+  // Provides a chunk of the values passed to `HandleCdf`. A chunk never spans
+  // more than one basis function.
+  virtual std::expected<void, std::string> HandleCdfChunk(
+      std::span<const float> values) {
+    for (float value : values) {
+      if (auto result = HandleCdf(value); !result) {
+        return result;
+      }
+    }
+
+    return std::expected<void, std::string>();
+  }
+
+  // Provides a chunk of the values passed to `HandleSeries`. Offsets and
+  // lengths are interleaved such that even indices contain offsets and odd
+  // indices contain lengths. A chunk never splits an offset from its length.
+  virtual std::expected<void, std::string> HandleSeriesChunk(
+      std::span<const uint32_t> offsets_and_lengths) {
+    for (size_t i = 0; i + 1 < offsets_and_lengths.size(); i += 2) {
+      if (auto result =
+              HandleSeries(offsets_and_lengths[i], offsets_and_lengths[i + 1]);
+          !result) {
+        return result;
+      }
+    }
+
+    return std::expected<void, std::string>();
+  }
+
+  // Provides a chunk of the values passed to `HandleCoefficient`.
+  virtual std::expected<void, std::string> HandleCoefficientChunk(
+      std::span<const float> values) {
+    for (float value : values) {
+      if (auto result = HandleCoefficient(value); !result) {
+        return result;
+      }
+    }
+
+    return std::expected<void, std::string>();
+  }
 };
 
 }  // namespace libfbsdf
@@ -1,13 +1,19 @@
 #include "libfbsdf/bsdf_reader.h"
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <expected>
 #include <istream>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <span>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "googlemock/include/gmock/gmock.h"
 #include "googletest/include/gtest/gtest.h"
@@ -17,13 +23,18 @@
 namespace libfbsdf {
 namespace {
 
+using ::libfbsdf::testing::BsdfData;
 using ::libfbsdf::testing::FileParams;
+using ::libfbsdf::testing::Flags;
 using ::libfbsdf::testing::kTestDataFiles;
+using ::libfbsdf::testing::MakeBsdfFile;
 using ::libfbsdf::testing::MakeEmptyBsdfFile;
 using ::libfbsdf::testing::MakeMinimalBsdfFile;
 using ::libfbsdf::testing::MakeNonFiniteBsdfFile;
 using ::libfbsdf::testing::OpenTestData;
 using ::testing::_;
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
 using ::testing::Return;
 
 class FailImmediatelyBsdfReader : public BsdfReader {
@@ -576,5 +587,297 @@ TEST(BsdfReader, NonFiniteBsdfFails) {
   }
 }
 
+class ChunkedBsdfReader : public BsdfReader {
+ public:
+  std::expected<Options, std::string> Start(
+      const Flags& flags, size_t num_elevational_samples,
+      size_t num_basis_functions, size_t num_coefficients,
+      size_t num_color_channels, size_t longest_series_length,
+      size_t num_parameters, size_t num_parameter_values,
+      size_t metadata_size_bytes, float index_of_refraction,
+      float roughness_top, float roughness_bottom) {
+    Options options;
+    options.max_cdf_basis_functions = max_cdf_basis_functions;
+    return options;
+  }
+
+  std::expected<void, std::string> HandleElevationalSampleChunk(
+      std::span<const float> values) override {
+    num_chunks++;
+    elevational_samples.insert(elevational_samples.end(), values.begin(),
+                               values.end());
+    return std::expected<void, std::string>();
+  }
+
+  std::expected<void, std::string> HandleSampleCountChunk(
+      std::span<const uint32_t> values) override {
+    num_chunks++;
+    sample_counts.insert(sample_counts.end(), values.begin(), values.end());
+    return std::expected<void, std::string>();
+  }
+
+  std::expected<void, std::string> HandleSamplePositionChunk(
+      std::span<const float> values) override {
+    num_chunks++;
+    sample_positions.insert(sample_positions.end(), values.begin(),
+                            values.end());
+    return std::expected<void, std::string>();
+  }
+
+  std::expected<void, std::string> HandleCdfChunk(
+      std::span<const float> values) override {
+    num_chunks++;
+    cdf.insert(cdf.end(), values.begin(), values.end());
+    return std::expected<void, std::string>();
+  }
+
+  std::expected<void, std::string> HandleSeriesChunk(
+      std::span<const uint32_t> offsets_and_lengths) override {
+    num_chunks++;
+    EXPECT_EQ(0u, offsets_and_lengths.size() % 2u);
+    series.insert(series.end(), offsets_and_lengths.begin(),
+                  offsets_and_lengths.end());
+    return std::expected<void, std::string>();
+  }
+
+  std::expected<void, std::string> HandleCoefficientChunk(
+      std::span<const float> values) override {
+    num_chunks++;
+    coefficients.insert(coefficients.end(), values.begin(), values.end());
+    return std::expected<void, std::string>();
+  }
+
+  MOCK_METHOD((std::expected<void, std::string>), HandleElevationalSample,
+              (float), (override));
+  MOCK_METHOD((std::expected<void, std::string>), HandleSampleCount, (uint32_t),
+              (override));
+  MOCK_METHOD((std::expected<void, std::string>), HandleSamplePosition, (float),
+              (override));
+  MOCK_METHOD((std::expected<void, std::string>), HandleCdf, (float),
+              (override));
+  MOCK_METHOD((std::expected<void, std::string>), HandleSeries,
+              (uint32_t, uint32_t), (override));
+  MOCK_METHOD((std::expected<void, std::string>), HandleCoefficient, (float),
+              (override));
+
+  std::vector<float> elevational_samples;
+  std::vector<uint32_t> sample_counts;
+  std::vector<float> sample_positions;
+  std::vector<float> cdf;
+  std::vector<uint32_t> series;
+  std::vector<float> coefficients;
+  size_t num_chunks = 0;
+  size_t max_cdf_basis_functions = std::numeric_limits<size_t>::max();
+};
+
+TEST(BsdfReader, ParsesMinimalBsdfInChunks) {
+  ChunkedBsdfReader test_reader;
+  EXPECT_CALL(test_reader, HandleElevationalSample(_)).Times(0);
+  EXPECT_CALL(test_reader, HandleSampleCount(_)).Times(0);
+  EXPECT_CALL(test_reader, HandleSamplePosition(_)).Times(0);
+  EXPECT_CALL(test_reader, HandleCdf(_)).Times(0);
+  EXPECT_CALL(test_reader, HandleSeries(_, _)).Times(0);
+  EXPECT_CALL(test_reader, HandleCoefficient(_)).Times(0);
+
+  std::stringstream stream(MakeMinimalBsdfFile(1.0f, 1.0f, 1.0f));
+  EXPECT_TRUE(test_reader.ReadFrom(stream));
+  EXPECT_THAT(test_reader.elevational_samples, ElementsAre(1.0f));
+  EXPECT_THAT(test_reader.sample_counts, ElementsAre(1u));
+  EXPECT_THAT(test_reader.sample_positions, ElementsAre(1.0f));
+  EXPECT_THAT(test_reader.cdf, ElementsAre(0.0f));
+  EXPECT_THAT(test_reader.series, ElementsAre(0u, 1u));
+  EXPECT_THAT(test_reader.coefficients, ElementsAre(1.0f));
+  EXPECT_EQ(6u, test_reader.num_chunks);
+}
+
+TEST(BsdfReader, ParsesEmptyBsdfInChunks) {
+  ChunkedBsdfReader test_reader;
+  std::stringstream stream(MakeEmptyBsdfFile(1.0f, 1.0f, 1.0f));
+  EXPECT_TRUE(test_reader.ReadFrom(stream));
+  EXPECT_THAT(test_reader.elevational_samples, IsEmpty());
+  EXPECT_THAT(test_reader.coefficients, IsEmpty());
+  EXPECT_EQ(0u, test_reader.num_chunks);
+}
+
+TEST(BsdfReader, TestDataLoadsInChunks) {
+  for (const auto& [file_name, file_params] : kTestDataFiles) {
+    ChunkedBsdfReader test_reader;
+    EXPECT_TRUE(test_reader.ReadFrom(*OpenTestData(file_name)));
+    EXPECT_EQ(file_params.num_elevational_samples,
+              test_reader.elevational_samples.size());
+    EXPECT_EQ(file_params.num_parameters, test_reader.sample_counts.size());
+    EXPECT_EQ(file_params.num_parameter_values,
+              test_reader.sample_positions.size());
+    EXPECT_EQ(file_params.num_basis_functions *
+                  file_params.num_elevational_samples *
+                  file_params.num_elevational_samples,
+              test_reader.cdf.size());
+    EXPECT_EQ(2u * file_params.num_elevational_samples *
+                  file_params.num_elevational_samples,
+              test_reader.series.size());
+    EXPECT_EQ(file_params.num_coefficients, test_reader.coefficients.size());
+  }
+}
+
+std::vector<uint32_t> AlignedCopy(const std::string& bytes) {
+  std::vector<uint32_t> result((bytes.size() + sizeof(uint32_t) - 1) /
+                               sizeof(uint32_t));
+  std::memcpy(result.data(), bytes.data(), bytes.size());
+  return result;
+}
+
+TEST(BsdfReader, ParsesLimitedCdfBasisFunctions) {
+  BsdfData data(std::vector<float>({1.0f}), 3, 1);
+  data.AddCoefficient(0, 0, 0, 0, 1.0f);
+  data.AddCoefficient(1, 0, 0, 0, 2.0f);
+  data.AddCoefficient(2, 0, 0, 0, 3.0f);
+  data.SetCdf(0, 0, 0, 4.0f);
+  data.SetCdf(1, 0, 0, 5.0f);
+  data.SetCdf(2, 0, 0, 6.0f);
+
+  Flags flags{.is_bsdf = true, .uses_harmonic_extrapolation = false};
+  std::string file =
+      MakeBsdfFile(flags, data, {1}, {1.0f}, "meta", 1.0f, 1.0f, 1.0f);
+
+  for (size_t max_cdf_basis_functions : {0u, 1u, 2u, 3u, 4u}) {
+    ChunkedBsdfReader test_reader;
+    test_reader.max_cdf_basis_functions = max_cdf_basis_functions;
+
+    std::stringstream stream(file);
+    EXPECT_TRUE(test_reader.ReadFrom(stream));
+
+    std::vector<float> expected_cdf = {4.0f, 5.0f, 6.0f};
+    expected_cdf.resize(std::min<size_t>(max_cdf_basis_functions, 3u));
+    EXPECT_EQ(expected_cdf, test_reader.cdf);
+    EXPECT_THAT(test_reader.series, ElementsAre(0u, 1u));
+    EXPECT_THAT(test_reader.coefficients, ElementsAre(1.0f, 2.0f, 3.0f));
+
+    std::vector<uint32_t> aligned(AlignedCopy(file));
+    ChunkedBsdfReader memory_reader;
+    memory_reader.max_cdf_basis_functions = max_cdf_basis_functions;
+    EXPECT_TRUE(memory_reader.ReadFrom(
+        std::as_bytes(std::span(aligned)).first(file.size())));
+    EXPECT_EQ(expected_cdf, memory_reader.cdf);
+    EXPECT_THAT(memory_reader.coefficients, ElementsAre(1.0f, 2.0f, 3.0f));
+  }
+}
+
+// A stream buffer that counts the number of seeks performed on it
+class SeekCountingStreambuf : public std::stringbuf {
+ public:
+  explicit SeekCountingStreambuf(const std::string& contents)
+      : std::stringbuf(contents, std::ios::in | std::ios::binary) {}
+
+  size_t num_seeks = 0;
+
+ protected:
+  pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                   std::ios_base::openmode which) override {
+    num_seeks++;
+    return std::stringbuf::seekoff(off, dir, which);
+  }
+};
+
+TEST(BsdfReader, SkipsSectionsWithOneSeekEach) {
+  for (const auto& [file_name, file_params] : kTestDataFiles) {
+    std::unique_ptr<std::istream> stream = OpenTestData(file_name);
+    SeekCountingStreambuf streambuf(
+        std::string((std::istreambuf_iterator<char>(*stream)),
+                    std::istreambuf_iterator<char>()));
+    std::istream input(&streambuf);
+
+    std::array<bool, 7> parsed_parameters = {false, false, false, false,
+                                             false, false, true};
+    TestBsdfReader test_reader(file_params, parsed_parameters);
+    if (file_params.metadata_size_bytes != 0) {
+      EXPECT_CALL(test_reader, HandleMetadata(_))
+          .WillOnce(Return(std::expected<void, std::string>()));
+    }
+
+    EXPECT_TRUE(test_reader.ReadFrom(input));
+    EXPECT_GT(streambuf.num_seeks, 0u) << file_name;
+    EXPECT_LE(streambuf.num_seeks, 6u) << file_name;
+  }
+}
+
+TEST(BsdfReader, ParsesMinimalBsdfFromMemory) {
+  std::string file = MakeMinimalBsdfFile(1.0f, 1.0f, 1.0f);
+  std::vector<uint32_t> storage = AlignedCopy(file);
+  std::span<const std::byte> bytes =
+      std::as_bytes(std::span<const uint32_t>(storage)).first(file.size());
+
+  ChunkedBsdfReader test_reader;
+  EXPECT_TRUE(test_reader.ReadFrom(bytes));
+  EXPECT_THAT(test_reader.elevational_samples, ElementsAre(1.0f));
+  EXPECT_THAT(test_reader.sample_counts, ElementsAre(1u));
+  EXPECT_THAT(test_reader.sample_positions, ElementsAre(1.0f));
+  EXPECT_THAT(test_reader.cdf, ElementsAre(0.0f));
+  EXPECT_THAT(test_reader.series, ElementsAre(0u, 1u));
+  EXPECT_THAT(test_reader.coefficients, ElementsAre(1.0f));
+  EXPECT_EQ(6u, test_reader.num_chunks);
+}
+
+TEST(BsdfReader, ParsesMisalignedMinimalBsdfFromMemory) {
+  std::string file = MakeMinimalBsdfFile(1.0f, 1.0f, 1.0f);
+  std::vector<uint32_t> storage = AlignedCopy(" " + file);
+  std::span<const std::byte> bytes = std::as_bytes(
+      std::span<const uint32_t>(storage)).subspan(1u, file.size());
+
+  ChunkedBsdfReader test_reader;
+  EXPECT_TRUE(test_reader.ReadFrom(bytes));
+  EXPECT_THAT(test_reader.elevational_samples, ElementsAre(1.0f));
+  EXPECT_THAT(test_reader.cdf, ElementsAre(0.0f));
+  EXPECT_THAT(test_reader.series, ElementsAre(0u, 1u));
+  EXPECT_THAT(test_reader.coefficients, ElementsAre(1.0f));
+}
+
+TEST(BsdfReader, TruncatedMinimalBsdfFromMemoryFails) {
+  std::string file = MakeMinimalBsdfFile(1.0f, 1.0f, 1.0f);
+  std::vector<uint32_t> storage = AlignedCopy(file);
+
+  for (size_t i = 64; i < file.size() - 1; i++) {
+    ChunkedBsdfReader test_reader;
+    auto result = test_reader.ReadFrom(
+        std::as_bytes(std::span<const uint32_t>(storage)).first(i));
+    ASSERT_FALSE(result);
+    EXPECT_EQ("Unexpected EOF", result.error());
+  }
+}
+
+TEST(BsdfReader, NonFiniteBsdfFromMemoryFails) {
+  std::string file = MakeNonFiniteBsdfFile(1.0f, 1.0f, 1.0f);
+  std::vector<uint32_t> storage = AlignedCopy(file);
+
+  ChunkedBsdfReader test_reader;
+  auto result = test_reader.ReadFrom(
+      std::as_bytes(std::span<const uint32_t>(storage)).first(file.size()));
+  ASSERT_FALSE(result);
+  EXPECT_EQ("Input contained a non-finite floating point value",
+            result.error());
+}
+
+TEST(BsdfReader, TestDataLoadsFromMemory) {
+  for (const auto& [file_name, file_params] : kTestDataFiles) {
+    std::unique_ptr<std::istream> stream = OpenTestData(file_name);
+    std::string file((std::istreambuf_iterator<char>(*stream)),
+                     std::istreambuf_iterator<char>());
+    std::vector<uint32_t> storage = AlignedCopy(file);
+
+    ChunkedBsdfReader test_reader;
+    EXPECT_TRUE(test_reader.ReadFrom(
+        std::as_bytes(std::span<const uint32_t>(storage)).first(file.size())));
+    EXPECT_EQ(file_params.num_elevational_samples,
+              test_reader.elevational_samples.size());
+    EXPECT_EQ(file_params.num_basis_functions *
+                  file_params.num_elevational_samples *
+                  file_params.num_elevational_samples,
+              test_reader.cdf.size());
+    EXPECT_EQ(2u * file_params.num_elevational_samples *
+                  file_params.num_elevational_samples,
+              test_reader.series.size());
+    EXPECT_EQ(file_params.num_coefficients, test_reader.coefficients.size());
+  }
+}
+
 }  // namespace
 }  // namespace libfbsdf
@@ -0,0 +1,191 @@
+#include "libfbsdf/bsdf_section_index.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <ios>
+#include <istream>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "libfbsdf/bsdf_header_reader.h"
+#include "libfbsdf/float_decoding.h"
+
+namespace libfbsdf {
+namespace {
+
+std::string_view TooLarge() { return "Input is too large to be indexed"; }
+
+const char* UnexpectedEOF() { return "Unexpected EOF"; }
+
+// The maximum number of bytes of a section that are allocated before they are
+// read. This prevents a header that describes sections larger than the input
+// from allocating the full size of the sections up front.
+constexpr size_t kChunkSizeBytes = 65536u;
+
+// Appends a section of `num_elements` elements each `element_size` bytes in
+// size to the end of the sections ending at `offset`.
+std::expected<BsdfSection, std::string_view> NextSection(size_t& offset,
+                                                         size_t num_elements,
+                                                         size_t element_size) {
+  if (num_elements != 0 &&
+      element_size > std::numeric_limits<size_t>::max() / num_elements) {
+    return std::unexpected(TooLarge());
+  }
+
+  BsdfSection section{.offset = offset,
+                      .size_bytes = num_elements * element_size};
+  if (section.size_bytes > std::numeric_limits<size_t>::max() - offset) {
+    return std::unexpected(TooLarge());
+  }
+
+  offset += section.size_bytes;
+
+  return section;
+}
+
+template <typename Container>
+std::expected<void, std::string> ReadSectionValues(std::istream& input,
+                                                   const BsdfSection& section,
+                                                   Container& values) {
+  typedef typename Container::value_type T;
+
+  values.clear();
+  if (section.size_bytes % sizeof(T) != 0) {
+    return std::unexpected("The section does not contain whole values");
+  }
+
+  if (section.offset >
+          static_cast<size_t>(std::numeric_limits<std::streamoff>::max()) ||
+      !input.seekg(static_cast<std::streamoff>(section.offset))) {
+    return std::unexpected(UnexpectedEOF());
+  }
+
+  size_t num_values = section.size_bytes / sizeof(T);
+  while (values.size() < num_values) {
+    size_t num_read = values.size();
+    values.resize(
+        num_read + std::min(num_values - num_read, kChunkSizeBytes / sizeof(T)));
+    if (!input.read(reinterpret_cast<char*>(values.data() + num_read),
+                    (values.size() - num_read) * sizeof(T))) {
+      values.clear();
+      return std::unexpected(UnexpectedEOF());
+    }
+  }
+
+  return std::expected<void, std::string>();
+}
+
+}  // namespace
+
+std::expected<BsdfSectionIndex, std::string_view> ComputeBsdfSectionIndex(
+    const BsdfHeader& header) {
+  size_t num_elevational_samples_2d =
+      static_cast<size_t>(header.num_elevational_samples) *
+      static_cast<size_t>(header.num_elevational_samples);
+
+  BsdfSectionIndex index;
+  size_t offset = kBsdfHeaderSizeBytes;
+
+  auto elevational_samples =
+      NextSection(offset, header.num_elevational_samples, sizeof(float));
+  if (!elevational_samples) {
+    return std::unexpected(elevational_samples.error());
+  }
+  index.elevational_samples = *elevational_samples;
+
+  auto parameter_sample_counts =
+      NextSection(offset, header.num_parameters, sizeof(uint32_t));
+  if (!parameter_sample_counts) {
+    return std::unexpected(parameter_sample_counts.error());
+  }
+  index.parameter_sample_counts = *parameter_sample_counts;
+
+  auto parameter_values =
+      NextSection(offset, header.num_parameter_values, sizeof(float));
+  if (!parameter_values) {
+    return std::unexpected(parameter_values.error());
+  }
+  index.parameter_values = *parameter_values;
+
+  if (header.num_basis_functions != 0 &&
+      num_elevational_samples_2d >
+          std::numeric_limits<size_t>::max() / header.num_basis_functions) {
+    return std::unexpected(TooLarge());
+  }
+
+  auto cdf = NextSection(
+      offset, header.num_basis_functions * num_elevational_samples_2d,
+      sizeof(float));
+  if (!cdf) {
+    return std::unexpected(cdf.error());
+  }
+  index.cdf = *cdf;
+
+  auto series =
+      NextSection(offset, num_elevational_samples_2d, 2u * sizeof(uint32_t));
+  if (!series) {
+    return std::unexpected(series.error());
+  }
+  index.series = *series;
+
+  auto coefficients =
+      NextSection(offset, header.num_coefficients, sizeof(float));
+  if (!coefficients) {
+    return std::unexpected(coefficients.error());
+  }
+  index.coefficients = *coefficients;
+
+  auto metadata = NextSection(offset, header.num_metadata_bytes, sizeof(char));
+  if (!metadata) {
+    return std::unexpected(metadata.error());
+  }
+  index.metadata = *metadata;
+
+  index.total_size_bytes = offset;
+
+  return index;
+}
+
+std::expected<void, std::string> ReadBsdfSection(std::istream& input,
+                                                 const BsdfSection& section,
+                                                 std::vector<float>& values) {
+  if (auto result = ReadSectionValues(input, section, values); !result) {
+    return result;
+  }
+
+  if (!DecodeFloats(values)) {
+    values.clear();
+    return std::unexpected("Input contained a non-finite floating point value");
+  }
+
+  return std::expected<void, std::string>();
+}
+
+std::expected<void, std::string> ReadBsdfSection(
+    std::istream& input, const BsdfSection& section,
+    std::vector<uint32_t>& values) {
+  if (auto result = ReadSectionValues(input, section, values); !result) {
+    return result;
+  }
+
+  DecodeUint32s(values);
+
+  return std::expected<void, std::string>();
+}
+
+std::expected<void, std::string> ReadBsdfSection(std::istream& input,
+                                                 const BsdfSection& section,
+                                                 std::string& values) {
+  return ReadSectionValues(input, section, values);
+}
+
+// This allows us to assume that uint32_t -> size_t conversions are not lossy
+static_assert(std::numeric_limits<uint32_t>::max() <=
+              std::numeric_limits<size_t>::max());
+
+}  // namespace libfbsdf
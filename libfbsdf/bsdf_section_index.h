@@ -0,0 +1,71 @@
+#ifndef _LIBFBSDF_BSDF_SECTION_INDEX_
+#define _LIBFBSDF_BSDF_SECTION_INDEX_
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "libfbsdf/bsdf_header_reader.h"
+
+namespace libfbsdf {
+
+// The location of a section of a Fourier BSDF input
+struct BsdfSection final {
+  // The offset in bytes of the section from the start of the input
+  size_t offset;
+
+  // The size in bytes of the section
+  size_t size_bytes;
+
+  // The offset in bytes of the end of the section from the start of the input
+  size_t end() const { return offset + size_bytes; }
+};
+
+// The location of each section of a Fourier BSDF input. Since the size of every
+// section is fully determined by the header of an input, these can be computed
+// without reading any of the data following the header.
+struct BsdfSectionIndex final {
+  BsdfSection elevational_samples;
+  BsdfSection parameter_sample_counts;
+  BsdfSection parameter_values;
+  BsdfSection cdf;
+  BsdfSection series;
+  BsdfSection coefficients;
+  BsdfSection metadata;
+
+  // The minimum size in bytes of an input containing all of the sections
+  size_t total_size_bytes;
+};
+
+// Computes the location of each section of an input from its header. Returns
+// an error if the sections described by the header cannot be addressed on this
+// host.
+std::expected<BsdfSectionIndex, std::string_view> ComputeBsdfSectionIndex(
+    const BsdfHeader& header);
+
+// Reads a single section of `input` located by `ComputeBsdfSectionIndex` into
+// `values`, replacing its contents. The section is read directly from its
+// offset relative to the start of `input` without parsing any of the sections
+// before it. The overload used must match the type of the section: `uint32_t`
+// for the parameter sample counts and series table, `char` for the metadata,
+// and `float` for every other section. Floating point values are decoded and
+// checked in the same way as by `BsdfReader`.
+//
+// NOTE: Behavior is undefined if `input` is not a seekable binary stream
+std::expected<void, std::string> ReadBsdfSection(std::istream& input,
+                                                 const BsdfSection& section,
+                                                 std::vector<float>& values);
+std::expected<void, std::string> ReadBsdfSection(
+    std::istream& input, const BsdfSection& section,
+    std::vector<uint32_t>& values);
+std::expected<void, std::string> ReadBsdfSection(std::istream& input,
+                                                 const BsdfSection& section,
+                                                 std::string& values);
+
+}  // namespace libfbsdf
+
+#endif  // _LIBFBSDF_BSDF_SECTION_INDEX_
@@ -0,0 +1,197 @@
+#include "libfbsdf/bsdf_section_index.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "googletest/include/gtest/gtest.h"
+#include "libfbsdf/bsdf_header_reader.h"
+#include "libfbsdf/bsdf_view.h"
+#include "libfbsdf/test_bsdf_writer.h"
+#include "test_data/test_data.h"
+
+namespace libfbsdf {
+namespace {
+
+using ::libfbsdf::testing::kTestDataFiles;
+using ::libfbsdf::testing::MakeEmptyBsdfFile;
+using ::libfbsdf::testing::MakeMinimalBsdfFile;
+using ::libfbsdf::testing::MakeNonFiniteBsdfFile;
+using ::libfbsdf::testing::OpenTestData;
+
+TEST(BsdfSectionIndex, Empty) {
+  std::stringstream stream(MakeEmptyBsdfFile(1.0f, 1.0f, 1.0f));
+  auto index = ComputeBsdfSectionIndex(ReadBsdfHeader(stream).value());
+  ASSERT_TRUE(index);
+
+  for (const BsdfSection& section :
+       {index->elevational_samples, index->parameter_sample_counts,
+        index->parameter_values, index->cdf, index->series,
+        index->coefficients, index->metadata}) {
+    EXPECT_EQ(kBsdfHeaderSizeBytes, section.offset);
+    EXPECT_EQ(0u, section.size_bytes);
+  }
+
+  EXPECT_EQ(kBsdfHeaderSizeBytes, index->total_size_bytes);
+}
+
+TEST(BsdfSectionIndex, Minimal) {
+  std::string file = MakeMinimalBsdfFile(1.0f, 1.0f, 1.0f);
+  std::stringstream stream(file);
+  auto index = ComputeBsdfSectionIndex(ReadBsdfHeader(stream).value());
+  ASSERT_TRUE(index);
+
+  EXPECT_EQ(64u, index->elevational_samples.offset);
+  EXPECT_EQ(4u, index->elevational_samples.size_bytes);
+  EXPECT_EQ(68u, index->parameter_sample_counts.offset);
+  EXPECT_EQ(4u, index->parameter_sample_counts.size_bytes);
+  EXPECT_EQ(72u, index->parameter_values.offset);
+  EXPECT_EQ(4u, index->parameter_values.size_bytes);
+  EXPECT_EQ(76u, index->cdf.offset);
+  EXPECT_EQ(4u, index->cdf.size_bytes);
+  EXPECT_EQ(80u, index->series.offset);
+  EXPECT_EQ(8u, index->series.size_bytes);
+  EXPECT_EQ(88u, index->coefficients.offset);
+  EXPECT_EQ(4u, index->coefficients.size_bytes);
+  EXPECT_EQ(92u, index->metadata.offset);
+  EXPECT_EQ(4u, index->metadata.size_bytes);
+  EXPECT_EQ(file.size(), index->total_size_bytes);
+
+  // Sections can be read directly without parsing the sections before them
+  stream.seekg(index->metadata.offset);
+  std::string metadata(index->metadata.size_bytes, '\0');
+  ASSERT_TRUE(stream.read(metadata.data(), metadata.size()));
+  EXPECT_EQ("meta", metadata);
+}
+
+TEST(BsdfSectionIndex, TooLarge) {
+  std::stringstream stream(MakeEmptyBsdfFile(1.0f, 1.0f, 1.0f));
+  BsdfHeader header = ReadBsdfHeader(stream).value();
+  header.num_elevational_samples = std::numeric_limits<uint32_t>::max();
+  header.num_basis_functions = std::numeric_limits<uint32_t>::max();
+
+  auto index = ComputeBsdfSectionIndex(header);
+  ASSERT_FALSE(index);
+  EXPECT_EQ("Input is too large to be indexed", index.error());
+}
+
+TEST(BsdfSectionIndex, TestData) {
+  for (const auto& [file_name, file_params] : kTestDataFiles) {
+    std::unique_ptr<std::istream> stream = OpenTestData(file_name);
+    auto index = ComputeBsdfSectionIndex(ReadBsdfHeader(*stream).value());
+    ASSERT_TRUE(index);
+
+    stream->seekg(0);
+    std::string file((std::istreambuf_iterator<char>(*stream)),
+                     std::istreambuf_iterator<char>());
+    EXPECT_EQ(file.size(), index->total_size_bytes) << file_name;
+    EXPECT_EQ(4u * file_params.num_coefficients,
+              index->coefficients.size_bytes);
+    EXPECT_EQ(file_params.metadata_size_bytes, index->metadata.size_bytes);
+  }
+}
+
+template <typename T>
+std::vector<T> ReadSection(std::istream& input, const BsdfSection& section) {
+  std::vector<T> values;
+  auto result = ReadBsdfSection(input, section, values);
+  EXPECT_TRUE(result) << result.error();
+  return values;
+}
+
+template <typename T>
+std::vector<T> ToVector(std::span<const T> values) {
+  return std::vector<T>(values.begin(), values.end());
+}
+
+TEST(BsdfSectionIndex, ReadSectionsMatchView) {
+  for (const auto& [file_name, file_params] : kTestDataFiles) {
+    SCOPED_TRACE(file_name);
+    std::unique_ptr<std::istream> stream = OpenTestData(file_name);
+    std::string file((std::istreambuf_iterator<char>(*stream)),
+                     std::istreambuf_iterator<char>());
+
+    std::vector<uint32_t> storage((file.size() + sizeof(uint32_t) - 1) /
+                                  sizeof(uint32_t));
+    std::memcpy(storage.data(), file.data(), file.size());
+    auto view = ViewBsdf(
+        std::as_bytes(std::span<const uint32_t>(storage)).first(file.size()));
+    ASSERT_TRUE(view) << view.error();
+
+    auto index = ComputeBsdfSectionIndex(view->header);
+    ASSERT_TRUE(index);
+
+    // Sections are read out of order to show that each is read independently
+    std::stringstream input(file);
+    EXPECT_EQ(ToVector(view->series),
+              ReadSection<uint32_t>(input, index->series));
+    EXPECT_EQ(ToVector(view->cdf), ReadSection<float>(input, index->cdf));
+    EXPECT_EQ(ToVector(view->elevational_samples),
+              ReadSection<float>(input, index->elevational_samples));
+    EXPECT_EQ(ToVector(view->parameter_sample_counts),
+              ReadSection<uint32_t>(input, index->parameter_sample_counts));
+    EXPECT_EQ(ToVector(view->parameter_values),
+              ReadSection<float>(input, index->parameter_values));
+
+    std::string metadata;
+    auto result = ReadBsdfSection(input, index->metadata, metadata);
+    ASSERT_TRUE(result) << result.error();
+    EXPECT_EQ(view->metadata, metadata);
+  }
+}
+
+TEST(BsdfSectionIndex, ReadSectionNonFinite) {
+  std::stringstream stream(MakeNonFiniteBsdfFile(1.0f, 1.0f, 1.0f));
+  auto index = ComputeBsdfSectionIndex(ReadBsdfHeader(stream).value());
+  ASSERT_TRUE(index);
+
+  std::vector<float> values = {1.0f};
+  auto result = ReadBsdfSection(stream, index->elevational_samples, values);
+  ASSERT_FALSE(result);
+  EXPECT_EQ("Input contained a non-finite floating point value",
+            result.error());
+  EXPECT_TRUE(values.empty());
+}
+
+TEST(BsdfSectionIndex, ReadSectionTruncated) {
+  std::string file = MakeMinimalBsdfFile(1.0f, 1.0f, 1.0f);
+  std::stringstream stream(file);
+  auto index = ComputeBsdfSectionIndex(ReadBsdfHeader(stream).value());
+  ASSERT_TRUE(index);
+
+  std::stringstream truncated(file.substr(0, file.size() - 1u));
+  std::string metadata;
+  auto result = ReadBsdfSection(truncated, index->metadata, metadata);
+  ASSERT_FALSE(result);
+  EXPECT_EQ("Unexpected EOF", result.error());
+
+  // Sections located past the end of the input are never allocated in full
+  BsdfSection huge{.offset = index->coefficients.offset,
+                   .size_bytes = std::numeric_limits<size_t>::max() / 8u * 4u};
+  std::vector<float> values;
+  truncated.clear();
+  result = ReadBsdfSection(truncated, huge, values);
+  ASSERT_FALSE(result);
+  EXPECT_EQ("Unexpected EOF", result.error());
+}
+
+TEST(BsdfSectionIndex, ReadSectionPartialValue) {
+  std::stringstream stream(MakeMinimalBsdfFile(1.0f, 1.0f, 1.0f));
+  std::vector<uint32_t> values;
+  auto result = ReadBsdfSection(
+      stream, BsdfSection{.offset = kBsdfHeaderSizeBytes, .size_bytes = 6u},
+      values);
+  ASSERT_FALSE(result);
+  EXPECT_EQ("The section does not contain whole values", result.error());
+}
+
+}  // namespace
+}  // namespace libfbsdf
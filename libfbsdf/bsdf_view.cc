@@ -0,0 +1,88 @@
+#include "libfbsdf/bsdf_view.h"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "libfbsdf/bsdf_header_reader.h"
+#include "libfbsdf/bsdf_section_index.h"
+#include "libfbsdf/float_decoding.h"
+
+namespace libfbsdf {
+namespace {
+
+std::string UnexpectedEOF() { return "Unexpected EOF"; }
+
+template <typename T>
+std::span<const T> ViewSection(std::span<const std::byte> input,
+                               const BsdfSection& section) {
+  return std::span<const T>(
+      reinterpret_cast<const T*>(input.data() + section.offset),
+      section.size_bytes / sizeof(T));
+}
+
+std::expected<void, std::string> ValidateFloats(
+    std::span<const float> values) {
+  if (!AllFinite(values)) {
+    return std::unexpected("Input contained a non-finite floating point value");
+  }
+
+  return std::expected<void, std::string>();
+}
+
+}  // namespace
+
+std::expected<BsdfView, std::string> ViewBsdf(
+    std::span<const std::byte> input) {
+  if constexpr (std::endian::native != std::endian::little) {
+    return std::unexpected("Views are only supported on little-endian hosts");
+  }
+
+  if (reinterpret_cast<uintptr_t>(input.data()) % alignof(float) != 0) {
+    return std::unexpected("The input is not aligned to a 4 byte boundary");
+  }
+
+  auto header = ReadBsdfHeader(input);
+  if (!header) {
+    return std::unexpected(std::string(header.error()));
+  }
+
+  auto index = ComputeBsdfSectionIndex(*header);
+  if (!index) {
+    return std::unexpected(std::string(index.error()));
+  }
+
+  if (input.size() < index->total_size_bytes) {
+    return std::unexpected(UnexpectedEOF());
+  }
+
+  BsdfView view;
+  view.header = *header;
+  view.elevational_samples =
+      ViewSection<float>(input, index->elevational_samples);
+  view.parameter_sample_counts =
+      ViewSection<uint32_t>(input, index->parameter_sample_counts);
+  view.parameter_values = ViewSection<float>(input, index->parameter_values);
+  view.cdf = ViewSection<float>(input, index->cdf);
+  view.series = ViewSection<uint32_t>(input, index->series);
+  view.coefficients = ViewSection<float>(input, index->coefficients);
+  view.metadata = std::string_view(
+      reinterpret_cast<const char*>(input.data() + index->metadata.offset),
+      index->metadata.size_bytes);
+
+  for (std::span<const float> values :
+       {view.elevational_samples, view.parameter_values, view.cdf,
+        view.coefficients}) {
+    if (auto result = ValidateFloats(values); !result) {
+      return std::unexpected(result.error());
+    }
+  }
+
+  return view;
+}
+
+}  // namespace libfbsdf
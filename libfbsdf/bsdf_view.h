@@ -0,0 +1,58 @@
+#ifndef _LIBFBSDF_BSDF_VIEW_
+#define _LIBFBSDF_BSDF_VIEW_
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "libfbsdf/bsdf_header_reader.h"
+
+namespace libfbsdf {
+
+// A view of the contents of a Fourier BSDF input that is stored in memory. Each
+// field refers directly into the memory backing the input and is only valid for
+// as long as that memory is.
+struct BsdfView final {
+  // The header of the input
+  BsdfHeader header;
+
+  // The elevational samples in one dimension
+  std::span<const float> elevational_samples;
+
+  // The number of samples of each textured material parameter
+  std::span<const uint32_t> parameter_sample_counts;
+
+  // The sample positions of each textured material parameter
+  std::span<const float> parameter_values;
+
+  // The two dimensional CDF for each basis function stored one after another
+  std::span<const float> cdf;
+
+  // The two dimensional extents of each Fourier series. Offsets and lengths are
+  // interleaved such that even indices contain offsets into `coefficients` and
+  // odd indices contain lengths.
+  std::span<const uint32_t> series;
+
+  // The Fourier coefficients stored in the input
+  std::span<const float> coefficients;
+
+  // The metadata stored in the input
+  std::string_view metadata;
+};
+
+// Creates a view of a Fourier BSDF input that is stored in memory (typically a
+// `MappedFile`) without copying any of its contents. Like `BsdfReader`, this
+// function ensures that the input is long enough to contain all of the data
+// described by its header and that all of its floating point values are finite.
+//
+// NOTE: Views can only be created on little-endian hosts and `input` must be
+//       aligned to a 4 byte boundary. Clients on other hosts should instead use
+//       `BsdfReader::ReadFrom`.
+std::expected<BsdfView, std::string> ViewBsdf(std::span<const std::byte> input);
+
+}  // namespace libfbsdf
+
+#endif  // _LIBFBSDF_BSDF_VIEW_
@@ -0,0 +1,178 @@
+#include "libfbsdf/bsdf_view.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "googlemock/include/gmock/gmock.h"
+#include "googletest/include/gtest/gtest.h"
+#include "libfbsdf/mapped_file.h"
+#include "libfbsdf/test_bsdf_writer.h"
+#include "test_data/test_data.h"
+
+namespace libfbsdf {
+namespace {
+
+using ::libfbsdf::testing::kTestDataFiles;
+using ::libfbsdf::testing::MakeEmptyBsdfFile;
+using ::libfbsdf::testing::MakeMinimalBsdfFile;
+using ::libfbsdf::testing::MakeNonFiniteBsdfFile;
+using ::libfbsdf::testing::OpenTestData;
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+// Copies `bytes` into storage that is aligned to a 4 byte boundary
+std::vector<uint32_t> AlignedCopy(const std::string& bytes) {
+  std::vector<uint32_t> result((bytes.size() + sizeof(uint32_t) - 1) /
+                               sizeof(uint32_t));
+  std::memcpy(result.data(), bytes.data(), bytes.size());
+  return result;
+}
+
+std::span<const std::byte> AsBytes(const std::vector<uint32_t>& storage,
+                                   size_t size) {
+  return std::as_bytes(std::span<const uint32_t>(storage)).first(size);
+}
+
+TEST(BsdfView, Empty) {
+  std::string file = MakeEmptyBsdfFile(1.0f, 2.0f, 3.0f);
+  std::vector<uint32_t> storage = AlignedCopy(file);
+
+  auto view = ViewBsdf(AsBytes(storage, file.size()));
+  ASSERT_TRUE(view);
+  EXPECT_EQ(1.0f, view->header.index_of_refraction);
+  EXPECT_EQ(2.0f, view->header.roughness[0]);
+  EXPECT_EQ(3.0f, view->header.roughness[1]);
+  EXPECT_THAT(view->elevational_samples, IsEmpty());
+  EXPECT_THAT(view->parameter_sample_counts, IsEmpty());
+  EXPECT_THAT(view->parameter_values, IsEmpty());
+  EXPECT_THAT(view->cdf, IsEmpty());
+  EXPECT_THAT(view->series, IsEmpty());
+  EXPECT_THAT(view->coefficients, IsEmpty());
+  EXPECT_TRUE(view->metadata.empty());
+}
+
+TEST(BsdfView, Minimal) {
+  std::string file = MakeMinimalBsdfFile(1.0f, 1.0f, 1.0f);
+  std::vector<uint32_t> storage = AlignedCopy(file);
+  std::span<const std::byte> bytes = AsBytes(storage, file.size());
+
+  auto view = ViewBsdf(bytes);
+  ASSERT_TRUE(view);
+  EXPECT_THAT(view->elevational_samples, ElementsAre(1.0f));
+  EXPECT_THAT(view->parameter_sample_counts, ElementsAre(1u));
+  EXPECT_THAT(view->parameter_values, ElementsAre(1.0f));
+  EXPECT_THAT(view->cdf, ElementsAre(0.0f));
+  EXPECT_THAT(view->series, ElementsAre(0u, 1u));
+  EXPECT_THAT(view->coefficients, ElementsAre(1.0f));
+  EXPECT_EQ("meta", view->metadata);
+
+  // The view must refer directly into the input
+  EXPECT_EQ(reinterpret_cast<const std::byte*>(view->coefficients.data()),
+            bytes.data() + file.size() - 8u);
+}
+
+TEST(BsdfView, Truncated) {
+  std::string file = MakeMinimalBsdfFile(1.0f, 1.0f, 1.0f);
+  std::vector<uint32_t> storage = AlignedCopy(file);
+
+  for (size_t i = 0; i < file.size(); i++) {
+    auto view = ViewBsdf(AsBytes(storage, i));
+    ASSERT_FALSE(view);
+    if (i >= kBsdfHeaderSizeBytes) {
+      EXPECT_EQ("Unexpected EOF", view.error());
+    }
+  }
+}
+
+TEST(BsdfView, NonFinite) {
+  std::string file = MakeNonFiniteBsdfFile(1.0f, 1.0f, 1.0f);
+  std::vector<uint32_t> storage = AlignedCopy(file);
+
+  auto view = ViewBsdf(AsBytes(storage, file.size()));
+  ASSERT_FALSE(view);
+  EXPECT_EQ("Input contained a non-finite floating point value", view.error());
+}
+
+TEST(BsdfView, Misaligned) {
+  std::string file = MakeMinimalBsdfFile(1.0f, 1.0f, 1.0f);
+  std::vector<uint32_t> storage = AlignedCopy(" " + file);
+
+  auto view = ViewBsdf(AsBytes(storage, file.size() + 1u).subspan(1u));
+  ASSERT_FALSE(view);
+  EXPECT_EQ("The input is not aligned to a 4 byte boundary", view.error());
+}
+
+TEST(BsdfView, TestDataLoads) {
+  for (const auto& [file_name, file_params] : kTestDataFiles) {
+    std::unique_ptr<std::istream> stream = OpenTestData(file_name);
+    std::string file((std::istreambuf_iterator<char>(*stream)),
+                     std::istreambuf_iterator<char>());
+    std::vector<uint32_t> storage = AlignedCopy(file);
+
+    auto view = ViewBsdf(AsBytes(storage, file.size()));
+    ASSERT_TRUE(view) << file_name;
+    EXPECT_EQ(file_params.num_elevational_samples,
+              view->elevational_samples.size());
+    EXPECT_EQ(file_params.num_parameters,
+              view->parameter_sample_counts.size());
+    EXPECT_EQ(file_params.num_parameter_values,
+              view->parameter_values.size());
+    EXPECT_EQ(file_params.num_basis_functions *
+                  file_params.num_elevational_samples *
+                  file_params.num_elevational_samples,
+              view->cdf.size());
+    EXPECT_EQ(2u * file_params.num_elevational_samples *
+                  file_params.num_elevational_samples,
+              view->series.size());
+    EXPECT_EQ(file_params.num_coefficients, view->coefficients.size());
+    EXPECT_EQ(file_params.metadata_size_bytes, view->metadata.size());
+  }
+}
+
+TEST(MappedFile, MissingFile) {
+  auto file = MappedFile::Open("notarealfile.bsdf");
+  ASSERT_FALSE(file);
+  EXPECT_EQ("Failed to open file", file.error());
+}
+
+TEST(MappedFile, ViewsMappedFile) {
+  std::filesystem::path path =
+      std::filesystem::temp_directory_path() / "bsdf_view_test.bsdf";
+  std::string contents = MakeMinimalBsdfFile(1.0f, 1.0f, 1.0f);
+  std::ofstream(path, std::ios::out | std::ios::binary) << contents;
+
+  auto file = MappedFile::Open(path);
+  ASSERT_TRUE(file);
+  EXPECT_EQ(contents.size(), file->bytes().size());
+
+  auto view = ViewBsdf(file->bytes());
+  ASSERT_TRUE(view);
+  EXPECT_THAT(view->coefficients, ElementsAre(1.0f));
+  EXPECT_EQ("meta", view->metadata);
+
+  std::filesystem::remove(path);
+}
+
+TEST(MappedFile, EmptyFile) {
+  std::filesystem::path path =
+      std::filesystem::temp_directory_path() / "bsdf_view_test_empty.bsdf";
+  std::ofstream(path, std::ios::out | std::ios::binary);
+
+  auto file = MappedFile::Open(path);
+  ASSERT_TRUE(file);
+  EXPECT_TRUE(file->bytes().empty());
+
+  std::filesystem::remove(path);
+}
+
+}  // namespace
+}  // namespace libfbsdf
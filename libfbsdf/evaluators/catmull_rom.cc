@@ -0,0 +1,132 @@
+#include "libfbsdf/evaluators/catmull_rom.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <span>
+
+#include "libfbsdf/readers/elevational_guide.h"
+
+namespace libfbsdf {
+namespace {
+
+// Computes the weights for the interval starting at node `index` of
+// `num_nodes` at `t` in [0, 1]. `lower_scale` and `upper_scale` are the widths
+// of the interval divided by the distances spanned by the central differences
+// estimating the derivatives at its lower and upper ends, and are unused for
+// the first and last intervals respectively.
+CatmullRomWeights ComputeWeightsInInterval(size_t index, size_t num_nodes,
+                                           float t, float lower_scale,
+                                           float upper_scale) {
+  float t2 = t * t;
+  float t3 = t2 * t;
+
+  CatmullRomWeights result;
+  result.offset = index - 1;
+  result.weights[1] = 2.0f * t3 - 3.0f * t2 + 1.0f;
+  result.weights[2] = -2.0f * t3 + 3.0f * t2;
+
+  if (index > 0) {
+    float w0 = (t3 - 2.0f * t2 + t) * lower_scale;
+    result.weights[0] = -w0;
+    result.weights[2] += w0;
+  } else {
+    float w0 = t3 - 2.0f * t2 + t;
+    result.weights[0] = 0.0f;
+    result.weights[1] -= w0;
+    result.weights[2] += w0;
+  }
+
+  if (index + 2 < num_nodes) {
+    float w3 = (t3 - t2) * upper_scale;
+    result.weights[1] -= w3;
+    result.weights[3] = w3;
+  } else {
+    float w3 = t3 - t2;
+    result.weights[1] -= w3;
+    result.weights[2] += w3;
+    result.weights[3] = 0.0f;
+  }
+
+  return result;
+}
+
+size_t SearchInterval(std::span<const float> nodes, float x) {
+  size_t index =
+      std::upper_bound(nodes.begin(), nodes.end(), x) - nodes.begin();
+  return std::min(index - 1, nodes.size() - 2);
+}
+
+}  // namespace
+
+std::optional<CatmullRomWeights> ComputeCatmullRomWeights(
+    std::span<const float> nodes, float x) {
+  if (nodes.size() < 2 || !(x >= nodes.front() && x <= nodes.back())) {
+    return std::nullopt;
+  }
+
+  size_t index = SearchInterval(nodes, x);
+  float x0 = nodes[index];
+  float x1 = nodes[index + 1];
+
+  float lower_scale = 0.0f;
+  if (index > 0) {
+    lower_scale = (x1 - x0) / (x1 - nodes[index - 1]);
+  }
+
+  float upper_scale = 0.0f;
+  if (index + 2 < nodes.size()) {
+    upper_scale = (x1 - x0) / (nodes[index + 2] - x0);
+  }
+
+  return ComputeWeightsInInterval(index, nodes.size(), (x - x0) / (x1 - x0),
+                                  lower_scale, upper_scale);
+}
+
+CatmullRomWeightTable::CatmullRomWeightTable(std::span<const float> nodes,
+                                             const ElevationalGuide& guide)
+    : nodes_(nodes), guide_(guide) {
+  if (nodes.size() < 2) {
+    return;
+  }
+
+  intervals_.reserve(nodes.size() - 1);
+  for (size_t index = 0; index + 1 < nodes.size(); index++) {
+    float x0 = nodes[index];
+    float x1 = nodes[index + 1];
+
+    // Zero width intervals only occur between duplicated nodes and are never
+    // returned by the interval search
+    Interval interval{0.0f, 0.0f, 0.0f};
+    if (x1 > x0) {
+      interval.inverse_width = 1.0f / (x1 - x0);
+    }
+
+    if (index > 0) {
+      interval.lower_scale = (x1 - x0) / (x1 - nodes[index - 1]);
+    }
+
+    if (index + 2 < nodes.size()) {
+      interval.upper_scale = (x1 - x0) / (nodes[index + 2] - x0);
+    }
+
+    intervals_.push_back(interval);
+  }
+}
+
+std::optional<CatmullRomWeights> CatmullRomWeightTable::ComputeWeights(
+    float x) const {
+  if (nodes_.size() < 2 || !(x >= nodes_.front() && x <= nodes_.back())) {
+    return std::nullopt;
+  }
+
+  size_t index = guide_.intervals.empty()
+                     ? SearchInterval(nodes_, x)
+                     : FindElevationalInterval(nodes_, guide_, x);
+  const Interval& interval = intervals_[index];
+  return ComputeWeightsInInterval(index, nodes_.size(),
+                                  (x - nodes_[index]) * interval.inverse_width,
+                                  interval.lower_scale, interval.upper_scale);
+}
+
+}  // namespace libfbsdf
@@ -0,0 +1,60 @@
+#ifndef _LIBFBSDF_EVALUATORS_CATMULL_ROM_
+#define _LIBFBSDF_EVALUATORS_CATMULL_ROM_
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "libfbsdf/readers/elevational_guide.h"
+
+namespace libfbsdf {
+
+// The weights of the four consecutive nodes starting at `offset` that
+// interpolate a value with a Catmull-Rom spline. In the first interval of the
+// spline, `offset` refers to the (non-existent) node before the first node and
+// wraps around; however, the weight of that node is always zero. Likewise, the
+// weight of the node after the last node is always zero.
+struct CatmullRomWeights {
+  size_t offset;
+  float weights[4];
+};
+
+// Computes the Catmull-Rom weights that interpolate a value at `x` from values
+// at the sorted positions `nodes`. The derivatives at interior nodes are
+// estimated with central differences and those at the end nodes with one sided
+// differences. Returns `std::nullopt` if `x` is outside of the range of
+// `nodes` or if there are fewer than two nodes.
+std::optional<CatmullRomWeights> ComputeCatmullRomWeights(
+    std::span<const float> nodes, float x);
+
+// Precomputes the terms of `ComputeCatmullRomWeights` that depend only on the
+// nodes, the reciprocal of the width of each interval and the scale factors of
+// the derivative estimates at either end of it, so that computing weights does
+// not divide. Intervals are located using `guide` unless it is empty, in which
+// case a binary search is used instead.
+//
+// NOTE: The table refers to `nodes` and `guide` which must outlive it
+class CatmullRomWeightTable final {
+ public:
+  CatmullRomWeightTable(std::span<const float> nodes,
+                        const ElevationalGuide& guide);
+
+  // Equivalent to `ComputeCatmullRomWeights(nodes, x)` up to rounding
+  std::optional<CatmullRomWeights> ComputeWeights(float x) const;
+
+ private:
+  struct Interval {
+    float inverse_width;
+    float lower_scale;
+    float upper_scale;
+  };
+
+  std::span<const float> nodes_;
+  const ElevationalGuide& guide_;
+  std::vector<Interval> intervals_;
+};
+
+}  // namespace libfbsdf
+
+#endif  // _LIBFBSDF_EVALUATORS_CATMULL_ROM_
@@ -0,0 +1,111 @@
+#include "libfbsdf/evaluators/catmull_rom.h"
+
+#include <cmath>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include "googletest/include/gtest/gtest.h"
+#include "libfbsdf/readers/elevational_guide.h"
+
+namespace libfbsdf {
+namespace {
+
+TEST(CatmullRomWeights, OutOfRange) {
+  std::vector<float> nodes = {-1.0f, 0.0f, 1.0f};
+  EXPECT_FALSE(ComputeCatmullRomWeights(nodes, -1.5f));
+  EXPECT_FALSE(ComputeCatmullRomWeights(nodes, 1.5f));
+  EXPECT_FALSE(ComputeCatmullRomWeights(nodes, NAN));
+  EXPECT_FALSE(ComputeCatmullRomWeights(std::vector<float>({0.0f}), 0.0f));
+}
+
+TEST(CatmullRomWeights, AtNodes) {
+  std::vector<float> nodes = {-1.0f, -0.5f, 0.25f, 1.0f};
+  for (size_t i = 0; i < nodes.size(); i++) {
+    std::optional<CatmullRomWeights> weights =
+        ComputeCatmullRomWeights(nodes, nodes[i]);
+    ASSERT_TRUE(weights);
+
+    float total = 0.0f;
+    for (size_t j = 0; j < 4; j++) {
+      size_t node = weights->offset + j;
+      if (node == i) {
+        EXPECT_FLOAT_EQ(1.0f, weights->weights[j]);
+      } else {
+        EXPECT_FLOAT_EQ(0.0f, weights->weights[j]);
+      }
+      total += weights->weights[j];
+    }
+
+    EXPECT_FLOAT_EQ(1.0f, total);
+  }
+}
+
+TEST(CatmullRomWeights, ReproducesLinearFunctions) {
+  std::vector<float> nodes = {-1.0f, -0.9f, -0.5f, 0.0f, 0.7f, 1.0f};
+  for (float x = -1.0f; x <= 1.0f; x += 0.05f) {
+    std::optional<CatmullRomWeights> weights =
+        ComputeCatmullRomWeights(nodes, x);
+    ASSERT_TRUE(weights);
+
+    float value = 0.0f;
+    for (size_t j = 0; j < 4; j++) {
+      if (weights->weights[j] != 0.0f) {
+        value += weights->weights[j] * (3.0f * nodes[weights->offset + j] + 1);
+      }
+    }
+
+    EXPECT_NEAR(3.0f * x + 1.0f, value, 1e-5f);
+  }
+}
+
+TEST(CatmullRomWeights, OuterWeightsAreZeroAtBoundaries) {
+  std::vector<float> nodes = {-1.0f, 0.0f, 1.0f};
+
+  std::optional<CatmullRomWeights> weights =
+      ComputeCatmullRomWeights(nodes, -0.5f);
+  ASSERT_TRUE(weights);
+  EXPECT_EQ(0.0f, weights->weights[0]);
+  EXPECT_EQ(0u, weights->offset + 1);
+
+  weights = ComputeCatmullRomWeights(nodes, 0.5f);
+  ASSERT_TRUE(weights);
+  EXPECT_EQ(0.0f, weights->weights[3]);
+  EXPECT_EQ(0u, weights->offset);
+}
+
+TEST(CatmullRomWeightTable, MatchesComputeCatmullRomWeights) {
+  std::vector<float> nodes = {-1.0f, -0.9f, -0.5f, 0.0f, 0.0f, 0.7f, 1.0f};
+  ElevationalGuide empty_guide;
+  ElevationalGuide guide = BuildElevationalGuide(nodes);
+
+  for (const ElevationalGuide* table_guide : {&empty_guide, &guide}) {
+    CatmullRomWeightTable table(nodes, *table_guide);
+    EXPECT_FALSE(table.ComputeWeights(-1.5f));
+    EXPECT_FALSE(table.ComputeWeights(1.5f));
+    EXPECT_FALSE(table.ComputeWeights(NAN));
+
+    for (float x = -1.0f; x <= 1.0f; x += 0.01f) {
+      std::optional<CatmullRomWeights> expected =
+          ComputeCatmullRomWeights(nodes, x);
+      std::optional<CatmullRomWeights> actual = table.ComputeWeights(x);
+      ASSERT_TRUE(expected);
+      ASSERT_TRUE(actual);
+      EXPECT_EQ(expected->offset, actual->offset);
+      for (size_t j = 0; j < 4; j++) {
+        EXPECT_NEAR(expected->weights[j], actual->weights[j], 1e-5f);
+      }
+    }
+
+    for (float x : nodes) {
+      std::optional<CatmullRomWeights> expected =
+          ComputeCatmullRomWeights(nodes, x);
+      std::optional<CatmullRomWeights> actual = table.ComputeWeights(x);
+      ASSERT_TRUE(actual);
+      EXPECT_EQ(expected->offset, actual->offset);
+    }
+  }
+}
+
+}  // namespace
+}  // namespace libfbsdf
@@ -0,0 +1,65 @@
+#include "libfbsdf/evaluators/fourier_bsdf_evaluator.h"
+
+#include <cmath>
+#include <cstddef>
+#include <expected>
+#include <optional>
+#include <span>
+#include <string>
+
+#include "libfbsdf/evaluators/catmull_rom.h"
+#include "libfbsdf/evaluators/fourier_series.h"
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+
+namespace libfbsdf {
+
+FourierBsdfEvaluator::Value FourierBsdfEvaluator::Evaluate(float mu_in,
+                                                           float mu_out,
+                                                           float phi) const {
+  std::optional<CatmullRomWeights> weights_in =
+      weights_.ComputeWeights(mu_in);
+  std::optional<CatmullRomWeights> weights_out =
+      weights_.ComputeWeights(mu_out);
+  if (!weights_in || !weights_out) {
+    return Value{0.0f, 0.0f, 0.0f};
+  }
+
+  WeightedSeries series[16];
+  size_t num_series =
+      GatherWeightedSeries(bsdf_, *weights_in, *weights_out, series);
+
+  double value_y, value_r, value_b;
+  SumWeightedSeries(bsdf_, series, num_series,
+                    std::cos(static_cast<double>(phi)), value_y, value_r,
+                    value_b);
+
+  if (!HasColor(bsdf_)) {
+    return Value{static_cast<float>(value_y), static_cast<float>(value_y),
+                 static_cast<float>(value_y)};
+  }
+
+  return Value{static_cast<float>(value_y), static_cast<float>(value_r),
+               static_cast<float>(value_b)};
+}
+
+std::expected<void, std::string> FourierBsdfEvaluator::EvaluateBatch(
+    std::span<const float> mu_in, std::span<const float> mu_out,
+    std::span<const float> phi, std::span<float> y, std::span<float> r,
+    std::span<float> b) const {
+  if (mu_out.size() != mu_in.size() || phi.size() != mu_in.size() ||
+      y.size() != mu_in.size() || r.size() != mu_in.size() ||
+      b.size() != mu_in.size()) {
+    return std::unexpected("The inputs and outputs must be the same size");
+  }
+
+  for (size_t i = 0; i < mu_in.size(); i++) {
+    Value value = Evaluate(mu_in[i], mu_out[i], phi[i]);
+    y[i] = value.y;
+    r[i] = value.r;
+    b[i] = value.b;
+  }
+
+  return std::expected<void, std::string>();
+}
+
+}  // namespace libfbsdf
@@ -0,0 +1,57 @@
+#ifndef _LIBFBSDF_EVALUATORS_FOURIER_BSDF_EVALUATOR_
+#define _LIBFBSDF_EVALUATORS_FOURIER_BSDF_EVALUATOR_
+
+#include <expected>
+#include <span>
+#include <string>
+
+#include "libfbsdf/evaluators/catmull_rom.h"
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+
+namespace libfbsdf {
+
+// Evaluates a BSDF read by `ReadFromStandardBsdf`. The Fourier series of the
+// BSDF are interpolated between its elevational samples using Catmull-Rom
+// splines and each series is summed using the recurrence
+// cos(k * phi) = 2 * cos(phi) * cos((k - 1) * phi) - cos((k - 2) * phi) which
+// means that each evaluation makes a single call to `cos` and never allocates.
+// When built with AVX2, four terms of each series are summed at a time.
+//
+// NOTE: The evaluator refers to `bsdf` which must outlive it
+class FourierBsdfEvaluator final {
+ public:
+  // The color channels of an evaluated BSDF. For BSDFs with a single color
+  // channel, `r` and `b` are equal to `y`.
+  struct Value {
+    float y;
+    float r;
+    float b;
+  };
+
+  explicit FourierBsdfEvaluator(const ReadFromStandardBsdfResult& bsdf)
+      : bsdf_(bsdf),
+        weights_(bsdf.elevational_samples, bsdf.elevational_guide) {}
+
+  // Evaluates the Fourier series of the BSDF at the cosines of the elevation
+  // angles of the incoming and outgoing directions, `mu_in` and `mu_out`, and
+  // the azimuthal angle in radians between them, `phi`. Returns zero if either
+  // `mu_in` or `mu_out` is outside of the range of the elevational samples.
+  Value Evaluate(float mu_in, float mu_out, float phi) const;
+
+  // Evaluates a batch of queries stored as separate arrays of `mu_in`,
+  // `mu_out`, and `phi` values, writing the result of each query to the same
+  // index of `y`, `r`, and `b`. Returns an error without evaluating any queries
+  // if the six spans are not all the same size.
+  std::expected<void, std::string> EvaluateBatch(std::span<const float> mu_in,
+                     std::span<const float> mu_out, std::span<const float> phi,
+                     std::span<float> y, std::span<float> r,
+                     std::span<float> b) const;
+
+ private:
+  const ReadFromStandardBsdfResult& bsdf_;
+  CatmullRomWeightTable weights_;
+};
+
+}  // namespace libfbsdf
+
+#endif  // _LIBFBSDF_EVALUATORS_FOURIER_BSDF_EVALUATOR_
@@ -0,0 +1,499 @@
+#include "libfbsdf/evaluators/fourier_bsdf_evaluator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "googletest/include/gtest/gtest.h"
+#include "libfbsdf/aligned_vector.h"
+#include "libfbsdf/half_float.h"
+#include "libfbsdf/readers/reciprocal_series.h"
+#include "libfbsdf/readers/series_deduplication.h"
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+#include "libfbsdf/readers/test_standard_bsdf.h"
+#include "test_data/test_data.h"
+
+namespace libfbsdf {
+namespace {
+
+using ::libfbsdf::testing::MakeMonochromeBsdf;
+using ::libfbsdf::testing::OpenTestData;
+
+// Evaluates the BSDF at `mu_in` and `mu_out` by independently computing the
+// Catmull-Rom weights of every elevational sample and summing each term of
+// the Fourier series using `cos`
+float Reference(const ReadFromStandardBsdfResult& bsdf,
+                std::span<const float> coefficients, float mu_in,
+                float mu_out, float phi) {
+  std::span<const float> samples = bsdf.elevational_samples;
+  auto weights = [&](float x) {
+    std::vector<double> result(samples.size(), 0.0);
+    size_t i = 0;
+    while (i + 2 < samples.size() && samples[i + 1] <= x) {
+      i++;
+    }
+
+    double x0 = samples[i], x1 = samples[i + 1];
+    double t = (x - x0) / (x1 - x0);
+    double h00 = 2 * t * t * t - 3 * t * t + 1;
+    double h10 = t * t * t - 2 * t * t + t;
+    double h01 = -2 * t * t * t + 3 * t * t;
+    double h11 = t * t * t - t * t;
+
+    result[i] += h00;
+    result[i + 1] += h01;
+
+    // The derivative at each end of the interval is estimated with a finite
+    // difference that falls back to a one sided difference at the boundaries
+    size_t a = i > 0 ? i - 1 : i;
+    double d0 = h10 * (x1 - x0) / (samples[i + 1] - samples[a]);
+    result[i + 1] += d0;
+    result[a] -= d0;
+
+    size_t b = i + 2 < samples.size() ? i + 2 : i + 1;
+    double d1 = h11 * (x1 - x0) / (samples[b] - samples[i]);
+    result[b] += d1;
+    result[i] -= d1;
+
+    return result;
+  };
+
+  std::vector<double> weights_in = weights(mu_in);
+  std::vector<double> weights_out = weights(mu_out);
+
+  double value = 0.0;
+  for (size_t o = 0; o < samples.size(); o++) {
+    for (size_t i = 0; i < samples.size(); i++) {
+      auto [offset, length] = bsdf.series_extents[o * samples.size() + i];
+      for (size_t k = 0; k < length; k++) {
+        value += weights_in[i] * weights_out[o] * coefficients[offset + k] *
+                 std::cos(k * static_cast<double>(phi));
+      }
+    }
+  }
+
+  return static_cast<float>(value);
+}
+
+TEST(FourierBsdfEvaluator, OutOfRange) {
+  ReadFromStandardBsdfResult bsdf = MakeMonochromeBsdf();
+  FourierBsdfEvaluator evaluator(bsdf);
+
+  FourierBsdfEvaluator::Value value = evaluator.Evaluate(-1.5f, 0.5f, 0.0f);
+  EXPECT_EQ(0.0f, value.y);
+  EXPECT_EQ(0.0f, value.r);
+  EXPECT_EQ(0.0f, value.b);
+
+  value = evaluator.Evaluate(0.5f, 1.5f, 0.0f);
+  EXPECT_EQ(0.0f, value.y);
+  EXPECT_EQ(0.0f, value.r);
+  EXPECT_EQ(0.0f, value.b);
+
+  value = evaluator.Evaluate(NAN, 0.5f, 0.0f);
+  EXPECT_EQ(0.0f, value.y);
+  EXPECT_EQ(0.0f, value.r);
+  EXPECT_EQ(0.0f, value.b);
+}
+
+TEST(FourierBsdfEvaluator, AtSamples) {
+  ReadFromStandardBsdfResult bsdf = MakeMonochromeBsdf();
+  FourierBsdfEvaluator evaluator(bsdf);
+
+  for (size_t o = 0; o < 3; o++) {
+    for (size_t i = 0; i < 3; i++) {
+      auto [offset, length] = bsdf.series_extents[o * 3 + i];
+      for (float phi : {0.0f, 0.5f, 2.0f, 3.14159f}) {
+        float expected = 0.0f;
+        for (size_t k = 0; k < length; k++) {
+          expected += bsdf.y_coefficients[offset + k] * std::cos(k * phi);
+        }
+
+        FourierBsdfEvaluator::Value value =
+            evaluator.Evaluate(bsdf.elevational_samples[i],
+                               bsdf.elevational_samples[o], phi);
+        EXPECT_NEAR(expected, value.y, 1e-5f);
+        EXPECT_EQ(value.y, value.r);
+        EXPECT_EQ(value.y, value.b);
+      }
+    }
+  }
+}
+
+TEST(FourierBsdfEvaluator, Interpolates) {
+  ReadFromStandardBsdfResult bsdf = MakeMonochromeBsdf();
+  FourierBsdfEvaluator evaluator(bsdf);
+
+  for (float mu_in : {-0.75f, -0.1f, 0.3f, 0.9f}) {
+    for (float mu_out : {-0.6f, 0.0f, 0.45f, 0.99f}) {
+      for (float phi : {0.0f, 1.0f, 2.5f}) {
+        EXPECT_NEAR(Reference(bsdf, bsdf.y_coefficients, mu_in, mu_out, phi),
+                    evaluator.Evaluate(mu_in, mu_out, phi).y, 1e-4f);
+      }
+    }
+  }
+}
+
+TEST(FourierBsdfEvaluator, TestData) {
+  auto bsdf = ReadFromStandardBsdf(*OpenTestData("leather"));
+  ASSERT_TRUE(bsdf) << bsdf.error();
+  ASSERT_FALSE(bsdf->r_coefficients.empty());
+  FourierBsdfEvaluator evaluator(*bsdf);
+
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<float> mu(-1.0f, 1.0f);
+  std::uniform_real_distribution<float> phi(0.0f, 3.14159f);
+  for (size_t n = 0; n < 32; n++) {
+    float mu_in = mu(rng), mu_out = mu(rng), angle = phi(rng);
+    FourierBsdfEvaluator::Value value =
+        evaluator.Evaluate(mu_in, mu_out, angle);
+
+    float y = Reference(*bsdf, bsdf->y_coefficients, mu_in, mu_out, angle);
+    float r = Reference(*bsdf, bsdf->r_coefficients, mu_in, mu_out, angle);
+    float b = Reference(*bsdf, bsdf->b_coefficients, mu_in, mu_out, angle);
+    EXPECT_NEAR(y, value.y, 1e-3f * std::max(1.0f, std::abs(y)));
+    EXPECT_NEAR(r, value.r, 1e-3f * std::max(1.0f, std::abs(r)));
+    EXPECT_NEAR(b, value.b, 1e-3f * std::max(1.0f, std::abs(b)));
+  }
+}
+
+TEST(FourierBsdfEvaluator, ElevationalGuide) {
+  auto bsdf = ReadFromStandardBsdf(*OpenTestData("leather"));
+  ASSERT_TRUE(bsdf) << bsdf.error();
+  auto guided_bsdf = ReadFromStandardBsdf(*OpenTestData("leather"),
+                                          {.build_elevational_guide = true});
+  ASSERT_TRUE(guided_bsdf) << guided_bsdf.error();
+  ASSERT_FALSE(guided_bsdf->elevational_guide.intervals.empty());
+
+  FourierBsdfEvaluator evaluator(*bsdf);
+  FourierBsdfEvaluator guided_evaluator(*guided_bsdf);
+
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<float> mu(-1.0f, 1.0f);
+  std::uniform_real_distribution<float> phi(0.0f, 3.14159f);
+  for (size_t n = 0; n < 256; n++) {
+    float mu_in = mu(rng), mu_out = mu(rng), angle = phi(rng);
+    FourierBsdfEvaluator::Value expected =
+        evaluator.Evaluate(mu_in, mu_out, angle);
+    FourierBsdfEvaluator::Value actual =
+        guided_evaluator.Evaluate(mu_in, mu_out, angle);
+    EXPECT_EQ(expected.y, actual.y);
+    EXPECT_EQ(expected.r, actual.r);
+    EXPECT_EQ(expected.b, actual.b);
+  }
+}
+
+TEST(FourierBsdfEvaluator, CompactSeriesExtents) {
+  auto bsdf = ReadFromStandardBsdf(*OpenTestData("paint"));
+  ASSERT_TRUE(bsdf) << bsdf.error();
+  auto compact_bsdf = ReadFromStandardBsdf(*OpenTestData("paint"),
+                                           {.compact_series_extents = true});
+  ASSERT_TRUE(compact_bsdf) << compact_bsdf.error();
+  ASSERT_FALSE(compact_bsdf->series_lengths.empty());
+
+  FourierBsdfEvaluator evaluator(*bsdf);
+  FourierBsdfEvaluator compact_evaluator(*compact_bsdf);
+
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<float> mu(-1.0f, 1.0f);
+  std::uniform_real_distribution<float> phi(0.0f, 3.14159f);
+  for (size_t n = 0; n < 256; n++) {
+    float mu_in = mu(rng), mu_out = mu(rng), angle = phi(rng);
+    FourierBsdfEvaluator::Value expected =
+        evaluator.Evaluate(mu_in, mu_out, angle);
+    FourierBsdfEvaluator::Value actual =
+        compact_evaluator.Evaluate(mu_in, mu_out, angle);
+    EXPECT_EQ(expected.y, actual.y);
+    EXPECT_EQ(expected.r, actual.r);
+    EXPECT_EQ(expected.b, actual.b);
+  }
+}
+
+TEST(FourierBsdfEvaluator, SeriesPadding) {
+  auto bsdf = ReadFromStandardBsdf(*OpenTestData("paint"));
+  ASSERT_TRUE(bsdf) << bsdf.error();
+  FourierBsdfEvaluator evaluator(*bsdf);
+
+  for (size_t series_padding : {4u, 8u, 16u}) {
+    auto padded_bsdf = ReadFromStandardBsdf(
+        *OpenTestData("paint"), {.series_padding = series_padding});
+    ASSERT_TRUE(padded_bsdf) << padded_bsdf.error();
+    FourierBsdfEvaluator padded_evaluator(*padded_bsdf);
+
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<float> mu(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> phi(0.0f, 3.14159f);
+    for (size_t n = 0; n < 256; n++) {
+      float mu_in = mu(rng), mu_out = mu(rng), angle = phi(rng);
+      FourierBsdfEvaluator::Value expected =
+          evaluator.Evaluate(mu_in, mu_out, angle);
+      FourierBsdfEvaluator::Value actual =
+          padded_evaluator.Evaluate(mu_in, mu_out, angle);
+      EXPECT_EQ(expected.y, actual.y);
+      EXPECT_EQ(expected.r, actual.r);
+      EXPECT_EQ(expected.b, actual.b);
+    }
+  }
+}
+
+TEST(FourierBsdfEvaluator, InterleavedColorChannels) {
+  auto bsdf = ReadFromStandardBsdf(*OpenTestData("paint"));
+  ASSERT_TRUE(bsdf) << bsdf.error();
+  ASSERT_TRUE(HasColor(*bsdf));
+  FourierBsdfEvaluator evaluator(*bsdf);
+
+  for (size_t series_padding : {1u, 4u}) {
+    auto interleaved_bsdf = ReadFromStandardBsdf(
+        *OpenTestData("paint"), {.series_padding = series_padding,
+                                 .interleave_color_channels = true});
+    ASSERT_TRUE(interleaved_bsdf) << interleaved_bsdf.error();
+    ASSERT_TRUE(interleaved_bsdf->interleaved_color_channels);
+    FourierBsdfEvaluator interleaved_evaluator(*interleaved_bsdf);
+
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<float> mu(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> phi(0.0f, 3.14159f);
+    for (size_t n = 0; n < 256; n++) {
+      float mu_in = mu(rng), mu_out = mu(rng), angle = phi(rng);
+      FourierBsdfEvaluator::Value expected =
+          evaluator.Evaluate(mu_in, mu_out, angle);
+      FourierBsdfEvaluator::Value actual =
+          interleaved_evaluator.Evaluate(mu_in, mu_out, angle);
+      EXPECT_EQ(expected.y, actual.y);
+      EXPECT_EQ(expected.r, actual.r);
+      EXPECT_EQ(expected.b, actual.b);
+    }
+  }
+}
+
+// Returns a copy of `bsdf` with its 16-bit coefficients widened back to floats
+ReadFromStandardBsdfResult WidenCoefficients(
+    const ReadFromStandardBsdfResult& bsdf) {
+  ReadFromStandardBsdfResult result = bsdf;
+  const AlignedVector<uint16_t>* inputs[3] = {&bsdf.y_half_coefficients,
+                                              &bsdf.r_half_coefficients,
+                                              &bsdf.b_half_coefficients};
+  AlignedVector<float>* outputs[3] = {&result.y_coefficients,
+                                      &result.r_coefficients,
+                                      &result.b_coefficients};
+  for (size_t c = 0; c < 3; c++) {
+    for (uint16_t bits : *inputs[c]) {
+      outputs[c]->push_back(bsdf.coefficient_format ==
+                                    CoefficientFormat::kFloat16
+                                ? Float16ToFloat(bits)
+                                : BFloat16ToFloat(bits));
+    }
+  }
+
+  result.coefficient_format = CoefficientFormat::kFloat32;
+  result.y_half_coefficients.clear();
+  result.r_half_coefficients.clear();
+  result.b_half_coefficients.clear();
+  return result;
+}
+
+TEST(FourierBsdfEvaluator, HalfCoefficients) {
+  for (CoefficientFormat format :
+       {CoefficientFormat::kFloat16, CoefficientFormat::kBFloat16}) {
+    for (size_t series_padding : {1u, 4u}) {
+      auto bsdf = ReadFromStandardBsdf(
+          *OpenTestData("paint"),
+          {.series_padding = series_padding, .coefficient_format = format});
+      ASSERT_TRUE(bsdf) << bsdf.error();
+      ASSERT_TRUE(bsdf->y_coefficients.empty());
+      FourierBsdfEvaluator evaluator(*bsdf);
+
+      // Widening is exact, so summing the widened coefficients as floats must
+      // give the same result
+      ReadFromStandardBsdfResult widened_bsdf = WidenCoefficients(*bsdf);
+      FourierBsdfEvaluator widened_evaluator(widened_bsdf);
+
+      std::mt19937 rng(0);
+      std::uniform_real_distribution<float> mu(-1.0f, 1.0f);
+      std::uniform_real_distribution<float> phi(0.0f, 3.14159f);
+      for (size_t n = 0; n < 256; n++) {
+        float mu_in = mu(rng), mu_out = mu(rng), angle = phi(rng);
+        FourierBsdfEvaluator::Value expected =
+            widened_evaluator.Evaluate(mu_in, mu_out, angle);
+        FourierBsdfEvaluator::Value actual =
+            evaluator.Evaluate(mu_in, mu_out, angle);
+        EXPECT_EQ(expected.y, actual.y);
+        EXPECT_EQ(expected.r, actual.r);
+        EXPECT_EQ(expected.b, actual.b);
+      }
+    }
+  }
+}
+
+// Returns a copy of `bsdf` with each of its folded series copied out and
+// scaled so that no series are folded
+ReadFromStandardBsdfResult UnfoldSeries(
+    const ReadFromStandardBsdfResult& bsdf) {
+  ReadFromStandardBsdfResult result = bsdf;
+  const AlignedVector<float>* inputs[3] = {
+      &bsdf.y_coefficients, &bsdf.r_coefficients, &bsdf.b_coefficients};
+  AlignedVector<float>* outputs[3] = {&result.y_coefficients,
+                                      &result.r_coefficients,
+                                      &result.b_coefficients};
+  for (size_t c = 0; c < 3; c++) {
+    outputs[c]->clear();
+  }
+
+  for (size_t index = 0; index < bsdf.series_extents.size(); index++) {
+    auto [offset, length] = bsdf.series_extents[index];
+    result.series_extents[index] = {result.y_coefficients.size(), length};
+    for (size_t c = 0; c < 3; c++) {
+      for (size_t k = 0; k < length && !inputs[c]->empty(); k++) {
+        outputs[c]->push_back(GetSeriesScale(bsdf, index) *
+                              (*inputs[c])[offset + k]);
+      }
+    }
+  }
+
+  result.series_scales.clear();
+  return result;
+}
+
+TEST(FourierBsdfEvaluator, FoldedReciprocalSeries) {
+  for (const char* name : {"leather", "paint"}) {
+    auto bsdf = ReadFromStandardBsdf(*OpenTestData(name));
+    ASSERT_TRUE(bsdf) << name << ": " << bsdf.error();
+    auto result = FoldReciprocalSeries(*bsdf, 1e-3);
+    ASSERT_TRUE(result) << name << ": " << result.error();
+    ASSERT_GT(result->num_series_folded, 0u) << name;
+    FourierBsdfEvaluator evaluator(*bsdf);
+
+    ReadFromStandardBsdfResult unfolded_bsdf = UnfoldSeries(*bsdf);
+    FourierBsdfEvaluator unfolded_evaluator(unfolded_bsdf);
+
+    // Scaling the weights instead of the coefficients only changes rounding
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<float> mu(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> phi(0.0f, 3.14159f);
+    for (size_t n = 0; n < 256; n++) {
+      float mu_in = mu(rng), mu_out = mu(rng), angle = phi(rng);
+      FourierBsdfEvaluator::Value expected =
+          unfolded_evaluator.Evaluate(mu_in, mu_out, angle);
+      FourierBsdfEvaluator::Value actual =
+          evaluator.Evaluate(mu_in, mu_out, angle);
+      EXPECT_NEAR(expected.y, actual.y, 1e-5f * std::abs(expected.y) + 1e-6f)
+          << name;
+      EXPECT_NEAR(expected.r, actual.r, 1e-5f * std::abs(expected.r) + 1e-6f)
+          << name;
+      EXPECT_NEAR(expected.b, actual.b, 1e-5f * std::abs(expected.b) + 1e-6f)
+          << name;
+    }
+  }
+}
+
+TEST(FourierBsdfEvaluator, SharedCoefficients) {
+  std::vector<ReadFromStandardBsdfResult> bsdfs;
+  for (const char* name : {"leather", "paint"}) {
+    auto bsdf = ReadFromStandardBsdf(*OpenTestData(name));
+    ASSERT_TRUE(bsdf) << name << ": " << bsdf.error();
+    bsdfs.push_back(*std::move(bsdf));
+  }
+
+  std::vector<ReadFromStandardBsdfResult> shared_bsdfs = bsdfs;
+  ReadFromStandardBsdfResult* pointers[] = {&shared_bsdfs[0],
+                                            &shared_bsdfs[1]};
+  auto result = DeduplicateSeries(pointers);
+  ASSERT_TRUE(result) << result.error();
+  ASSERT_TRUE(shared_bsdfs[0].shared_coefficients);
+
+  for (size_t b = 0; b < bsdfs.size(); b++) {
+    FourierBsdfEvaluator evaluator(bsdfs[b]);
+    FourierBsdfEvaluator shared_evaluator(shared_bsdfs[b]);
+
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<float> mu(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> phi(0.0f, 3.14159f);
+    for (size_t n = 0; n < 256; n++) {
+      float mu_in = mu(rng), mu_out = mu(rng), angle = phi(rng);
+      FourierBsdfEvaluator::Value expected =
+          evaluator.Evaluate(mu_in, mu_out, angle);
+      FourierBsdfEvaluator::Value actual =
+          shared_evaluator.Evaluate(mu_in, mu_out, angle);
+      EXPECT_EQ(expected.y, actual.y);
+      EXPECT_EQ(expected.r, actual.r);
+      EXPECT_EQ(expected.b, actual.b);
+    }
+  }
+}
+
+TEST(FourierBsdfEvaluator, EvaluateBatch) {
+  auto bsdf = ReadFromStandardBsdf(*OpenTestData("paint"));
+  ASSERT_TRUE(bsdf) << bsdf.error();
+  FourierBsdfEvaluator evaluator(*bsdf);
+
+  // Includes out of range queries and a partial group at the end
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<float> mu(-1.1f, 1.1f);
+  std::uniform_real_distribution<float> phi(0.0f, 3.14159f);
+  std::vector<float> mu_in, mu_out, angles;
+  for (size_t n = 0; n < 67; n++) {
+    mu_in.push_back(mu(rng));
+    mu_out.push_back(mu(rng));
+    angles.push_back(phi(rng));
+  }
+
+  std::vector<float> y(67, -1.0f), r(67, -1.0f), b(67, -1.0f);
+  ASSERT_TRUE(evaluator.EvaluateBatch(mu_in, mu_out, angles, y, r, b));
+
+  for (size_t n = 0; n < 67; n++) {
+    FourierBsdfEvaluator::Value value =
+        evaluator.Evaluate(mu_in[n], mu_out[n], angles[n]);
+    EXPECT_NEAR(value.y, y[n], 1e-4f * std::max(1.0f, std::abs(value.y)));
+    EXPECT_NEAR(value.r, r[n], 1e-4f * std::max(1.0f, std::abs(value.r)));
+    EXPECT_NEAR(value.b, b[n], 1e-4f * std::max(1.0f, std::abs(value.b)));
+  }
+}
+
+TEST(FourierBsdfEvaluator, EvaluateBatchMonochrome) {
+  ReadFromStandardBsdfResult bsdf = MakeMonochromeBsdf();
+  FourierBsdfEvaluator evaluator(bsdf);
+
+  std::vector<float> mu_in = {-0.75f, 0.3f, 0.9f, 2.0f, 0.0f};
+  std::vector<float> mu_out = {-0.6f, 0.45f, 0.99f, 0.0f, 0.0f};
+  std::vector<float> angles = {0.0f, 1.0f, 2.5f, 0.0f, 0.5f};
+
+  std::vector<float> y(5, -1.0f), r(5, -1.0f), b(5, -1.0f);
+  ASSERT_TRUE(evaluator.EvaluateBatch(mu_in, mu_out, angles, y, r, b));
+
+  for (size_t n = 0; n < 5; n++) {
+    FourierBsdfEvaluator::Value value =
+        evaluator.Evaluate(mu_in[n], mu_out[n], angles[n]);
+    EXPECT_NEAR(value.y, y[n], 1e-5f);
+    EXPECT_EQ(y[n], r[n]);
+    EXPECT_EQ(y[n], b[n]);
+  }
+
+  EXPECT_EQ(0.0f, y[3]);
+}
+
+TEST(FourierBsdfEvaluator, EvaluateBatchMismatchedSizes) {
+  ReadFromStandardBsdfResult bsdf = MakeMonochromeBsdf();
+  FourierBsdfEvaluator evaluator(bsdf);
+
+  std::vector<float> mu_in = {0.3f, 0.9f}, mu_out = {0.45f, 0.99f},
+                     angles = {1.0f, 2.5f};
+  std::vector<float> y(3, -1.0f), r(2, -1.0f), b(2, -1.0f);
+
+  auto result = evaluator.EvaluateBatch(mu_in, mu_out, angles, y, r, b);
+  ASSERT_FALSE(result);
+  EXPECT_EQ(result.error(), "The inputs and outputs must be the same size");
+  EXPECT_EQ(std::vector<float>(3, -1.0f), y);
+
+  std::vector<float> short_mu_out = {0.45f};
+  y.resize(2);
+  result = evaluator.EvaluateBatch(mu_in, short_mu_out, angles, y, r, b);
+  ASSERT_FALSE(result);
+  EXPECT_EQ(result.error(), "The inputs and outputs must be the same size");
+}
+
+}  // namespace
+}  // namespace libfbsdf
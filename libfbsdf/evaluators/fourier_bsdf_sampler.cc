@@ -0,0 +1,292 @@
+#include "libfbsdf/evaluators/fourier_bsdf_sampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "libfbsdf/evaluators/catmull_rom.h"
+#include "libfbsdf/evaluators/fourier_bsdf_evaluator.h"
+#include "libfbsdf/evaluators/fourier_series.h"
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+
+namespace libfbsdf {
+namespace {
+
+// Bounds the number of Newton-bisection steps taken when inverting a CDF. Each
+// step at least halves the bracketing interval when Newton's method stalls so
+// this is never reached in practice.
+constexpr size_t kMaxIterations = 64;
+
+// Interpolates `column` of the row-major `table` with `num_columns` columns
+// between its rows using the Catmull-Rom `weights`
+float InterpolateColumn(std::span<const float> table, size_t num_columns,
+                        const CatmullRomWeights& weights, size_t column) {
+  float value = 0.0f;
+  for (size_t i = 0; i < 4; i++) {
+    if (weights.weights[i] != 0.0f) {
+      size_t row = weights.offset + i;
+      value += weights.weights[i] * table[row * num_columns + column];
+    }
+  }
+
+  return value;
+}
+
+struct ElevationSample {
+  float mu_in;
+  float pdf;
+};
+
+// Samples `mu_in` by inverting the CDF of the spline through the values of
+// `a0` at the incoming elevational samples after interpolating both `cdf` and
+// `a0` between the outgoing elevational samples using `weights_out`.
+std::optional<ElevationSample> SampleElevation(
+    std::span<const float> samples, std::span<const float> cdf,
+    std::span<const float> a0, const CatmullRomWeights& weights_out,
+    float u) {
+  size_t n = samples.size();
+  auto interpolate = [&](std::span<const float> table, size_t i) {
+    return InterpolateColumn(table, n, weights_out, i);
+  };
+
+  float maximum = interpolate(cdf, n - 1);
+  if (!(maximum > 0.0f)) {
+    return std::nullopt;
+  }
+
+  // Find the last interval whose interpolated CDF does not exceed `u`
+  u *= maximum;
+  size_t first = 0, length = n - 1;
+  while (length > 0) {
+    size_t half = length / 2;
+    if (interpolate(cdf, first + half) <= u) {
+      first += half + 1;
+      length -= half + 1;
+    } else {
+      length = half;
+    }
+  }
+  size_t index = std::min(first == 0 ? 0 : first - 1, n - 2);
+
+  float f0 = interpolate(a0, index);
+  float f1 = interpolate(a0, index + 1);
+  float x0 = samples[index];
+  float x1 = samples[index + 1];
+  float width = x1 - x0;
+
+  // Rescale `u` to the integral of the spline over the interval in terms of
+  // t in [0, 1] and estimate the derivatives at each end as in
+  // `ComputeCatmullRomWeights`
+  u = (u - interpolate(cdf, index)) / width;
+
+  float d0 = f1 - f0;
+  if (index > 0) {
+    d0 = width * (f1 - interpolate(a0, index - 1)) / (x1 - samples[index - 1]);
+  }
+
+  float d1 = f1 - f0;
+  if (index + 2 < n) {
+    d1 = width * (interpolate(a0, index + 2) - f0) / (samples[index + 2] - x0);
+  }
+
+  // The initial guess for t comes from inverting a linear interpolant
+  float t;
+  if (f0 != f1) {
+    t = (f0 - std::sqrt(std::max(0.0f, f0 * f0 + 2.0f * u * (f1 - f0)))) /
+        (f0 - f1);
+  } else {
+    t = u / f0;
+  }
+
+  float a = 0.0f, b = 1.0f, fhat = 0.0f;
+  for (size_t i = 0; i < kMaxIterations; i++) {
+    if (!(t >= a && t <= b)) {
+      t = 0.5f * (a + b);
+    }
+
+    // The integral of the spline and the spline itself in Horner form
+    float Fhat =
+        t * (f0 + t * (0.5f * d0 +
+                       t * ((1.0f / 3.0f) * (-2.0f * d0 - d1) + f1 - f0 +
+                            t * (0.25f * (d0 + d1) + 0.5f * (f0 - f1)))));
+    fhat = f0 + t * (d0 + t * (-2.0f * d0 - d1 + 3.0f * (f1 - f0) +
+                               t * (d0 + d1 + 2.0f * (f0 - f1))));
+
+    if (std::abs(Fhat - u) < 1e-6f || b - a < 1e-6f) {
+      break;
+    }
+
+    if (Fhat - u < 0.0f) {
+      a = t;
+    } else {
+      b = t;
+    }
+
+    t -= (Fhat - u) / fhat;
+  }
+
+  // Rounding must not push the sample outside of the interval
+  return ElevationSample{std::clamp(x0 + width * t, x0, x1), fhat / maximum};
+}
+
+struct AzimuthSample {
+  double phi;
+  double pdf;
+};
+
+// Samples `phi` by inverting the integral of the luminance Fourier series
+// of `bsdf` that is the weighted sum of `series`. The series is even in `phi`
+// so `u` first picks a half of the circle and is then reused within that half.
+std::optional<AzimuthSample> SampleAzimuth(
+    const ReadFromStandardBsdfResult& bsdf, const WeightedSeries* series,
+    size_t num_series, float u) {
+  double a0 = 0.0;
+  for (size_t s = 0; s < num_series; s++) {
+    a0 += series[s].weight * GetLuminanceCoefficient(bsdf, series[s].offset);
+  }
+
+  if (!(a0 > 0.0)) {
+    return std::nullopt;
+  }
+
+  bool flip = u >= 0.5f;
+  double target = flip ? 2.0 * (1.0 - u) : 2.0 * u;
+
+  double a = 0.0, b = std::numbers::pi, phi = 0.5 * std::numbers::pi;
+  double f = a0;
+  for (size_t i = 0; i < kMaxIterations; i++) {
+    // Evaluate the integral of the series, F, and the series itself, f, using
+    // the recurrences for both cos(k * phi) and sin(k * phi)
+    double cos_phi = std::cos(phi);
+    double sin_phi = std::sqrt(std::max(0.0, 1.0 - cos_phi * cos_phi));
+    double cos_k_minus_one_phi = cos_phi, cos_k_phi = 1.0;
+    double sin_k_minus_one_phi = -sin_phi, sin_k_phi = 0.0;
+
+    double F = a0 * phi;
+    f = a0;
+
+    size_t num_active = num_series;
+    for (size_t k = 1; num_active != 0; k++) {
+      while (num_active != 0 && series[num_active - 1].length <= k) {
+        num_active -= 1;
+      }
+
+      double ak = 0.0;
+      for (size_t s = 0; s < num_active; s++) {
+        ak += series[s].weight *
+              GetLuminanceCoefficient(bsdf, series[s].offset + k);
+      }
+
+      double sin_k_plus_one_phi =
+          2.0 * cos_phi * sin_k_phi - sin_k_minus_one_phi;
+      double cos_k_plus_one_phi =
+          2.0 * cos_phi * cos_k_phi - cos_k_minus_one_phi;
+      sin_k_minus_one_phi = sin_k_phi;
+      sin_k_phi = sin_k_plus_one_phi;
+      cos_k_minus_one_phi = cos_k_phi;
+      cos_k_phi = cos_k_plus_one_phi;
+
+      F += ak * sin_k_phi / static_cast<double>(k);
+      f += ak * cos_k_phi;
+    }
+
+    F -= target * a0 * std::numbers::pi;
+
+    if (F > 0.0) {
+      b = phi;
+    } else {
+      a = phi;
+    }
+
+    if (std::abs(F) < 1e-6 || b - a < 1e-6) {
+      break;
+    }
+
+    phi -= F / f;
+    if (!(phi > a && phi < b)) {
+      phi = 0.5 * (a + b);
+    }
+  }
+
+  if (flip) {
+    phi = 2.0 * std::numbers::pi - phi;
+  }
+
+  return AzimuthSample{phi, f / (2.0 * std::numbers::pi * a0)};
+}
+
+}  // namespace
+
+FourierBsdfSampler::FourierBsdfSampler(const ReadFromStandardBsdfResult& bsdf)
+    : bsdf_(bsdf), weights_(bsdf.elevational_samples, bsdf.elevational_guide) {
+  a0_.reserve(bsdf.cdf.size());
+  for (size_t i = 0; i < bsdf.cdf.size(); i++) {
+    auto [offset, length] = GetSeriesExtent(bsdf, i);
+    a0_.push_back(length != 0 ? GetSeriesScale(bsdf, i) *
+                                    GetLuminanceCoefficient(bsdf, offset)
+                              : 0.0f);
+  }
+}
+
+std::optional<FourierBsdfSampler::Result> FourierBsdfSampler::Sample(
+    float mu_out, float u_mu, float u_phi) const {
+  std::optional<CatmullRomWeights> weights_out =
+      weights_.ComputeWeights(mu_out);
+  if (!weights_out) {
+    return std::nullopt;
+  }
+
+  std::optional<ElevationSample> elevation = SampleElevation(
+      bsdf_.elevational_samples, bsdf_.cdf, a0_, *weights_out, u_mu);
+  if (!elevation) {
+    return std::nullopt;
+  }
+
+  std::optional<CatmullRomWeights> weights_in =
+      weights_.ComputeWeights(elevation->mu_in);
+  if (!weights_in) {
+    return std::nullopt;
+  }
+
+  WeightedSeries series[16];
+  size_t num_series =
+      GatherWeightedSeries(bsdf_, *weights_in, *weights_out, series);
+
+  std::optional<AzimuthSample> azimuth =
+      SampleAzimuth(bsdf_, series, num_series, u_phi);
+  if (!azimuth) {
+    return std::nullopt;
+  }
+
+  float pdf = elevation->pdf * static_cast<float>(azimuth->pdf);
+  if (!(pdf > 0.0f)) {
+    return std::nullopt;
+  }
+
+  double value_y, value_r, value_b;
+  SumWeightedSeries(bsdf_, series, num_series, std::cos(azimuth->phi), value_y,
+                    value_r, value_b);
+  if (!HasColor(bsdf_)) {
+    value_r = value_y;
+    value_b = value_y;
+  }
+
+  // Keep phi in [0, 2 * pi) if rounding pushes a flipped sample onto 2 * pi
+  float phi = static_cast<float>(azimuth->phi);
+  if (phi >= static_cast<float>(2.0 * std::numbers::pi)) {
+    phi = 0.0f;
+  }
+
+  return Result{.mu_in = elevation->mu_in,
+                .phi = phi,
+                .value = {static_cast<float>(value_y),
+                          static_cast<float>(value_r),
+                          static_cast<float>(value_b)},
+                .pdf = pdf};
+}
+
+}  // namespace libfbsdf
@@ -0,0 +1,56 @@
+#ifndef _LIBFBSDF_EVALUATORS_FOURIER_BSDF_SAMPLER_
+#define _LIBFBSDF_EVALUATORS_FOURIER_BSDF_SAMPLER_
+
+#include <optional>
+#include <vector>
+
+#include "libfbsdf/evaluators/catmull_rom.h"
+#include "libfbsdf/evaluators/fourier_bsdf_evaluator.h"
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+
+namespace libfbsdf {
+
+// Importance samples a BSDF read by `ReadFromStandardBsdf`. As when tracing
+// paths from the camera, the incoming direction is sampled given the outgoing
+// direction. The cosine of the elevation angle of the incoming direction is
+// sampled by inverting the CDF stored in the BSDF, interpolated between the
+// outgoing elevational samples and within each interval of incoming
+// elevational samples with Catmull-Rom splines. The azimuthal angle is then
+// sampled by inverting the integral of the luminance Fourier series at the
+// sampled elevation angles.
+//
+// NOTE: The sampler refers to `bsdf` which must outlive it
+class FourierBsdfSampler final {
+ public:
+  struct Result {
+    float mu_in;
+    float phi;
+    FourierBsdfEvaluator::Value value;
+    float pdf;
+  };
+
+  explicit FourierBsdfSampler(const ReadFromStandardBsdfResult& bsdf);
+
+  // Samples the cosine of the elevation angle of the incoming direction and
+  // the azimuthal angle in radians, in [0, 2 * pi), between the incoming and
+  // outgoing directions using the uniform random numbers `u_mu` and `u_phi` in
+  // [0, 1). Returns the sampled angles along with the value of the BSDF there,
+  // as returned by `FourierBsdfEvaluator::Evaluate`, and the probability
+  // density of the sample with respect to `mu_in` and `phi`.
+  //
+  // Returns `std::nullopt` if `mu_out` is outside of the range of the
+  // elevational samples or if the BSDF cannot be sampled at `mu_out`.
+  std::optional<Result> Sample(float mu_out, float u_mu, float u_phi) const;
+
+ private:
+  const ReadFromStandardBsdfResult& bsdf_;
+  CatmullRomWeightTable weights_;
+
+  // The first coefficient of the luminance series of each pair of elevational
+  // samples, indexed in the same order as the series extents and `bsdf_.cdf`
+  std::vector<float> a0_;
+};
+
+}  // namespace libfbsdf
+
+#endif  // _LIBFBSDF_EVALUATORS_FOURIER_BSDF_SAMPLER_
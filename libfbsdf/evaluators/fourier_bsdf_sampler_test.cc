@@ -0,0 +1,168 @@
+#include "libfbsdf/evaluators/fourier_bsdf_sampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "googletest/include/gtest/gtest.h"
+#include "libfbsdf/evaluators/catmull_rom.h"
+#include "libfbsdf/evaluators/fourier_bsdf_evaluator.h"
+#include "libfbsdf/readers/reciprocal_series.h"
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+#include "test_data/test_data.h"
+
+namespace libfbsdf {
+namespace {
+
+using ::libfbsdf::testing::OpenTestData;
+
+// Interpolates the CDF of `bsdf` at `mu_out` and the incoming sample `i`
+float InterpolateCdf(const ReadFromStandardBsdfResult& bsdf, float mu_out,
+                     size_t i) {
+  size_t n = bsdf.elevational_samples.size();
+  std::optional<CatmullRomWeights> weights =
+      ComputeCatmullRomWeights(bsdf.elevational_samples, mu_out);
+  float value = 0.0f;
+  for (size_t o = 0; o < 4; o++) {
+    if (weights->weights[o] != 0.0f) {
+      value += weights->weights[o] * bsdf.cdf[(weights->offset + o) * n + i];
+    }
+  }
+  return value;
+}
+
+TEST(FourierBsdfSampler, OutOfRange) {
+  auto bsdf = ReadFromStandardBsdf(*OpenTestData("leather"));
+  ASSERT_TRUE(bsdf) << bsdf.error();
+  FourierBsdfSampler sampler(*bsdf);
+
+  EXPECT_FALSE(sampler.Sample(-1.5f, 0.5f, 0.5f));
+  EXPECT_FALSE(sampler.Sample(1.5f, 0.5f, 0.5f));
+  EXPECT_FALSE(sampler.Sample(NAN, 0.5f, 0.5f));
+}
+
+TEST(FourierBsdfSampler, InvertsCdf) {
+  auto bsdf = ReadFromStandardBsdf(*OpenTestData("paint"));
+  ASSERT_TRUE(bsdf) << bsdf.error();
+  FourierBsdfSampler sampler(*bsdf);
+
+  const std::vector<float>& samples = bsdf->elevational_samples;
+  for (float mu_out : {-0.8f, -0.3f, 0.2f, 0.65f}) {
+    float maximum = InterpolateCdf(*bsdf, mu_out, samples.size() - 1);
+    ASSERT_GT(maximum, 0.0f);
+
+    // A sample drawn at the value of the CDF at an elevational sample should
+    // land on that elevational sample
+    for (size_t i = 1; i + 1 < samples.size(); i += 7) {
+      float u = InterpolateCdf(*bsdf, mu_out, i) / maximum;
+      std::optional<FourierBsdfSampler::Result> sample =
+          sampler.Sample(mu_out, u, 0.3f);
+      if (!sample) {
+        continue;
+      }
+
+      EXPECT_NEAR(samples[i], sample->mu_in, 2e-3f);
+    }
+  }
+}
+
+TEST(FourierBsdfSampler, MirrorsPhi) {
+  auto bsdf = ReadFromStandardBsdf(*OpenTestData("paint"));
+  ASSERT_TRUE(bsdf) << bsdf.error();
+  FourierBsdfSampler sampler(*bsdf);
+
+  std::optional<FourierBsdfSampler::Result> low =
+      sampler.Sample(0.5f, 0.5f, 0.2f);
+  std::optional<FourierBsdfSampler::Result> high =
+      sampler.Sample(0.5f, 0.5f, 0.8f);
+  ASSERT_TRUE(low);
+  ASSERT_TRUE(high);
+  EXPECT_EQ(low->mu_in, high->mu_in);
+  EXPECT_NEAR(2.0f * std::numbers::pi_v<float>, low->phi + high->phi, 1e-4f);
+  EXPECT_NEAR(low->pdf, high->pdf, 1e-4f * low->pdf);
+}
+
+void ExpectMatchesEvaluator(const ReadFromStandardBsdfResult& bsdf) {
+  FourierBsdfEvaluator evaluator(bsdf);
+  FourierBsdfSampler sampler(bsdf);
+
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<float> mu(-0.99f, 0.99f);
+  std::uniform_real_distribution<float> u(0.0f, 1.0f);
+
+  size_t num_samples = 0;
+  for (size_t n = 0; n < 256; n++) {
+    float mu_out = mu(rng);
+    std::optional<FourierBsdfSampler::Result> sample =
+        sampler.Sample(mu_out, u(rng), u(rng));
+    if (!sample) {
+      continue;
+    }
+
+    num_samples += 1;
+    EXPECT_GE(sample->mu_in, bsdf.elevational_samples.front());
+    EXPECT_LE(sample->mu_in, bsdf.elevational_samples.back());
+    EXPECT_GE(sample->phi, 0.0f);
+    EXPECT_LT(sample->phi, 2.0f * std::numbers::pi_v<float>);
+    EXPECT_GT(sample->pdf, 0.0f);
+
+    FourierBsdfEvaluator::Value value =
+        evaluator.Evaluate(sample->mu_in, mu_out, sample->phi);
+    EXPECT_NEAR(value.y, sample->value.y, 1e-3f * std::abs(value.y));
+    EXPECT_NEAR(value.r, sample->value.r, 1e-3f * std::abs(value.r) + 1e-6f);
+    EXPECT_NEAR(value.b, sample->value.b, 1e-3f * std::abs(value.b) + 1e-6f);
+
+    // Since luminance is sampled exactly, the ratio of the luminance of each
+    // sample to its density is the integral of the luminance over the sphere
+    float maximum =
+        InterpolateCdf(bsdf, mu_out, bsdf.elevational_samples.size() - 1);
+    EXPECT_NEAR(2.0f * std::numbers::pi_v<float> * maximum,
+                sample->value.y / sample->pdf, 1e-2f * maximum);
+  }
+
+  EXPECT_GT(num_samples, 96u);
+}
+
+void ExpectMatchesEvaluator(const std::string& name,
+                            const ReadFromStandardBsdfOptions& options = {}) {
+  SCOPED_TRACE(name);
+  auto bsdf = ReadFromStandardBsdf(*OpenTestData(name), options);
+  ASSERT_TRUE(bsdf) << bsdf.error();
+  ExpectMatchesEvaluator(*bsdf);
+}
+
+TEST(FourierBsdfSampler, MatchesEvaluator) {
+  for (const char* name : {"leather", "paint", "roughglass_alpha_0.2",
+                           "roughgold_alpha_0.2"}) {
+    ExpectMatchesEvaluator(name);
+  }
+}
+
+TEST(FourierBsdfSampler, MatchesEvaluatorWithHalfCoefficients) {
+  for (CoefficientFormat format :
+       {CoefficientFormat::kFloat16, CoefficientFormat::kBFloat16}) {
+    for (const char* name : {"leather", "roughgold_alpha_0.2"}) {
+      ExpectMatchesEvaluator(name, {.coefficient_format = format});
+    }
+  }
+}
+
+TEST(FourierBsdfSampler, MatchesEvaluatorWithFoldedSeries) {
+  for (const char* name : {"leather", "roughgold_alpha_0.2"}) {
+    SCOPED_TRACE(name);
+    auto bsdf = ReadFromStandardBsdf(*OpenTestData(name));
+    ASSERT_TRUE(bsdf) << bsdf.error();
+    auto result = FoldReciprocalSeries(*bsdf, 1e-3);
+    ASSERT_TRUE(result) << result.error();
+    ASSERT_GT(result->num_series_folded, 0u);
+    ExpectMatchesEvaluator(*bsdf);
+  }
+}
+
+}  // namespace
+}  // namespace libfbsdf
@@ -0,0 +1,300 @@
+#include "libfbsdf/evaluators/fourier_series.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "libfbsdf/aligned_vector.h"
+#include "libfbsdf/evaluators/catmull_rom.h"
+#include "libfbsdf/half_float.h"
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+
+namespace libfbsdf {
+
+size_t GatherWeightedSeries(const ReadFromStandardBsdfResult& bsdf,
+                            const CatmullRomWeights& weights_in,
+                            const CatmullRomWeights& weights_out,
+                            WeightedSeries series[16]) {
+  const std::vector<float>& samples = bsdf.elevational_samples;
+
+  size_t num_series = 0;
+  for (size_t o = 0; o < 4; o++) {
+    for (size_t i = 0; i < 4; i++) {
+      float weight = weights_in.weights[i] * weights_out.weights[o];
+      if (weight == 0.0f) {
+        continue;
+      }
+
+      size_t index = (weights_out.offset + o) * samples.size() +
+                     (weights_in.offset + i);
+      auto [offset, length] = GetSeriesExtent(bsdf, index);
+      if (length == 0) {
+        continue;
+      }
+
+      // Scaling the weight instead of the series unfolds reciprocal series
+      weight *= GetSeriesScale(bsdf, index);
+
+      size_t insert_at = num_series++;
+      while (insert_at != 0 && series[insert_at - 1].length < length) {
+        series[insert_at] = series[insert_at - 1];
+        insert_at -= 1;
+      }
+
+      series[insert_at] = {offset, length, weight,
+                           GetSeriesChannelStride(bsdf, length)};
+    }
+  }
+
+  return num_series;
+}
+
+namespace {
+
+// The formats below provide the type each coefficient is stored as, widening
+// of a single coefficient, and, with AVX2, widening loads of the block of four
+// coefficients at `block`. Unless `is_padded`, only `remaining` of a block may
+// be part of the series, in which case the rest are loaded as zero and may
+// only be read if `in_bounds`. Padded series start on a block boundary of an
+// aligned array so every block of them is too.
+struct Float32Format {
+  using Coefficient = float;
+
+  static float Widen(float coefficient) { return coefficient; }
+
+#if defined(__AVX2__)
+  static __m128 Load(const float* block, size_t remaining, bool is_padded,
+                     bool /*in_bounds*/) {
+    if (is_padded) {
+      return _mm_load_ps(block);
+    }
+
+    __m128i mask = _mm_set1_epi32(-1);
+    if (remaining < 4) {
+      mask = _mm_cmpgt_epi32(_mm_set1_epi32(static_cast<int>(remaining)),
+                             _mm_setr_epi32(0, 1, 2, 3));
+    }
+
+    return _mm_maskload_ps(block, mask);
+  }
+#endif
+};
+
+#if defined(__AVX2__)
+// Loads the block of four 16-bit coefficients at `block` into the low half of
+// a vector. There is no masked load of 16-bit values, so the final block of an
+// unpadded series is loaded whole and masked unless that would read past the
+// end of the array, in which case it is copied instead.
+__m128i LoadHalfBlock(const uint16_t* block, size_t remaining, bool is_padded,
+                      bool in_bounds) {
+  if (is_padded || remaining >= 4) {
+    return _mm_loadl_epi64(reinterpret_cast<const __m128i*>(block));
+  }
+
+  if (in_bounds) {
+    __m128i mask =
+        _mm_cmpgt_epi16(_mm_set1_epi16(static_cast<int16_t>(remaining)),
+                        _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7));
+    return _mm_and_si128(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(block)), mask);
+  }
+
+  uint16_t copy[4] = {0, 0, 0, 0};
+  std::copy_n(block, remaining, copy);
+  return _mm_loadl_epi64(reinterpret_cast<const __m128i*>(copy));
+}
+#endif
+
+struct Float16Format {
+  using Coefficient = uint16_t;
+
+  static float Widen(uint16_t coefficient) {
+    return Float16ToFloat(coefficient);
+  }
+
+#if defined(__AVX2__)
+  static __m128 Load(const uint16_t* block, size_t remaining,
+                     bool is_padded, bool in_bounds) {
+    __m128i bits = LoadHalfBlock(block, remaining, is_padded, in_bounds);
+#if defined(__F16C__)
+    return _mm_cvtph_ps(bits);
+#else
+    alignas(16) uint16_t halves[8];
+    _mm_store_si128(reinterpret_cast<__m128i*>(halves), bits);
+    return _mm_setr_ps(Widen(halves[0]), Widen(halves[1]), Widen(halves[2]),
+                       Widen(halves[3]));
+#endif
+  }
+#endif
+};
+
+struct BFloat16Format {
+  using Coefficient = uint16_t;
+
+  static float Widen(uint16_t coefficient) {
+    return BFloat16ToFloat(coefficient);
+  }
+
+#if defined(__AVX2__)
+  static __m128 Load(const uint16_t* block, size_t remaining,
+                     bool is_padded, bool in_bounds) {
+    __m128i bits = LoadHalfBlock(block, remaining, is_padded, in_bounds);
+    return _mm_castsi128_ps(_mm_slli_epi32(_mm_cvtepu16_epi32(bits), 16));
+  }
+#endif
+};
+
+template <typename Format>
+void SumInFormat(const ReadFromStandardBsdfResult& bsdf,
+                 const AlignedVector<typename Format::Coefficient>& y_array,
+                 const AlignedVector<typename Format::Coefficient>& r_array,
+                 const AlignedVector<typename Format::Coefficient>& b_array,
+                 const WeightedSeries* series, size_t num_series,
+                 double cos_phi, double& value_y, double& value_r,
+                 double& value_b) {
+  using Coefficient = typename Format::Coefficient;
+
+  // With interleaved color channels, the red and blue coefficients of each
+  // series follow its luminance coefficients at multiples of its channel
+  // stride, which is otherwise zero
+  const Coefficient* y = y_array.data();
+  const Coefficient* r = nullptr;
+  const Coefficient* b = nullptr;
+  if (bsdf.interleaved_color_channels) {
+    r = y;
+    b = y;
+  } else if (!r_array.empty()) {
+    r = r_array.data();
+    b = b_array.data();
+  }
+
+#if defined(__AVX2__)
+  double cos_2_phi = 2.0 * cos_phi * cos_phi - 1.0;
+  double cos_3_phi = 2.0 * cos_phi * cos_2_phi - cos_phi;
+  double cos_4_phi = 2.0 * cos_phi * cos_3_phi - cos_2_phi;
+
+  const __m256d two_cos_4_phi = _mm256_set1_pd(2.0 * cos_4_phi);
+  __m256d cos_k_minus_4_phi =
+      _mm256_setr_pd(cos_4_phi, cos_3_phi, cos_2_phi, cos_phi);
+  __m256d cos_k_phi = _mm256_setr_pd(1.0, cos_phi, cos_2_phi, cos_3_phi);
+  __m256d sum_y = _mm256_setzero_pd();
+  __m256d sum_r = _mm256_setzero_pd();
+  __m256d sum_b = _mm256_setzero_pd();
+  bool is_padded = IsPaddedForSummation(bsdf);
+  size_t size = y_array.size();
+
+  for (size_t k = 0; num_series != 0; k += 4) {
+    while (num_series != 0 && series[num_series - 1].length <= k) {
+      num_series -= 1;
+    }
+
+    __m256d ak_y = _mm256_setzero_pd();
+    __m256d ak_r = _mm256_setzero_pd();
+    __m256d ak_b = _mm256_setzero_pd();
+    for (size_t s = 0; s < num_series; s++) {
+      size_t index = series[s].offset + k;
+      size_t remaining = series[s].length - k;
+      __m256d weight = _mm256_set1_pd(series[s].weight);
+
+      // Every channel array is the same size
+      auto load = [&](const Coefficient* channel, size_t block) {
+        return _mm256_cvtps_pd(Format::Load(channel + block, remaining,
+                                            is_padded, block + 4 <= size));
+      };
+
+      ak_y = _mm256_add_pd(ak_y, _mm256_mul_pd(weight, load(y, index)));
+      if (r != nullptr) {
+        size_t stride = series[s].channel_stride;
+        ak_r = _mm256_add_pd(ak_r,
+                             _mm256_mul_pd(weight, load(r, index + stride)));
+        ak_b = _mm256_add_pd(
+            ak_b, _mm256_mul_pd(weight, load(b, index + 2u * stride)));
+      }
+    }
+
+    sum_y = _mm256_add_pd(sum_y, _mm256_mul_pd(ak_y, cos_k_phi));
+    sum_r = _mm256_add_pd(sum_r, _mm256_mul_pd(ak_r, cos_k_phi));
+    sum_b = _mm256_add_pd(sum_b, _mm256_mul_pd(ak_b, cos_k_phi));
+
+    __m256d cos_k_plus_4_phi = _mm256_sub_pd(
+        _mm256_mul_pd(two_cos_4_phi, cos_k_phi), cos_k_minus_4_phi);
+    cos_k_minus_4_phi = cos_k_phi;
+    cos_k_phi = cos_k_plus_4_phi;
+  }
+
+  alignas(32) double sums[3][4];
+  _mm256_store_pd(sums[0], sum_y);
+  _mm256_store_pd(sums[1], sum_r);
+  _mm256_store_pd(sums[2], sum_b);
+  value_y = (sums[0][0] + sums[0][1]) + (sums[0][2] + sums[0][3]);
+  value_r = (sums[1][0] + sums[1][1]) + (sums[1][2] + sums[1][3]);
+  value_b = (sums[2][0] + sums[2][1]) + (sums[2][2] + sums[2][3]);
+#else
+  double cos_k_minus_one_phi = cos_phi;
+  double cos_k_phi = 1.0;
+  value_y = 0.0;
+  value_r = 0.0;
+  value_b = 0.0;
+
+  for (size_t k = 0; num_series != 0; k++) {
+    while (num_series != 0 && series[num_series - 1].length <= k) {
+      num_series -= 1;
+    }
+
+    double ak_y = 0.0, ak_r = 0.0, ak_b = 0.0;
+    for (size_t s = 0; s < num_series; s++) {
+      size_t index = series[s].offset + k;
+      ak_y += series[s].weight * Format::Widen(y[index]);
+      if (r != nullptr) {
+        size_t stride = series[s].channel_stride;
+        ak_r += series[s].weight * Format::Widen(r[index + stride]);
+        ak_b += series[s].weight * Format::Widen(b[index + 2u * stride]);
+      }
+    }
+
+    value_y += ak_y * cos_k_phi;
+    value_r += ak_r * cos_k_phi;
+    value_b += ak_b * cos_k_phi;
+
+    double cos_k_plus_one_phi = 2.0 * cos_phi * cos_k_phi - cos_k_minus_one_phi;
+    cos_k_minus_one_phi = cos_k_phi;
+    cos_k_phi = cos_k_plus_one_phi;
+  }
+#endif
+}
+
+}  // namespace
+
+void SumWeightedSeries(const ReadFromStandardBsdfResult& bsdf,
+                       const WeightedSeries* series, size_t num_series,
+                       double cos_phi, double& value_y, double& value_r,
+                       double& value_b) {
+  switch (bsdf.coefficient_format) {
+    case CoefficientFormat::kFloat16:
+      SumInFormat<Float16Format>(
+          bsdf, bsdf.y_half_coefficients, bsdf.r_half_coefficients,
+          bsdf.b_half_coefficients, series, num_series, cos_phi, value_y,
+          value_r, value_b);
+      return;
+    case CoefficientFormat::kBFloat16:
+      SumInFormat<BFloat16Format>(
+          bsdf, bsdf.y_half_coefficients, bsdf.r_half_coefficients,
+          bsdf.b_half_coefficients, series, num_series, cos_phi, value_y,
+          value_r, value_b);
+      return;
+    case CoefficientFormat::kFloat32:
+      break;
+  }
+
+  SumInFormat<Float32Format>(bsdf, GetYCoefficients(bsdf),
+                             GetRCoefficients(bsdf), GetBCoefficients(bsdf),
+                             series, num_series, cos_phi, value_y, value_r,
+                             value_b);
+}
+
+}  // namespace libfbsdf
@@ -0,0 +1,53 @@
+#ifndef _LIBFBSDF_EVALUATORS_FOURIER_SERIES_
+#define _LIBFBSDF_EVALUATORS_FOURIER_SERIES_
+
+#include <cstddef>
+
+#include "libfbsdf/evaluators/catmull_rom.h"
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+
+namespace libfbsdf {
+
+// A Fourier series of a BSDF along with its Catmull-Rom weight
+struct WeightedSeries {
+  size_t offset;
+  size_t length;
+  float weight;
+  size_t channel_stride;  // From `GetSeriesChannelStride`
+};
+
+// Gathers the (up to) 16 series with non-zero weight needed to interpolate
+// `bsdf` with the Catmull-Rom weights of the incoming and outgoing elevational
+// samples into `series`. The series are sorted by decreasing length so that the
+// series still contributing to each term of a sum are always a prefix of
+// `series`. Returns the number of series gathered.
+size_t GatherWeightedSeries(const ReadFromStandardBsdfResult& bsdf,
+                            const CatmullRomWeights& weights_in,
+                            const CatmullRomWeights& weights_out,
+                            WeightedSeries series[16]);
+
+// Returns true if each series of `bsdf` is padded to a whole number of the
+// blocks of four coefficients summed at a time by `SumWeightedSeries`.
+inline bool IsPaddedForSummation(const ReadFromStandardBsdfResult& bsdf) {
+  return bsdf.series_padding % 4u == 0;
+}
+
+// Sums the weighted series of `bsdf` gathered by `GatherWeightedSeries` at the
+// azimuthal angle with cosine `cos_phi` for each color channel. For monochrome
+// BSDFs, `value_r` and `value_b` are set to zero. Coefficients stored in a
+// 16-bit format are widened as they are loaded, using F16C for float16 where
+// available.
+//
+// With AVX2, the sum is computed four terms at a time with the cosines of each
+// block of terms generated from the previous two blocks using the recurrence
+// cos((k + 4) * phi) = 2 * cos(4 * phi) * cos(k * phi) - cos((k - 4) * phi).
+// The final block of each series is loaded with a mask unless the BSDF is
+// padded for summation.
+void SumWeightedSeries(const ReadFromStandardBsdfResult& bsdf,
+                       const WeightedSeries* series, size_t num_series,
+                       double cos_phi, double& value_y, double& value_r,
+                       double& value_b);
+
+}  // namespace libfbsdf
+
+#endif  // _LIBFBSDF_EVALUATORS_FOURIER_SERIES_
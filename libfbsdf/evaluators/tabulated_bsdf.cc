@@ -0,0 +1,170 @@
+#include "libfbsdf/evaluators/tabulated_bsdf.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <expected>
+#include <limits>
+#include <numbers>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "libfbsdf/evaluators/fourier_bsdf_evaluator.h"
+#include "libfbsdf/evaluators/fourier_series.h"
+#include "libfbsdf/readers/elevational_guide.h"
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+
+namespace libfbsdf {
+namespace {
+
+// Tabulates the values of `bsdf` for the incoming elevational sample `mu_in`
+// at every outgoing elevational sample and azimuthal angle with cosine in
+// `cos_phi`, writing them to `values` in the layout of `TabulatedBsdf`.
+void TabulateRow(const ReadFromStandardBsdfResult& bsdf, size_t mu_in,
+                 const std::vector<double>& cos_phi, float* values) {
+  size_t num_samples = bsdf.elevational_samples.size();
+  bool has_color = HasColor(bsdf);
+
+  for (size_t mu_out = 0; mu_out < num_samples; mu_out++) {
+    size_t index = mu_out * num_samples + mu_in;
+    auto [offset, length] = GetSeriesExtent(bsdf, index);
+    WeightedSeries series{offset, length, GetSeriesScale(bsdf, index),
+                          GetSeriesChannelStride(bsdf, length)};
+
+    for (double cos_phi_value : cos_phi) {
+      double y, r, b;
+      SumWeightedSeries(bsdf, &series, 1, cos_phi_value, y, r, b);
+
+      values[0] = static_cast<float>(y);
+      if (has_color) {
+        values[1] = static_cast<float>(r);
+        values[2] = static_cast<float>(b);
+      } else {
+        values[1] = values[2] = values[0];
+      }
+
+      values += 3;
+    }
+  }
+}
+
+}  // namespace
+
+std::expected<TabulatedBsdf, std::string> TabulatedBsdf::Build(
+    const ReadFromStandardBsdfResult& bsdf, size_t num_phi_samples,
+    size_t num_threads) {
+  if (num_phi_samples < 2) {
+    return std::unexpected("num_phi_samples must be at least 2");
+  }
+
+  size_t num_samples = bsdf.elevational_samples.size();
+  if (num_samples < 2) {
+    return std::unexpected("The BSDF must contain at least 2 elevational "
+                           "samples");
+  }
+
+  if (num_phi_samples >
+      std::numeric_limits<size_t>::max() / 3u / num_samples / num_samples) {
+    return std::unexpected("The table is too large");
+  }
+
+  std::vector<double> cos_phi;
+  for (size_t i = 0; i < num_phi_samples; i++) {
+    cos_phi.push_back(std::cos(std::numbers::pi * static_cast<double>(i) /
+                               static_cast<double>(num_phi_samples - 1)));
+  }
+
+  size_t row_size = num_samples * num_phi_samples * 3u;
+  std::vector<float> values(num_samples * row_size);
+
+  if (num_threads == 0) {
+    num_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  num_threads = std::min(num_threads, num_samples);
+
+  // Every row is the same size, so rows are simply handed out in order
+  std::atomic<size_t> next_row = 0;
+  auto worker = [&]() {
+    for (size_t row = next_row++; row < num_samples; row = next_row++) {
+      TabulateRow(bsdf, row, cos_phi, values.data() + row * row_size);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < num_threads; i++) {
+    threads.emplace_back(worker);
+  }
+
+  worker();
+
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  return TabulatedBsdf(bsdf.elevational_samples, num_phi_samples,
+                       std::move(values));
+}
+
+TabulatedBsdf::TabulatedBsdf(std::vector<float> elevational_samples,
+                             size_t num_phi_samples, std::vector<float> values)
+    : elevational_samples_(std::move(elevational_samples)),
+      guide_(BuildElevationalGuide(elevational_samples_)),
+      num_phi_samples_(num_phi_samples),
+      phi_scale_(static_cast<float>(num_phi_samples - 1) /
+                 std::numbers::pi_v<float>),
+      values_(std::move(values)) {
+  for (size_t i = 0; i + 1 < elevational_samples_.size(); i++) {
+    // `FindElevationalInterval` skips past the empty intervals between
+    // duplicate samples unless one is the last interval, where `t` is zero
+    float width = elevational_samples_[i + 1] - elevational_samples_[i];
+    inverse_widths_.push_back(width > 0.0f ? 1.0f / width : 0.0f);
+  }
+}
+
+FourierBsdfEvaluator::Value TabulatedBsdf::Lookup(float mu_in, float mu_out,
+                                                  float phi) const {
+  // Written so that NaNs are also rejected
+  if (!(mu_in >= elevational_samples_.front() &&
+        mu_in <= elevational_samples_.back() &&
+        mu_out >= elevational_samples_.front() &&
+        mu_out <= elevational_samples_.back())) {
+    return FourierBsdfEvaluator::Value{0.0f, 0.0f, 0.0f};
+  }
+
+  size_t in = FindElevationalInterval(elevational_samples_, guide_, mu_in);
+  size_t out = FindElevationalInterval(elevational_samples_, guide_, mu_out);
+  float t_in = (mu_in - elevational_samples_[in]) * inverse_widths_[in];
+  float t_out = (mu_out - elevational_samples_[out]) * inverse_widths_[out];
+
+  // The BSDF is even and periodic in phi, so any angle maps into [0, pi]
+  float x = std::abs(std::remainder(phi, 2.0f * std::numbers::pi_v<float>)) *
+            phi_scale_;
+  size_t p = std::min(static_cast<size_t>(std::max(0.0f, x)),
+                      num_phi_samples_ - 2);
+  float t_phi = std::min(x - static_cast<float>(p), 1.0f);
+
+  size_t num_samples = elevational_samples_.size();
+  auto entry = [&](size_t i, size_t o) {
+    return values_.data() + ((i * num_samples + o) * num_phi_samples_ + p) * 3;
+  };
+
+  const float* corners[4] = {entry(in, out), entry(in, out + 1),
+                             entry(in + 1, out), entry(in + 1, out + 1)};
+  float weights[4] = {(1.0f - t_in) * (1.0f - t_out), (1.0f - t_in) * t_out,
+                      t_in * (1.0f - t_out), t_in * t_out};
+
+  float result[3] = {0.0f, 0.0f, 0.0f};
+  for (size_t i = 0; i < 4; i++) {
+    for (size_t c = 0; c < 3; c++) {
+      result[c] += weights[i] * ((1.0f - t_phi) * corners[i][c] +
+                                 t_phi * corners[i][c + 3]);
+    }
+  }
+
+  return FourierBsdfEvaluator::Value{result[0], result[1], result[2]};
+}
+
+}  // namespace libfbsdf
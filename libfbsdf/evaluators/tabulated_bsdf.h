@@ -0,0 +1,63 @@
+#ifndef _LIBFBSDF_EVALUATORS_TABULATED_BSDF_
+#define _LIBFBSDF_EVALUATORS_TABULATED_BSDF_
+
+#include <cstddef>
+#include <expected>
+#include <string>
+#include <vector>
+
+#include "libfbsdf/evaluators/fourier_bsdf_evaluator.h"
+#include "libfbsdf/readers/elevational_guide.h"
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+
+namespace libfbsdf {
+
+// A dense table of the values of a BSDF read by `ReadFromStandardBsdf`
+// for previews and other uses that favor speed over accuracy. The table is
+// sampled at every pair of elevational samples of the BSDF and at
+// `num_phi_samples` azimuthal angles evenly spaced from 0 to pi, with the
+// remaining angles covered by the symmetry of the BSDF about phi = 0. Lookups
+// interpolate trilinearly between the eight surrounding entries instead of
+// summing Fourier series, so unlike `FourierBsdfEvaluator` their cost does not
+// depend on the length of the series. Lookups return the same luminance, red,
+// and blue channels as `FourierBsdfEvaluator` so the two can be swapped.
+//
+// The table holds 12 * num_phi_samples bytes for each pair of elevational
+// samples and does not refer to the BSDF it was built from.
+class TabulatedBsdf final {
+ public:
+  // Builds the table for `bsdf` using `num_threads` threads, each tabulating
+  // the values for a single incoming elevational sample at a time. If
+  // `num_threads` is zero, one thread is used per hardware thread. Fails if
+  // `num_phi_samples` is less than two.
+  static std::expected<TabulatedBsdf, std::string> Build(
+      const ReadFromStandardBsdfResult& bsdf, size_t num_phi_samples,
+      size_t num_threads = 0);
+
+  // Looks up the value of the BSDF at the cosines of the elevation angles of
+  // the incoming and outgoing directions, `mu_in` and `mu_out`, and the
+  // azimuthal angle in radians between them, `phi`. Returns zero if either
+  // `mu_in` or `mu_out` is outside of the range of the elevational samples.
+  FourierBsdfEvaluator::Value Lookup(float mu_in, float mu_out,
+                                     float phi) const;
+
+  size_t num_phi_samples() const { return num_phi_samples_; }
+
+ private:
+  TabulatedBsdf(std::vector<float> elevational_samples,
+                size_t num_phi_samples, std::vector<float> values);
+
+  std::vector<float> elevational_samples_;
+  ElevationalGuide guide_;
+  std::vector<float> inverse_widths_;
+  size_t num_phi_samples_;
+  float phi_scale_;
+
+  // Indexed by [mu_in][mu_out][phi][channel] so that the two azimuthal
+  // samples used by a lookup are adjacent
+  std::vector<float> values_;
+};
+
+}  // namespace libfbsdf
+
+#endif  // _LIBFBSDF_EVALUATORS_TABULATED_BSDF_
@@ -0,0 +1,167 @@
+#include "libfbsdf/evaluators/tabulated_bsdf.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <random>
+#include <utility>
+
+#include "googletest/include/gtest/gtest.h"
+#include "libfbsdf/evaluators/fourier_bsdf_evaluator.h"
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+#include "libfbsdf/readers/test_standard_bsdf.h"
+#include "test_data/test_data.h"
+
+namespace libfbsdf {
+namespace {
+
+using ::libfbsdf::testing::MakeMonochromeBsdf;
+using ::libfbsdf::testing::OpenTestData;
+
+constexpr float kPi = std::numbers::pi_v<float>;
+
+TEST(TabulatedBsdf, TooFewPhiSamples) {
+  ReadFromStandardBsdfResult bsdf = MakeMonochromeBsdf();
+  auto table = TabulatedBsdf::Build(bsdf, 1);
+  ASSERT_FALSE(table);
+  EXPECT_EQ("num_phi_samples must be at least 2", table.error());
+}
+
+TEST(TabulatedBsdf, TooFewElevationalSamples) {
+  ReadFromStandardBsdfResult bsdf;
+  auto table = TabulatedBsdf::Build(bsdf, 16);
+  ASSERT_FALSE(table);
+  EXPECT_EQ("The BSDF must contain at least 2 elevational samples",
+            table.error());
+}
+
+TEST(TabulatedBsdf, OutOfRange) {
+  ReadFromStandardBsdfResult bsdf = MakeMonochromeBsdf();
+  auto table = TabulatedBsdf::Build(bsdf, 16);
+  ASSERT_TRUE(table) << table.error();
+
+  for (auto [mu_in, mu_out] : {std::pair(-1.5f, 0.5f), std::pair(0.5f, 1.5f),
+                               std::pair(NAN, 0.5f)}) {
+    FourierBsdfEvaluator::Value value = table->Lookup(mu_in, mu_out, 0.0f);
+    EXPECT_EQ(0.0f, value.y);
+    EXPECT_EQ(0.0f, value.r);
+    EXPECT_EQ(0.0f, value.b);
+  }
+}
+
+TEST(TabulatedBsdf, AtSamples) {
+  ReadFromStandardBsdfResult bsdf = MakeMonochromeBsdf();
+  auto table = TabulatedBsdf::Build(bsdf, 5);
+  ASSERT_TRUE(table) << table.error();
+  EXPECT_EQ(5u, table->num_phi_samples());
+
+  for (size_t o = 0; o < 3; o++) {
+    for (size_t i = 0; i < 3; i++) {
+      auto [offset, length] = bsdf.series_extents[o * 3 + i];
+      for (size_t p = 0; p < 5; p++) {
+        float phi = kPi * static_cast<float>(p) / 4.0f;
+        float expected = 0.0f;
+        for (size_t k = 0; k < length; k++) {
+          expected += bsdf.y_coefficients[offset + k] * std::cos(k * phi);
+        }
+
+        // Angles outside of [0, pi] are mirrored and wrapped into it
+        for (float angle : {phi, -phi, phi + 2.0f * kPi, phi - 4.0f * kPi}) {
+          FourierBsdfEvaluator::Value value = table->Lookup(
+              bsdf.elevational_samples[i], bsdf.elevational_samples[o], angle);
+          EXPECT_NEAR(expected, value.y, 1e-4f);
+          EXPECT_EQ(value.y, value.r);
+          EXPECT_EQ(value.y, value.b);
+        }
+      }
+    }
+  }
+}
+
+TEST(TabulatedBsdf, Interpolates) {
+  ReadFromStandardBsdfResult bsdf = MakeMonochromeBsdf();
+  auto table = TabulatedBsdf::Build(bsdf, 5);
+  ASSERT_TRUE(table) << table.error();
+
+  auto lookup = [&](float mu_in, float mu_out, float phi) {
+    return table->Lookup(mu_in, mu_out, phi).y;
+  };
+
+  float phi0 = 0.25f * kPi, phi1 = 0.5f * kPi;
+  for (float mu_in : {-1.0f, 0.0f}) {
+    for (float mu_out : {-1.0f, 0.0f}) {
+      float t_in = 0.25f, t_out = 0.5f, t_phi = 0.75f;
+      float expected = 0.0f;
+      for (int corner = 0; corner < 8; corner++) {
+        float weight = ((corner & 1) ? t_in : 1.0f - t_in) *
+                       ((corner & 2) ? t_out : 1.0f - t_out) *
+                       ((corner & 4) ? t_phi : 1.0f - t_phi);
+        expected += weight * lookup(mu_in + ((corner & 1) ? 1.0f : 0.0f),
+                                    mu_out + ((corner & 2) ? 1.0f : 0.0f),
+                                    (corner & 4) ? phi1 : phi0);
+      }
+
+      EXPECT_NEAR(expected,
+                  lookup(mu_in + t_in, mu_out + t_out,
+                         phi0 + t_phi * (phi1 - phi0)),
+                  1e-4f);
+    }
+  }
+}
+
+TEST(TabulatedBsdf, TestData) {
+  auto bsdf = ReadFromStandardBsdf(*OpenTestData("leather"));
+  ASSERT_TRUE(bsdf) << bsdf.error();
+  ASSERT_FALSE(bsdf->r_coefficients.empty());
+  auto table = TabulatedBsdf::Build(*bsdf, 33);
+  ASSERT_TRUE(table) << table.error();
+  FourierBsdfEvaluator evaluator(*bsdf);
+
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<size_t> sample(
+      0, bsdf->elevational_samples.size() - 1);
+  std::uniform_int_distribution<size_t> angle(0, 32);
+  for (size_t n = 0; n < 256; n++) {
+    float mu_in = bsdf->elevational_samples[sample(rng)];
+    float mu_out = bsdf->elevational_samples[sample(rng)];
+    float phi = kPi * static_cast<float>(angle(rng)) / 32.0f;
+
+    FourierBsdfEvaluator::Value expected =
+        evaluator.Evaluate(mu_in, mu_out, phi);
+    FourierBsdfEvaluator::Value value = table->Lookup(mu_in, mu_out, phi);
+    EXPECT_NEAR(expected.y, value.y,
+                1e-3f * std::max(1.0f, std::abs(expected.y)));
+    EXPECT_NEAR(expected.r, value.r,
+                1e-3f * std::max(1.0f, std::abs(expected.r)));
+    EXPECT_NEAR(expected.b, value.b,
+                1e-3f * std::max(1.0f, std::abs(expected.b)));
+  }
+}
+
+TEST(TabulatedBsdf, NumThreads) {
+  auto bsdf = ReadFromStandardBsdf(*OpenTestData("paint"));
+  ASSERT_TRUE(bsdf) << bsdf.error();
+  auto expected = TabulatedBsdf::Build(*bsdf, 8, /*num_threads=*/1);
+  ASSERT_TRUE(expected) << expected.error();
+
+  for (size_t num_threads : {0u, 3u, 1000u}) {
+    auto actual = TabulatedBsdf::Build(*bsdf, 8, num_threads);
+    ASSERT_TRUE(actual) << actual.error();
+
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<float> mu(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> phi(0.0f, kPi);
+    for (size_t n = 0; n < 256; n++) {
+      float mu_in = mu(rng), mu_out = mu(rng), angle = phi(rng);
+      FourierBsdfEvaluator::Value lhs = expected->Lookup(mu_in, mu_out, angle);
+      FourierBsdfEvaluator::Value rhs = actual->Lookup(mu_in, mu_out, angle);
+      EXPECT_EQ(lhs.y, rhs.y);
+      EXPECT_EQ(lhs.r, rhs.r);
+      EXPECT_EQ(lhs.b, rhs.b);
+    }
+  }
+}
+
+}  // namespace
+}  // namespace libfbsdf
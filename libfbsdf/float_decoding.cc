@@ -0,0 +1,86 @@
+#include "libfbsdf/float_decoding.h"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define _LIBFBSDF_USE_SSE2_
+#include <emmintrin.h>
+#endif
+
+namespace libfbsdf {
+namespace {
+
+// A float is NaN or infinite if and only if all of its exponent bits are set
+constexpr uint32_t kExponentMask = 0x7F800000u;
+
+}  // namespace
+
+void DecodeUint32s(std::span<uint32_t> values) {
+  if constexpr (std::endian::native != std::endian::little) {
+    for (uint32_t& value : values) {
+      value = std::byteswap(value);
+    }
+  }
+}
+
+bool DecodeFloats(std::span<float> values) {
+  if constexpr (std::endian::native != std::endian::little) {
+    for (float& value : values) {
+      value = std::bit_cast<float>(
+          std::byteswap(std::bit_cast<uint32_t>(value)));
+    }
+  }
+
+  return AllFinite(values);
+}
+
+bool AllFinite(std::span<const float> values) {
+  // The exponents of each vector of values are compared against
+  // `kExponentMask` and the resulting masks are accumulated so that only a
+  // single branch is needed for the whole span.
+  const float* data = values.data();
+  size_t num_values = values.size();
+  size_t i = 0;
+  bool all_finite = true;
+
+#if defined(__AVX2__)
+  const __m256i exponent_mask = _mm256_set1_epi32(kExponentMask);
+  __m256i non_finite = _mm256_setzero_si256();
+  for (; num_values - i >= 8u; i += 8u) {
+    __m256i bits =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+    __m256i exponents = _mm256_and_si256(bits, exponent_mask);
+    non_finite = _mm256_or_si256(
+        non_finite, _mm256_cmpeq_epi32(exponents, exponent_mask));
+  }
+
+  all_finite = _mm256_testz_si256(non_finite, non_finite);
+#elif defined(_LIBFBSDF_USE_SSE2_)
+  const __m128i exponent_mask = _mm_set1_epi32(kExponentMask);
+  __m128i non_finite = _mm_setzero_si128();
+  for (; num_values - i >= 4u; i += 4u) {
+    __m128i bits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    __m128i exponents = _mm_and_si128(bits, exponent_mask);
+    non_finite =
+        _mm_or_si128(non_finite, _mm_cmpeq_epi32(exponents, exponent_mask));
+  }
+
+  all_finite = _mm_movemask_epi8(non_finite) == 0;
+#endif
+
+  uint32_t non_finite_tail = 0u;
+  for (; i < num_values; i++) {
+    uint32_t exponent = std::bit_cast<uint32_t>(data[i]) & kExponentMask;
+    non_finite_tail |= static_cast<uint32_t>(exponent == kExponentMask);
+  }
+
+  return all_finite && non_finite_tail == 0u;
+}
+
+}  // namespace libfbsdf
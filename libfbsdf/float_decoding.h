@@ -0,0 +1,26 @@
+#ifndef _LIBFBSDF_FLOAT_DECODING_
+#define _LIBFBSDF_FLOAT_DECODING_
+
+#include <cstdint>
+#include <span>
+
+namespace libfbsdf {
+
+// Converts `values` in place from the little-endian representation used by
+// Fourier BSDF inputs to the representation used by the host.
+void DecodeUint32s(std::span<uint32_t> values);
+
+// Converts `values` in place from the little-endian representation used by
+// Fourier BSDF inputs to the representation used by the host. Returns false if
+// any of the decoded values is NaN or infinite.
+//
+// NOTE: Decoding is vectorized using AVX2 or SSE2 when the library is built
+//       for a target that supports them.
+bool DecodeFloats(std::span<float> values);
+
+// Returns true if none of `values` is NaN or infinite.
+bool AllFinite(std::span<const float> values);
+
+}  // namespace libfbsdf
+
+#endif  // _LIBFBSDF_FLOAT_DECODING_
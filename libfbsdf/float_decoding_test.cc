@@ -0,0 +1,92 @@
+#include "libfbsdf/float_decoding.h"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "googletest/include/gtest/gtest.h"
+
+namespace libfbsdf {
+namespace {
+
+TEST(AllFinite, Empty) { EXPECT_TRUE(AllFinite(std::span<const float>())); }
+
+TEST(AllFinite, FiniteValues) {
+  std::vector<float> values = {0.0f,
+                               -0.0f,
+                               1.0f,
+                               -1.0f,
+                               std::numeric_limits<float>::max(),
+                               std::numeric_limits<float>::lowest(),
+                               std::numeric_limits<float>::min(),
+                               std::numeric_limits<float>::denorm_min()};
+  for (size_t size = 0; size <= values.size(); size++) {
+    EXPECT_TRUE(AllFinite(std::span<const float>(values.data(), size)));
+  }
+}
+
+TEST(AllFinite, NonFiniteValueAtEveryPosition) {
+  for (float non_finite : {std::numeric_limits<float>::infinity(),
+                           -std::numeric_limits<float>::infinity(),
+                           std::numeric_limits<float>::quiet_NaN(),
+                           std::numeric_limits<float>::signaling_NaN()}) {
+    for (size_t size = 1; size <= 37; size++) {
+      for (size_t i = 0; i < size; i++) {
+        std::vector<float> values(size, 1.0f);
+        values[i] = non_finite;
+        EXPECT_FALSE(AllFinite(values)) << size << " " << i;
+
+        // Exercise unaligned loads
+        std::vector<float> offset(size + 1, 1.0f);
+        offset[i + 1] = non_finite;
+        EXPECT_FALSE(AllFinite(std::span<const float>(offset).subspan(1)));
+      }
+    }
+  }
+}
+
+TEST(DecodeUint32s, Decodes) {
+  std::vector<uint32_t> values = {0x01020304u, 0xFFFFFFFFu};
+  DecodeUint32s(values);
+
+  if constexpr (std::endian::native == std::endian::little) {
+    EXPECT_EQ(values[0], 0x01020304u);
+  } else {
+    EXPECT_EQ(values[0], 0x04030201u);
+  }
+  EXPECT_EQ(values[1], 0xFFFFFFFFu);
+}
+
+TEST(DecodeFloats, Decodes) {
+  std::vector<float> values(19, 2.0f);
+  if constexpr (std::endian::native != std::endian::little) {
+    for (float& value : values) {
+      value = std::bit_cast<float>(
+          std::byteswap(std::bit_cast<uint32_t>(value)));
+    }
+  }
+
+  EXPECT_TRUE(DecodeFloats(values));
+  for (float value : values) {
+    EXPECT_EQ(value, 2.0f);
+  }
+}
+
+TEST(DecodeFloats, RejectsNonFinite) {
+  std::vector<float> values(19, 2.0f);
+  values[17] = std::numeric_limits<float>::infinity();
+  if constexpr (std::endian::native != std::endian::little) {
+    for (float& value : values) {
+      value = std::bit_cast<float>(
+          std::byteswap(std::bit_cast<uint32_t>(value)));
+    }
+  }
+
+  EXPECT_FALSE(DecodeFloats(values));
+}
+
+}  // namespace
+}  // namespace libfbsdf
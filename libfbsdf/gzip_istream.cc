@@ -0,0 +1,103 @@
+#include "libfbsdf/gzip_istream.h"
+
+#include <algorithm>
+#include <ios>
+#include <istream>
+#include <memory>
+#include <streambuf>
+
+#include "zlib.h"
+
+namespace libfbsdf {
+
+struct GzipStreambuf::State {
+  z_stream stream;
+  bool initialized;
+  char compressed[kChunkSize];
+  char decompressed[kChunkSize];
+};
+
+GzipStreambuf::GzipStreambuf(std::istream& input)
+    : input_(input), state_(std::make_unique<State>()) {
+  state_->stream.zalloc = Z_NULL;
+  state_->stream.zfree = Z_NULL;
+  state_->stream.opaque = Z_NULL;
+  state_->stream.avail_in = 0;
+  state_->stream.next_in = Z_NULL;
+
+  // Adding 32 to the window bits enables detection of both gzip and zlib
+  // headers
+  state_->initialized =
+      inflateInit2(&state_->stream, 32 + MAX_WBITS) == Z_OK;
+  failed_ = !state_->initialized || !input_;
+}
+
+GzipStreambuf::~GzipStreambuf() {
+  if (state_->initialized) {
+    inflateEnd(&state_->stream);
+  }
+}
+
+GzipStreambuf::int_type GzipStreambuf::underflow() {
+  if (gptr() < egptr()) {
+    return traits_type::to_int_type(*gptr());
+  }
+
+  position_ += egptr() - eback();
+  setg(state_->decompressed, state_->decompressed, state_->decompressed);
+
+  while (!finished_ && !failed_) {
+    if (state_->stream.avail_in == 0) {
+      input_.read(state_->compressed, kChunkSize);
+      if (input_.gcount() == 0) {
+        failed_ = true;
+        break;
+      }
+
+      state_->stream.next_in = reinterpret_cast<Bytef*>(state_->compressed);
+      state_->stream.avail_in = static_cast<uInt>(input_.gcount());
+    }
+
+    state_->stream.next_out = reinterpret_cast<Bytef*>(state_->decompressed);
+    state_->stream.avail_out = kChunkSize;
+
+    int status = inflate(&state_->stream, Z_NO_FLUSH);
+    if (status == Z_STREAM_END) {
+      finished_ = true;
+    } else if (status != Z_OK && status != Z_BUF_ERROR) {
+      failed_ = true;
+    }
+
+    size_t num_decompressed = kChunkSize - state_->stream.avail_out;
+    if (num_decompressed != 0) {
+      setg(state_->decompressed, state_->decompressed,
+           state_->decompressed + num_decompressed);
+      return traits_type::to_int_type(*gptr());
+    }
+  }
+
+  return traits_type::eof();
+}
+
+GzipStreambuf::pos_type GzipStreambuf::seekoff(off_type off,
+                                               std::ios_base::seekdir dir,
+                                               std::ios_base::openmode which) {
+  if (dir != std::ios_base::cur || !(which & std::ios_base::in) || off < 0) {
+    return pos_type(off_type(-1));
+  }
+
+  while (off != 0) {
+    if (gptr() == egptr() &&
+        traits_type::eq_int_type(underflow(), traits_type::eof())) {
+      return pos_type(off_type(-1));
+    }
+
+    off_type num_skipped = std::min(off, off_type(egptr() - gptr()));
+    gbump(static_cast<int>(num_skipped));
+    off -= num_skipped;
+  }
+
+  return pos_type(position_ + (gptr() - eback()));
+}
+
+}  // namespace libfbsdf
@@ -0,0 +1,69 @@
+#ifndef _LIBFBSDF_GZIP_ISTREAM_
+#define _LIBFBSDF_GZIP_ISTREAM_
+
+#include <cstddef>
+#include <ios>
+#include <istream>
+#include <memory>
+#include <streambuf>
+
+namespace libfbsdf {
+
+// A stream buffer that incrementally decompresses a gzip or zlib compressed
+// input. Compressed data is read from the underlying stream and decompressed
+// in fixed-size chunks as it is consumed so that at most one chunk of each is
+// held in memory at a time.
+//
+// Seeking is only supported forwards relative to the current position, which
+// is sufficient for `BsdfReader` to skip over unparsed sections of an input.
+class GzipStreambuf final : public std::streambuf {
+ public:
+  // The size in bytes of the compressed and decompressed chunks
+  static constexpr size_t kChunkSize = 65536u;
+
+  // NOTE: Behavior is undefined if input is not a binary stream
+  explicit GzipStreambuf(std::istream& input);
+  ~GzipStreambuf() override;
+
+  // Returns true if decompression stopped before the end of the compressed
+  // input was reached because the input was malformed or truncated.
+  bool failed() const { return failed_; }
+
+ protected:
+  int_type underflow() override;
+
+  pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                   std::ios_base::openmode which) override;
+
+ private:
+  struct State;
+
+  std::istream& input_;
+  std::unique_ptr<State> state_;
+  std::streamoff position_ = 0;
+  bool finished_ = false;
+  bool failed_ = false;
+};
+
+// An input stream that decompresses a gzip or zlib compressed input as it is
+// read. For example, a `.bsdf.gz` file can be parsed without first
+// decompressing it into memory by passing a `GzipIstream` wrapping the file to
+// `BsdfReader::ReadFrom`.
+class GzipIstream final : public std::istream {
+ public:
+  // NOTE: Behavior is undefined if input is not a binary stream
+  explicit GzipIstream(std::istream& input)
+      : std::istream(nullptr), streambuf_(input) {
+    rdbuf(&streambuf_);
+  }
+
+  // Returns true if the compressed input was malformed or truncated
+  bool failed() const { return streambuf_.failed(); }
+
+ private:
+  GzipStreambuf streambuf_;
+};
+
+}  // namespace libfbsdf
+
+#endif  // _LIBFBSDF_GZIP_ISTREAM_
@@ -0,0 +1,158 @@
+#include "libfbsdf/gzip_istream.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <fstream>
+#include <ios>
+#include <istream>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <sstream>
+#include <string>
+
+#include "googletest/include/gtest/gtest.h"
+#include "libfbsdf/bsdf_reader.h"
+#include "test_data/test_data.h"
+
+namespace libfbsdf {
+namespace {
+
+using ::libfbsdf::testing::FileParams;
+using ::libfbsdf::testing::kTestDataFiles;
+using ::libfbsdf::testing::OpenTestData;
+
+std::string ReadAll(std::istream& input) {
+  return std::string((std::istreambuf_iterator<char>(input)),
+                     std::istreambuf_iterator<char>());
+}
+
+std::string ReadCompressed(const FileParams& file_params) {
+  std::ifstream input(file_params.path, std::ios::in | std::ios::binary);
+  return ReadAll(input);
+}
+
+class CountingBsdfReader : public BsdfReader {
+ public:
+  std::expected<Options, std::string> Start(
+      const Flags& flags, size_t num_elevational_samples,
+      size_t num_basis_functions, size_t num_coefficients,
+      size_t num_color_channels, size_t longest_series_length,
+      size_t num_parameters, size_t num_parameter_values,
+      size_t metadata_size_bytes, float index_of_refraction,
+      float roughness_top, float roughness_bottom) override {
+    return options;
+  }
+
+  std::expected<void, std::string> HandleCoefficientChunk(
+      std::span<const float> values) override {
+    num_coefficients += values.size();
+    return std::expected<void, std::string>();
+  }
+
+  std::expected<void, std::string> HandleMetadata(std::string data) override {
+    metadata = std::move(data);
+    return std::expected<void, std::string>();
+  }
+
+  Options options;
+  size_t num_coefficients = 0;
+  std::string metadata;
+};
+
+TEST(GzipIstream, DecompressesTestData) {
+  for (const auto& [file_name, file_params] : kTestDataFiles) {
+    std::stringstream compressed(ReadCompressed(file_params));
+    GzipIstream input(compressed);
+
+    std::unique_ptr<std::istream> expected = OpenTestData(file_name);
+    EXPECT_EQ(ReadAll(*expected), ReadAll(input)) << file_name;
+    EXPECT_FALSE(input.failed());
+  }
+}
+
+TEST(GzipIstream, ReadsTestData) {
+  for (const auto& [file_name, file_params] : kTestDataFiles) {
+    std::stringstream compressed(ReadCompressed(file_params));
+    GzipIstream input(compressed);
+
+    CountingBsdfReader reader;
+    EXPECT_TRUE(reader.ReadFrom(input)) << file_name;
+    EXPECT_EQ(file_params.num_coefficients, reader.num_coefficients);
+    EXPECT_EQ(file_params.metadata_size_bytes, reader.metadata.size());
+  }
+}
+
+TEST(GzipIstream, SkipsTestData) {
+  for (const auto& [file_name, file_params] : kTestDataFiles) {
+    std::stringstream compressed(ReadCompressed(file_params));
+    GzipIstream input(compressed);
+
+    CountingBsdfReader reader;
+    reader.options.parse_coefficients = false;
+    reader.options.parse_cdf_mu = false;
+    EXPECT_TRUE(reader.ReadFrom(input)) << file_name;
+    EXPECT_EQ(0u, reader.num_coefficients);
+    EXPECT_EQ(file_params.metadata_size_bytes, reader.metadata.size());
+  }
+}
+
+TEST(GzipIstream, SeeksForwards) {
+  const FileParams& file_params = kTestDataFiles.at("paint");
+  std::stringstream compressed(ReadCompressed(file_params));
+  GzipIstream input(compressed);
+
+  std::string expected = ReadAll(*OpenTestData("paint"));
+
+  EXPECT_EQ(0, input.tellg());
+  ASSERT_TRUE(input.seekg(GzipStreambuf::kChunkSize + 3, std::ios_base::cur));
+  EXPECT_EQ(static_cast<std::streamoff>(GzipStreambuf::kChunkSize + 3),
+            input.tellg());
+  EXPECT_EQ(expected[GzipStreambuf::kChunkSize + 3], input.get());
+
+  EXPECT_FALSE(input.seekg(-1, std::ios_base::cur));
+}
+
+TEST(GzipIstream, SeekPastEndFails) {
+  const FileParams& file_params = kTestDataFiles.at("paint");
+  std::stringstream compressed(ReadCompressed(file_params));
+  GzipIstream input(compressed);
+
+  std::string expected = ReadAll(*OpenTestData("paint"));
+  EXPECT_FALSE(input.seekg(expected.size() + 1, std::ios_base::cur));
+}
+
+TEST(GzipIstream, Truncated) {
+  const FileParams& file_params = kTestDataFiles.at("paint");
+  std::string compressed_bytes = ReadCompressed(file_params);
+  std::stringstream compressed(
+      compressed_bytes.substr(0, compressed_bytes.size() / 2));
+  GzipIstream input(compressed);
+
+  CountingBsdfReader reader;
+  auto result = reader.ReadFrom(input);
+  ASSERT_FALSE(result);
+  EXPECT_EQ("Unexpected EOF", result.error());
+  EXPECT_TRUE(input.failed());
+}
+
+TEST(GzipIstream, NotCompressed) {
+  std::stringstream compressed("this is not compressed");
+  GzipIstream input(compressed);
+
+  EXPECT_EQ("", ReadAll(input));
+  EXPECT_TRUE(input.failed());
+}
+
+TEST(GzipIstream, BadInput) {
+  std::stringstream compressed(ReadCompressed(kTestDataFiles.at("paint")));
+  compressed.setstate(std::ios::badbit);
+  GzipIstream input(compressed);
+
+  EXPECT_EQ("", ReadAll(input));
+  EXPECT_TRUE(input.failed());
+}
+
+}  // namespace
+}  // namespace libfbsdf
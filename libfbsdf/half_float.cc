@@ -0,0 +1,103 @@
+#include "libfbsdf/half_float.h"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#if defined(__AVX2__) || defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+namespace libfbsdf {
+
+uint16_t FloatToFloat16(float value) {
+  uint32_t bits = std::bit_cast<uint32_t>(value);
+  uint32_t sign = bits & 0x80000000u;
+  bits ^= sign;
+
+  uint32_t result;
+  if (bits >= (127u + 16u) << 23) {
+    // At least 2^16, which rounds to infinity, or is already infinite or NaN
+    result = bits > 0x7F800000u ? 0x7E00u : 0x7C00u;
+  } else if (bits < (127u - 14u) << 23) {
+    // Results in the subnormal range are rounded by the addition itself, which
+    // aligns the value so that the float16 mantissa is in the low bits
+    constexpr uint32_t kMagic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+    result = std::bit_cast<uint32_t>(std::bit_cast<float>(bits) +
+                                     std::bit_cast<float>(kMagic)) -
+             kMagic;
+  } else {
+    // Rebias the exponent and round the mantissa, where a carry out of the
+    // mantissa correctly increments the exponent and may produce infinity
+    uint32_t is_odd = (bits >> 13) & 1u;
+    bits += ((15u - 127u) << 23) + 0xFFFu + is_odd;
+    result = bits >> 13;
+  }
+
+  return static_cast<uint16_t>(result | (sign >> 16));
+}
+
+uint16_t FloatToBFloat16(float value) {
+  uint32_t bits = std::bit_cast<uint32_t>(value);
+  if ((bits & 0x7FFFFFFFu) > 0x7F800000u) {
+    // Rounding could carry a NaN into an infinity, so it is quieted instead
+    return static_cast<uint16_t>((bits | 0x00400000u) >> 16);
+  }
+
+  bits += 0x7FFFu + ((bits >> 16) & 1u);
+  return static_cast<uint16_t>(bits >> 16);
+}
+
+void FloatsToFloat16(std::span<const float> values,
+                     std::span<uint16_t> output) {
+  size_t i = 0;
+#if defined(__F16C__)
+  for (; values.size() - i >= 8u; i += 8u) {
+    __m128i halves = _mm256_cvtps_ph(_mm256_loadu_ps(values.data() + i),
+                                     _MM_FROUND_TO_NEAREST_INT);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output.data() + i), halves);
+  }
+#endif
+
+  for (; i < values.size(); i++) {
+    output[i] = FloatToFloat16(values[i]);
+  }
+}
+
+void FloatsToBFloat16(std::span<const float> values,
+                      std::span<uint16_t> output) {
+  size_t i = 0;
+#if defined(__AVX2__)
+  const __m256i one = _mm256_set1_epi32(1);
+  const __m256i rounding_bias = _mm256_set1_epi32(0x7FFF);
+  const __m256i abs_mask = _mm256_set1_epi32(0x7FFFFFFF);
+  const __m256i infinity = _mm256_set1_epi32(0x7F800000);
+  const __m256i quiet_bit = _mm256_set1_epi32(0x00400000);
+  for (; values.size() - i >= 8u; i += 8u) {
+    __m256i bits = _mm256_castps_si256(_mm256_loadu_ps(values.data() + i));
+    __m256i is_odd = _mm256_and_si256(_mm256_srli_epi32(bits, 16), one);
+    __m256i rounded = _mm256_add_epi32(
+        bits, _mm256_add_epi32(rounding_bias, is_odd));
+
+    __m256i is_nan =
+        _mm256_cmpgt_epi32(_mm256_and_si256(bits, abs_mask), infinity);
+    rounded = _mm256_blendv_epi8(
+        rounded, _mm256_or_si256(bits, quiet_bit), is_nan);
+
+    // Packing works within each 128-bit lane, so the two halves of the
+    // result are gathered into the low lane afterwards
+    __m256i shifted = _mm256_srli_epi32(rounded, 16);
+    __m256i packed = _mm256_permute4x64_epi64(
+        _mm256_packus_epi32(shifted, shifted), 0x08);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output.data() + i),
+                     _mm256_castsi256_si128(packed));
+  }
+#endif
+
+  for (; i < values.size(); i++) {
+    output[i] = FloatToBFloat16(values[i]);
+  }
+}
+
+}  // namespace libfbsdf
@@ -0,0 +1,57 @@
+#ifndef _LIBFBSDF_HALF_FLOAT_
+#define _LIBFBSDF_HALF_FLOAT_
+
+#include <bit>
+#include <cstdint>
+#include <span>
+
+namespace libfbsdf {
+
+// Returns the bits of the IEEE 754 binary16 ("float16") value nearest to
+// `value`, rounding ties to even. Values too large for float16 become
+// infinities and NaNs remain NaNs.
+uint16_t FloatToFloat16(float value);
+
+// Returns the value of the float16 with bits `bits`.
+inline float Float16ToFloat(uint16_t bits) {
+  // The exponent is rebiased from 15 to 127 in place. Infinities and NaNs need
+  // the largest exponent instead, while subnormals are normalized by
+  // subtracting the implicit leading bit they were given.
+  constexpr uint32_t kShiftedExponent = 0x7C00u << 13;
+  uint32_t result = (bits & 0x7FFFu) << 13;
+  uint32_t exponent = result & kShiftedExponent;
+  result += (127u - 15u) << 23;
+  if (exponent == kShiftedExponent) {
+    result += (128u - 16u) << 23;
+  } else if (exponent == 0) {
+    result += 1u << 23;
+    result = std::bit_cast<uint32_t>(std::bit_cast<float>(result) -
+                                     std::bit_cast<float>(113u << 23));
+  }
+
+  return std::bit_cast<float>(result | ((bits & 0x8000u) << 16));
+}
+
+// Returns the bits of the bfloat16 value nearest to `value`, rounding ties to
+// even. bfloat16 keeps the exponent range of a float, so only NaNs and
+// infinities are not finite.
+uint16_t FloatToBFloat16(float value);
+
+// Returns the value of the bfloat16 with bits `bits`.
+inline float BFloat16ToFloat(uint16_t bits) {
+  return std::bit_cast<float>(static_cast<uint32_t>(bits) << 16);
+}
+
+// Converts each of `values` to float16 or bfloat16 as above, writing the bits
+// to the same index of `output` which must be at least as large as `values`.
+//
+// NOTE: Conversion to float16 is vectorized using F16C and conversion to
+//       bfloat16 using AVX2 when the library is built for a target that
+//       supports them.
+void FloatsToFloat16(std::span<const float> values, std::span<uint16_t> output);
+void FloatsToBFloat16(std::span<const float> values,
+                      std::span<uint16_t> output);
+
+}  // namespace libfbsdf
+
+#endif  // _LIBFBSDF_HALF_FLOAT_
@@ -0,0 +1,111 @@
+#include "libfbsdf/half_float.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "googletest/include/gtest/gtest.h"
+
+namespace libfbsdf {
+namespace {
+
+TEST(Float16, ExactValues) {
+  EXPECT_EQ(0x0000u, FloatToFloat16(0.0f));
+  EXPECT_EQ(0x8000u, FloatToFloat16(-0.0f));
+  EXPECT_EQ(0x3C00u, FloatToFloat16(1.0f));
+  EXPECT_EQ(0xC000u, FloatToFloat16(-2.0f));
+  EXPECT_EQ(0x7BFFu, FloatToFloat16(65504.0f));
+  EXPECT_EQ(0x0400u, FloatToFloat16(std::ldexp(1.0f, -14)));
+  EXPECT_EQ(0x0001u, FloatToFloat16(std::ldexp(1.0f, -24)));
+}
+
+TEST(Float16, Rounding) {
+  // Ties round to even in both the normal and subnormal ranges
+  EXPECT_EQ(0x3C00u, FloatToFloat16(1.0f + std::ldexp(1.0f, -11)));
+  EXPECT_EQ(0x3C02u, FloatToFloat16(1.0f + 3.0f * std::ldexp(1.0f, -11)));
+  EXPECT_EQ(0x0000u, FloatToFloat16(std::ldexp(1.0f, -25)));
+  EXPECT_EQ(0x0002u, FloatToFloat16(3.0f * std::ldexp(1.0f, -25)));
+
+  // Rounding up from the largest finite value overflows to infinity
+  EXPECT_EQ(0x7BFFu, FloatToFloat16(65519.0f));
+  EXPECT_EQ(0x7C00u, FloatToFloat16(65520.0f));
+}
+
+TEST(Float16, NonFinite) {
+  EXPECT_EQ(0x7C00u,
+            FloatToFloat16(std::numeric_limits<float>::infinity()));
+  EXPECT_EQ(0xFC00u,
+            FloatToFloat16(-std::numeric_limits<float>::infinity()));
+  EXPECT_EQ(0x7C00u, FloatToFloat16(std::numeric_limits<float>::max()));
+  EXPECT_TRUE(std::isnan(Float16ToFloat(
+      FloatToFloat16(std::numeric_limits<float>::quiet_NaN()))));
+  EXPECT_TRUE(std::isinf(Float16ToFloat(0x7C00u)));
+}
+
+TEST(Float16, RoundTripsEveryValue) {
+  for (uint32_t bits = 0; bits <= 0xFFFFu; bits++) {
+    float value = Float16ToFloat(static_cast<uint16_t>(bits));
+    if (std::isnan(value)) {
+      continue;
+    }
+
+    EXPECT_EQ(bits, FloatToFloat16(value)) << bits;
+  }
+}
+
+TEST(BFloat16, Conversion) {
+  EXPECT_EQ(0x3F80u, FloatToBFloat16(1.0f));
+  EXPECT_EQ(0xC000u, FloatToBFloat16(-2.0f));
+  EXPECT_EQ(1.0f, BFloat16ToFloat(0x3F80u));
+
+  // Ties round to even
+  EXPECT_EQ(0x3F80u, FloatToBFloat16(1.0f + std::ldexp(1.0f, -8)));
+  EXPECT_EQ(0x3F82u, FloatToBFloat16(1.0f + 3.0f * std::ldexp(1.0f, -8)));
+
+  EXPECT_EQ(0x7F80u,
+            FloatToBFloat16(std::numeric_limits<float>::infinity()));
+  EXPECT_EQ(0x7F80u, FloatToBFloat16(std::numeric_limits<float>::max()));
+  EXPECT_TRUE(std::isnan(BFloat16ToFloat(
+      FloatToBFloat16(std::numeric_limits<float>::quiet_NaN()))));
+}
+
+TEST(BFloat16, RoundTripsEveryValue) {
+  for (uint32_t bits = 0; bits <= 0xFFFFu; bits++) {
+    float value = BFloat16ToFloat(static_cast<uint16_t>(bits));
+    if (std::isnan(value)) {
+      continue;
+    }
+
+    EXPECT_EQ(bits, FloatToBFloat16(value)) << bits;
+  }
+}
+
+TEST(FloatsToHalf, MatchesScalarConversion) {
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<float> exponent(-30.0f, 20.0f);
+  std::vector<float> values;
+  for (size_t i = 0; i < 1000; i++) {
+    float value = std::exp2(exponent(rng));
+    values.push_back(i % 2 == 0 ? value : -value);
+  }
+
+  // Covers every length of the scalar tail
+  for (size_t size : {0u, 1u, 7u, 8u, 9u, 15u, 1000u}) {
+    std::span<const float> input(values.data(), size);
+    std::vector<uint16_t> float16(size), bfloat16(size);
+    FloatsToFloat16(input, float16);
+    FloatsToBFloat16(input, bfloat16);
+
+    for (size_t i = 0; i < size; i++) {
+      EXPECT_EQ(FloatToFloat16(values[i]), float16[i]) << values[i];
+      EXPECT_EQ(FloatToBFloat16(values[i]), bfloat16[i]) << values[i];
+    }
+  }
+}
+
+}  // namespace
+}  // namespace libfbsdf
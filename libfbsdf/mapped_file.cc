@@ -0,0 +1,68 @@
+#include "libfbsdf/mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <string>
+#include <utility>
+
+namespace libfbsdf {
+
+std::expected<MappedFile, std::string> MappedFile::Open(
+    const std::filesystem::path& path) {
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return std::unexpected("Failed to open file");
+  }
+
+  struct stat file_status;
+  if (fstat(fd, &file_status) != 0) {
+    close(fd);
+    return std::unexpected("Failed to open file");
+  }
+
+  size_t size = static_cast<size_t>(file_status.st_size);
+  if (size == 0) {
+    close(fd);
+    return MappedFile(nullptr, 0);
+  }
+
+  void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+
+  if (data == MAP_FAILED) {
+    return std::unexpected("Failed to map file");
+  }
+
+  return MappedFile(static_cast<const std::byte*>(data), size);
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    if (data_ != nullptr) {
+      munmap(const_cast<std::byte*>(data_), size_);
+    }
+
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+  }
+
+  return *this;
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr) {
+    munmap(const_cast<std::byte*>(data_), size_);
+  }
+}
+
+}  // namespace libfbsdf
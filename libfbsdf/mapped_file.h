@@ -0,0 +1,39 @@
+#ifndef _LIBFBSDF_MAPPED_FILE_
+#define _LIBFBSDF_MAPPED_FILE_
+
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <span>
+#include <string>
+
+namespace libfbsdf {
+
+// A read-only memory mapping of the entire contents of a file. The mapping
+// remains valid for the lifetime of the object.
+//
+// NOTE: Only supported on POSIX systems
+class MappedFile final {
+ public:
+  static std::expected<MappedFile, std::string> Open(
+      const std::filesystem::path& path);
+
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+  ~MappedFile();
+
+  // The contents of the file. The data is aligned to at least a page boundary.
+  std::span<const std::byte> bytes() const {
+    return std::span<const std::byte>(data_, size_);
+  }
+
+ private:
+  MappedFile(const std::byte* data, size_t size) : data_(data), size_(size) {}
+
+  const std::byte* data_;
+  size_t size_;
+};
+
+}  // namespace libfbsdf
+
+#endif  // _LIBFBSDF_MAPPED_FILE_
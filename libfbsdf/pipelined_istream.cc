@@ -0,0 +1,121 @@
+#include "libfbsdf/pipelined_istream.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <ios>
+#include <istream>
+#include <mutex>
+#include <thread>
+
+namespace libfbsdf {
+
+PipelinedStreambuf::PipelinedStreambuf(std::istream& input, size_t num_blocks,
+                                       size_t block_size)
+    : input_(input), blocks_(num_blocks) {
+  for (Block& block : blocks_) {
+    block.data.resize(block_size);
+  }
+
+  producer_ = std::thread(&PipelinedStreambuf::Produce, this);
+}
+
+PipelinedStreambuf::~PipelinedStreambuf() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+
+  block_consumed_.notify_one();
+  producer_.join();
+}
+
+void PipelinedStreambuf::Produce() {
+  size_t next_block = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      block_consumed_.wait(lock, [&] {
+        return stopping_ || num_full_blocks_ < blocks_.size();
+      });
+
+      if (stopping_) {
+        return;
+      }
+    }
+
+    // The block is not visible to the consumer until it is counted as full so
+    // it can be filled without holding the lock.
+    Block& block = blocks_[next_block];
+    input_.read(block.data.data(), block.data.size());
+    block.size = static_cast<size_t>(input_.gcount());
+
+    bool finished = block.size != block.data.size();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (block.size != 0) {
+        num_full_blocks_ += 1;
+      }
+      finished_ = finished;
+    }
+
+    block_produced_.notify_one();
+
+    if (finished) {
+      return;
+    }
+
+    next_block = (next_block + 1) % blocks_.size();
+  }
+}
+
+PipelinedStreambuf::int_type PipelinedStreambuf::underflow() {
+  if (gptr() < egptr()) {
+    return traits_type::to_int_type(*gptr());
+  }
+
+  position_ += egptr() - eback();
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (consuming_block_) {
+    consuming_block_ = false;
+    first_full_block_ = (first_full_block_ + 1) % blocks_.size();
+    num_full_blocks_ -= 1;
+    block_consumed_.notify_one();
+  }
+
+  block_produced_.wait(lock,
+                       [&] { return finished_ || num_full_blocks_ != 0; });
+
+  if (num_full_blocks_ == 0) {
+    setg(nullptr, nullptr, nullptr);
+    return traits_type::eof();
+  }
+
+  consuming_block_ = true;
+  Block& block = blocks_[first_full_block_];
+  setg(block.data.data(), block.data.data(), block.data.data() + block.size);
+
+  return traits_type::to_int_type(*gptr());
+}
+
+PipelinedStreambuf::pos_type PipelinedStreambuf::seekoff(
+    off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) {
+  if (dir != std::ios_base::cur || !(which & std::ios_base::in) || off < 0) {
+    return pos_type(off_type(-1));
+  }
+
+  while (off != 0) {
+    if (gptr() == egptr() &&
+        traits_type::eq_int_type(underflow(), traits_type::eof())) {
+      return pos_type(off_type(-1));
+    }
+
+    off_type num_skipped = std::min(off, off_type(egptr() - gptr()));
+    gbump(static_cast<int>(num_skipped));
+    off -= num_skipped;
+  }
+
+  return pos_type(position_ + (gptr() - eback()));
+}
+
+}  // namespace libfbsdf
@@ -0,0 +1,85 @@
+#ifndef _LIBFBSDF_PIPELINED_ISTREAM_
+#define _LIBFBSDF_PIPELINED_ISTREAM_
+
+#include <condition_variable>
+#include <cstddef>
+#include <ios>
+#include <istream>
+#include <mutex>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+namespace libfbsdf {
+
+// A stream buffer that reads from an underlying stream on a background thread.
+// The background thread fills a bounded ring of fixed-size blocks ahead of the
+// consumer so that reading (and decompressing, if the underlying stream is a
+// `GzipIstream`) overlaps with parsing on the consuming thread.
+//
+// Seeking is only supported forwards relative to the current position, which
+// is sufficient for `BsdfReader` to skip over unparsed sections of an input.
+//
+// NOTE: The underlying stream must not be accessed by any other thread for the
+//       lifetime of this object.
+class PipelinedStreambuf final : public std::streambuf {
+ public:
+  static constexpr size_t kDefaultNumBlocks = 4u;
+  static constexpr size_t kDefaultBlockSize = 262144u;  // 256KB
+
+  // NOTE: Behavior is undefined if input is not a binary stream or if either
+  //       `num_blocks` or `block_size` is zero
+  explicit PipelinedStreambuf(std::istream& input,
+                              size_t num_blocks = kDefaultNumBlocks,
+                              size_t block_size = kDefaultBlockSize);
+  ~PipelinedStreambuf() override;
+
+ protected:
+  int_type underflow() override;
+
+  pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                   std::ios_base::openmode which) override;
+
+ private:
+  struct Block {
+    std::vector<char> data;
+    size_t size = 0;
+  };
+
+  void Produce();
+
+  std::istream& input_;
+  std::vector<Block> blocks_;
+  std::mutex mutex_;
+  std::condition_variable block_consumed_;
+  std::condition_variable block_produced_;
+  size_t first_full_block_ = 0;
+  size_t num_full_blocks_ = 0;
+  bool consuming_block_ = false;
+  bool finished_ = false;
+  bool stopping_ = false;
+  std::streamoff position_ = 0;
+  std::thread producer_;
+};
+
+// An input stream that reads ahead of its consumer on a background thread. For
+// example, wrapping a `GzipIstream` in a `PipelinedIstream` before passing it
+// to `BsdfReader::ReadFrom` moves decompression onto a second core.
+class PipelinedIstream final : public std::istream {
+ public:
+  // NOTE: Behavior is undefined if input is not a binary stream
+  explicit PipelinedIstream(
+      std::istream& input,
+      size_t num_blocks = PipelinedStreambuf::kDefaultNumBlocks,
+      size_t block_size = PipelinedStreambuf::kDefaultBlockSize)
+      : std::istream(nullptr), streambuf_(input, num_blocks, block_size) {
+    rdbuf(&streambuf_);
+  }
+
+ private:
+  PipelinedStreambuf streambuf_;
+};
+
+}  // namespace libfbsdf
+
+#endif  // _LIBFBSDF_PIPELINED_ISTREAM_
@@ -0,0 +1,143 @@
+#include "libfbsdf/pipelined_istream.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <fstream>
+#include <ios>
+#include <istream>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <sstream>
+#include <string>
+
+#include "googletest/include/gtest/gtest.h"
+#include "libfbsdf/bsdf_reader.h"
+#include "libfbsdf/gzip_istream.h"
+#include "test_data/test_data.h"
+
+namespace libfbsdf {
+namespace {
+
+using ::libfbsdf::testing::kTestDataFiles;
+using ::libfbsdf::testing::OpenTestData;
+
+std::string ReadAll(std::istream& input) {
+  return std::string((std::istreambuf_iterator<char>(input)),
+                     std::istreambuf_iterator<char>());
+}
+
+class CountingBsdfReader : public BsdfReader {
+ public:
+  std::expected<Options, std::string> Start(
+      const Flags& flags, size_t num_elevational_samples,
+      size_t num_basis_functions, size_t num_coefficients,
+      size_t num_color_channels, size_t longest_series_length,
+      size_t num_parameters, size_t num_parameter_values,
+      size_t metadata_size_bytes, float index_of_refraction,
+      float roughness_top, float roughness_bottom) override {
+    return options;
+  }
+
+  std::expected<void, std::string> HandleCoefficientChunk(
+      std::span<const float> values) override {
+    num_coefficients += values.size();
+    return std::expected<void, std::string>();
+  }
+
+  std::expected<void, std::string> HandleMetadata(std::string data) override {
+    metadata = std::move(data);
+    return std::expected<void, std::string>();
+  }
+
+  Options options;
+  size_t num_coefficients = 0;
+  std::string metadata;
+};
+
+TEST(PipelinedIstream, Empty) {
+  std::stringstream underlying("");
+  PipelinedIstream input(underlying);
+  EXPECT_EQ("", ReadAll(input));
+}
+
+TEST(PipelinedIstream, SmallBlocks) {
+  std::string contents = "The quick brown fox jumps over the lazy dog";
+  for (size_t num_blocks = 1; num_blocks < 4; num_blocks++) {
+    for (size_t block_size = 1; block_size < contents.size() + 2;
+         block_size++) {
+      std::stringstream underlying(contents);
+      PipelinedIstream input(underlying, num_blocks, block_size);
+      EXPECT_EQ(contents, ReadAll(input));
+    }
+  }
+}
+
+TEST(PipelinedIstream, SeeksForwards) {
+  std::string contents = "The quick brown fox jumps over the lazy dog";
+  std::stringstream underlying(contents);
+  PipelinedIstream input(underlying, 2, 4);
+
+  EXPECT_EQ(0, input.tellg());
+  ASSERT_TRUE(input.seekg(10, std::ios_base::cur));
+  EXPECT_EQ(10, input.tellg());
+  EXPECT_EQ('b', input.get());
+  EXPECT_FALSE(input.seekg(-1, std::ios_base::cur));
+}
+
+TEST(PipelinedIstream, SeekPastEndFails) {
+  std::string contents = "The quick brown fox jumps over the lazy dog";
+  std::stringstream underlying(contents);
+  PipelinedIstream input(underlying, 2, 4);
+  EXPECT_FALSE(input.seekg(contents.size() + 1, std::ios_base::cur));
+}
+
+TEST(PipelinedIstream, StopsEarly) {
+  std::string contents(1u << 20, 'a');
+  std::stringstream underlying(contents);
+  PipelinedIstream input(underlying, 2, 16);
+  EXPECT_EQ('a', input.get());
+}
+
+TEST(PipelinedIstream, ReadsCompressedTestData) {
+  for (const auto& [file_name, file_params] : kTestDataFiles) {
+    std::ifstream file(file_params.path, std::ios::in | std::ios::binary);
+    GzipIstream decompressed(file);
+    PipelinedIstream input(decompressed);
+
+    CountingBsdfReader reader;
+    EXPECT_TRUE(reader.ReadFrom(input)) << file_name;
+    EXPECT_EQ(file_params.num_coefficients, reader.num_coefficients);
+    EXPECT_EQ(file_params.metadata_size_bytes, reader.metadata.size());
+  }
+}
+
+TEST(PipelinedIstream, SkipsCompressedTestData) {
+  for (const auto& [file_name, file_params] : kTestDataFiles) {
+    std::ifstream file(file_params.path, std::ios::in | std::ios::binary);
+    GzipIstream decompressed(file);
+    PipelinedIstream input(decompressed);
+
+    CountingBsdfReader reader;
+    reader.options.parse_coefficients = false;
+    EXPECT_TRUE(reader.ReadFrom(input)) << file_name;
+    EXPECT_EQ(0u, reader.num_coefficients);
+    EXPECT_EQ(file_params.metadata_size_bytes, reader.metadata.size());
+  }
+}
+
+TEST(PipelinedIstream, MatchesTestData) {
+  for (const auto& [file_name, file_params] : kTestDataFiles) {
+    std::unique_ptr<std::istream> underlying = OpenTestData(file_name);
+    std::string expected = ReadAll(*underlying);
+
+    underlying->clear();
+    underlying->seekg(0);
+    PipelinedIstream input(*underlying, 3, 1000);
+    EXPECT_EQ(expected, ReadAll(input)) << file_name;
+  }
+}
+
+}  // namespace
+}  // namespace libfbsdf
@@ -0,0 +1,450 @@
+#include "libfbsdf/readers/bsdf_cache.h"
+
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <numeric>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "libfbsdf/aligned_vector.h"
+#include "libfbsdf/mapped_file.h"
+#include "libfbsdf/readers/elevational_guide.h"
+#include "libfbsdf/readers/series_repacking.h"
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+
+namespace libfbsdf {
+namespace {
+
+constexpr char kMagic[8] = {'F', 'B', 'S', 'D', 'F', 'C', '\0', '\0'};
+
+// Sections are aligned like the coefficient arrays so that a mapped cache
+// could be used in place
+constexpr size_t kSectionAlignment = kCoefficientAlignment;
+
+struct CacheHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t num_sections;
+  uint64_t source_checksum;
+  uint64_t series_padding;
+  double max_conversion_error;
+  float index_of_refraction;
+  float roughness_top;
+  float roughness_bottom;
+  float guide_lower_bound;
+  float guide_cells_per_unit;
+  uint8_t coefficient_format;
+  uint8_t interleaved_color_channels;
+  uint8_t reserved[2];
+};
+
+static_assert(sizeof(CacheHeader) == 64);
+
+enum class SectionId : uint32_t {
+  kElevationalSamples = 1,
+  kCdf = 2,
+  kYCoefficients = 3,
+  kRCoefficients = 4,
+  kBCoefficients = 5,
+  kYHalfCoefficients = 6,
+  kRHalfCoefficients = 7,
+  kBHalfCoefficients = 8,
+  kSeriesExtents = 9,  // Pairs of 64-bit offsets and lengths
+  kSeriesOffsets = 10,
+  kSeriesLengths = 11,
+  kSeriesScales = 12,
+  kElevationalGuide = 13,
+};
+
+struct CacheSection {
+  SectionId id;
+  uint32_t reserved;
+  uint64_t offset;
+  uint64_t size_bytes;
+};
+
+static_assert(sizeof(CacheSection) == 24);
+
+std::string UnexpectedEOF() { return "Unexpected EOF"; }
+
+uint64_t AlignSection(uint64_t offset) {
+  return (offset + kSectionAlignment - 1u) & ~(kSectionAlignment - 1u);
+}
+
+template <typename T, typename Allocator>
+std::span<const std::byte> AsBytes(const std::vector<T, Allocator>& values) {
+  return std::as_bytes(std::span<const T>(values));
+}
+
+// Copies the elements stored in `bytes` into `values`
+template <typename T, typename Allocator>
+std::expected<void, std::string> CopySection(
+    std::span<const std::byte> bytes, std::vector<T, Allocator>& values) {
+  if (bytes.size() % sizeof(T) != 0) {
+    return std::unexpected("A section of the BSDF cache has an invalid size");
+  }
+
+  values.resize(bytes.size() / sizeof(T));
+  if (!bytes.empty()) {
+    std::memcpy(values.data(), bytes.data(), bytes.size());
+  }
+
+  return std::expected<void, std::string>();
+}
+
+std::expected<void, std::string> CopySection(
+    SectionId id, std::span<const std::byte> bytes,
+    ReadFromStandardBsdfResult& result) {
+  switch (id) {
+    case SectionId::kElevationalSamples:
+      return CopySection(bytes, result.elevational_samples);
+    case SectionId::kCdf:
+      return CopySection(bytes, result.cdf);
+    case SectionId::kYCoefficients:
+      return CopySection(bytes, result.y_coefficients);
+    case SectionId::kRCoefficients:
+      return CopySection(bytes, result.r_coefficients);
+    case SectionId::kBCoefficients:
+      return CopySection(bytes, result.b_coefficients);
+    case SectionId::kYHalfCoefficients:
+      return CopySection(bytes, result.y_half_coefficients);
+    case SectionId::kRHalfCoefficients:
+      return CopySection(bytes, result.r_half_coefficients);
+    case SectionId::kBHalfCoefficients:
+      return CopySection(bytes, result.b_half_coefficients);
+    case SectionId::kSeriesExtents: {
+      std::vector<uint64_t> extents;
+      if (auto copied = CopySection(bytes, extents);
+          !copied || extents.size() % 2 != 0) {
+        return std::unexpected(
+            "A section of the BSDF cache has an invalid size");
+      }
+
+      result.series_extents.clear();
+      result.series_extents.reserve(extents.size() / 2);
+      for (size_t i = 0; i < extents.size(); i += 2) {
+        result.series_extents.emplace_back(extents[i], extents[i + 1]);
+      }
+      return std::expected<void, std::string>();
+    }
+    case SectionId::kSeriesOffsets:
+      return CopySection(bytes, result.series_offsets);
+    case SectionId::kSeriesLengths:
+      return CopySection(bytes, result.series_lengths);
+    case SectionId::kSeriesScales:
+      return CopySection(bytes, result.series_scales);
+    case SectionId::kElevationalGuide:
+      return CopySection(bytes, result.elevational_guide.intervals);
+  }
+
+  // Sections added by later versions are skipped
+  return std::expected<void, std::string>();
+}
+
+// Checks that every series of `bsdf` is aligned to its padding and lies within
+// its coefficients and that its arrays agree in size, which is all the
+// evaluators rely on
+std::expected<void, std::string> ValidateStructure(
+    const ReadFromStandardBsdfResult& bsdf) {
+  size_t num_samples = bsdf.elevational_samples.size();
+  if (num_samples < 2 || bsdf.cdf.size() != num_samples * num_samples) {
+    return std::unexpected(
+        "The BSDF cache has too few elevational samples or a CDF of the wrong "
+        "size");
+  }
+
+  bool is_compact = !bsdf.series_lengths.empty();
+  size_t num_series =
+      is_compact ? bsdf.series_lengths.size() : bsdf.series_extents.size();
+  if (num_series != num_samples * num_samples ||
+      (is_compact && (!bsdf.series_extents.empty() ||
+                      bsdf.series_offsets.size() != num_series)) ||
+      (!bsdf.series_scales.empty() &&
+       bsdf.series_scales.size() != num_series)) {
+    return std::unexpected("The BSDF cache has the wrong number of series");
+  }
+
+  bool is_half = bsdf.coefficient_format != CoefficientFormat::kFloat32;
+  size_t size =
+      is_half ? bsdf.y_half_coefficients.size() : bsdf.y_coefficients.size();
+  size_t r_size =
+      is_half ? bsdf.r_half_coefficients.size() : bsdf.r_coefficients.size();
+  size_t b_size =
+      is_half ? bsdf.b_half_coefficients.size() : bsdf.b_coefficients.size();
+  size_t other_size = is_half ? bsdf.y_coefficients.size() +
+                                    bsdf.r_coefficients.size() +
+                                    bsdf.b_coefficients.size()
+                              : bsdf.y_half_coefficients.size() +
+                                    bsdf.r_half_coefficients.size() +
+                                    bsdf.b_half_coefficients.size();
+  if (other_size != 0 || r_size != b_size ||
+      (r_size != 0 && (r_size != size || bsdf.interleaved_color_channels))) {
+    return std::unexpected(
+        "The coefficient arrays of the BSDF cache have mismatched sizes");
+  }
+
+  // Series padded for summation are loaded with aligned loads. Since padded
+  // lengths are multiples of the padding, every interleaved channel of a series
+  // is aligned if the series is.
+  size_t num_channels = bsdf.interleaved_color_channels ? 3u : 1u;
+  for (size_t index = 0; index < num_series; index++) {
+    auto [offset, length] = GetSeriesExtent(bsdf, index);
+    if (offset % bsdf.series_padding != 0) {
+      return std::unexpected(
+          "A series of the BSDF cache is not aligned to its padding");
+    }
+
+    if (length != 0 &&
+        (offset > size || length > size ||
+         GetPaddedSeriesLength(bsdf, length) >
+             (size - offset) / num_channels)) {
+      return std::unexpected(
+          "A series of the BSDF cache extends past its coefficients");
+    }
+  }
+
+  // The grid of the guide must cover the elevational samples with about as
+  // many cells as it has intervals
+  const ElevationalGuide& guide = bsdf.elevational_guide;
+  if (!guide.intervals.empty() &&
+      (!std::isfinite(guide.lower_bound) ||
+       !std::isfinite(guide.cells_per_unit) ||
+       !(static_cast<double>(guide.cells_per_unit) *
+             (static_cast<double>(bsdf.elevational_samples.back()) -
+              static_cast<double>(guide.lower_bound)) <=
+         2.0 * static_cast<double>(guide.intervals.size())))) {
+    return std::unexpected("The BSDF cache has an invalid elevational guide");
+  }
+
+  for (uint32_t interval : guide.intervals) {
+    if (static_cast<size_t>(interval) >= num_samples - 1) {
+      return std::unexpected(
+          "The BSDF cache has an invalid elevational guide");
+    }
+  }
+
+  return std::expected<void, std::string>();
+}
+
+}  // namespace
+
+uint64_t ChecksumBsdfSource(std::span<const std::byte> source) {
+  // FNV-1a applied to whole 64-bit words, then to the remaining bytes
+  constexpr uint64_t kPrime = 0x100000001B3u;
+  uint64_t hash = 0xCBF29CE484222325u ^ source.size();
+  size_t i = 0;
+  for (; source.size() - i >= sizeof(uint64_t); i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, source.data() + i, sizeof(word));
+    hash = (hash ^ word) * kPrime;
+  }
+
+  for (; i < source.size(); i++) {
+    hash = (hash ^ static_cast<uint64_t>(source[i])) * kPrime;
+  }
+
+  // Multiplication only carries upwards, so the high bits are mixed back down
+  return hash ^ (hash >> 32);
+}
+
+std::expected<void, std::string> WriteBsdfCache(
+    const ReadFromStandardBsdfResult& bsdf, uint64_t source_checksum,
+    std::ostream& output) {
+  if constexpr (std::endian::native != std::endian::little) {
+    return std::unexpected("Caches are only supported on little-endian hosts");
+  }
+
+  // Coefficients shared with other BSDFs hold their series as well, so only
+  // the series of `bsdf` are copied out of them to be written
+  if (bsdf.shared_coefficients) {
+    size_t num_series = bsdf.series_lengths.empty()
+                            ? bsdf.series_extents.size()
+                            : bsdf.series_lengths.size();
+    std::vector<size_t> sources(num_series);
+    std::iota(sources.begin(), sources.end(), 0u);
+    std::vector<size_t> lengths(num_series);
+    for (size_t index = 0; index < num_series; index++) {
+      lengths[index] = GetSeriesExtent(bsdf, index).second;
+    }
+
+    ReadFromStandardBsdfResult unshared = bsdf;
+    RepackSeries(unshared, sources, lengths, GetChannelArrays(bsdf),
+                 GetChannelArrays(unshared));
+    unshared.shared_coefficients.reset();
+
+    return WriteBsdfCache(unshared, source_checksum, output);
+  }
+
+  std::vector<uint64_t> extents;
+  extents.reserve(2 * bsdf.series_extents.size());
+  for (auto [offset, length] : bsdf.series_extents) {
+    extents.push_back(offset);
+    extents.push_back(length);
+  }
+
+  std::pair<SectionId, std::span<const std::byte>> contents[] = {
+      {SectionId::kElevationalSamples, AsBytes(bsdf.elevational_samples)},
+      {SectionId::kCdf, AsBytes(bsdf.cdf)},
+      {SectionId::kYCoefficients, AsBytes(GetYCoefficients(bsdf))},
+      {SectionId::kRCoefficients, AsBytes(GetRCoefficients(bsdf))},
+      {SectionId::kBCoefficients, AsBytes(GetBCoefficients(bsdf))},
+      {SectionId::kYHalfCoefficients, AsBytes(bsdf.y_half_coefficients)},
+      {SectionId::kRHalfCoefficients, AsBytes(bsdf.r_half_coefficients)},
+      {SectionId::kBHalfCoefficients, AsBytes(bsdf.b_half_coefficients)},
+      {SectionId::kSeriesExtents, AsBytes(extents)},
+      {SectionId::kSeriesOffsets, AsBytes(bsdf.series_offsets)},
+      {SectionId::kSeriesLengths, AsBytes(bsdf.series_lengths)},
+      {SectionId::kSeriesScales, AsBytes(bsdf.series_scales)},
+      {SectionId::kElevationalGuide,
+       AsBytes(bsdf.elevational_guide.intervals)},
+  };
+
+  // Empty sections are left out of the table
+  std::vector<CacheSection> sections;
+  std::vector<std::span<const std::byte>> section_bytes;
+  for (const auto& [id, bytes] : contents) {
+    if (!bytes.empty()) {
+      sections.push_back({id, 0, 0, bytes.size()});
+      section_bytes.push_back(bytes);
+    }
+  }
+
+  uint64_t offset =
+      sizeof(CacheHeader) + sections.size() * sizeof(CacheSection);
+  for (CacheSection& section : sections) {
+    section.offset = AlignSection(offset);
+    offset = section.offset + section.size_bytes;
+  }
+
+  CacheHeader header = {};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kBsdfCacheVersion;
+  header.num_sections = static_cast<uint32_t>(sections.size());
+  header.source_checksum = source_checksum;
+  header.series_padding = bsdf.series_padding;
+  header.max_conversion_error = bsdf.max_conversion_error;
+  header.index_of_refraction = bsdf.index_of_refraction;
+  header.roughness_top = bsdf.roughness_top;
+  header.roughness_bottom = bsdf.roughness_bottom;
+  header.guide_lower_bound = bsdf.elevational_guide.lower_bound;
+  header.guide_cells_per_unit = bsdf.elevational_guide.cells_per_unit;
+  header.coefficient_format = static_cast<uint8_t>(bsdf.coefficient_format);
+  header.interleaved_color_channels = bsdf.interleaved_color_channels;
+
+  output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  output.write(reinterpret_cast<const char*>(sections.data()),
+               static_cast<std::streamsize>(sections.size() *
+                                            sizeof(CacheSection)));
+
+  offset = sizeof(CacheHeader) + sections.size() * sizeof(CacheSection);
+  const char padding[kSectionAlignment] = {};
+  for (size_t i = 0; i < sections.size(); i++) {
+    output.write(padding,
+                 static_cast<std::streamsize>(sections[i].offset - offset));
+    output.write(reinterpret_cast<const char*>(section_bytes[i].data()),
+                 static_cast<std::streamsize>(section_bytes[i].size()));
+    offset = sections[i].offset + sections[i].size_bytes;
+  }
+
+  if (!output) {
+    return std::unexpected("Failed to write the BSDF cache");
+  }
+
+  return std::expected<void, std::string>();
+}
+
+std::expected<ReadFromStandardBsdfResult, std::string> ReadBsdfCache(
+    std::span<const std::byte> input, std::optional<uint64_t> source_checksum) {
+  if constexpr (std::endian::native != std::endian::little) {
+    return std::unexpected("Caches are only supported on little-endian hosts");
+  }
+
+  CacheHeader header;
+  if (input.size() < sizeof(header)) {
+    return std::unexpected(UnexpectedEOF());
+  }
+  std::memcpy(&header, input.data(), sizeof(header));
+
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+    return std::unexpected("The input is not a BSDF cache");
+  }
+
+  if (header.version != kBsdfCacheVersion) {
+    return std::unexpected("Unsupported BSDF cache version");
+  }
+
+  if (source_checksum && header.source_checksum != *source_checksum) {
+    return std::unexpected("The BSDF cache was written for a different source");
+  }
+
+  if (header.coefficient_format >
+          static_cast<uint8_t>(CoefficientFormat::kBFloat16) ||
+      header.interleaved_color_channels > 1 || header.series_padding == 0 ||
+      !std::has_single_bit(header.series_padding) ||
+      header.series_padding > kMaxSeriesPadding) {
+    return std::unexpected("The BSDF cache has an invalid header");
+  }
+
+  if ((input.size() - sizeof(header)) / sizeof(CacheSection) <
+      header.num_sections) {
+    return std::unexpected(UnexpectedEOF());
+  }
+
+  ReadFromStandardBsdfResult result;
+  result.series_padding = static_cast<size_t>(header.series_padding);
+  result.interleaved_color_channels = header.interleaved_color_channels != 0;
+  result.coefficient_format =
+      static_cast<CoefficientFormat>(header.coefficient_format);
+  result.max_conversion_error = header.max_conversion_error;
+  result.elevational_guide.lower_bound = header.guide_lower_bound;
+  result.elevational_guide.cells_per_unit = header.guide_cells_per_unit;
+  result.index_of_refraction = header.index_of_refraction;
+  result.roughness_top = header.roughness_top;
+  result.roughness_bottom = header.roughness_bottom;
+
+  for (size_t i = 0; i < header.num_sections; i++) {
+    CacheSection section;
+    std::memcpy(&section,
+                input.data() + sizeof(header) + i * sizeof(CacheSection),
+                sizeof(section));
+    if (section.offset > input.size() ||
+        section.size_bytes > input.size() - section.offset) {
+      return std::unexpected(UnexpectedEOF());
+    }
+
+    if (auto copied = CopySection(
+            section.id, input.subspan(section.offset, section.size_bytes),
+            result);
+        !copied) {
+      return std::unexpected(copied.error());
+    }
+  }
+
+  if (auto valid = ValidateStructure(result); !valid) {
+    return std::unexpected(valid.error());
+  }
+
+  return result;
+}
+
+std::expected<ReadFromStandardBsdfResult, std::string> ReadBsdfCache(
+    const std::filesystem::path& path,
+    std::optional<uint64_t> source_checksum) {
+  auto file = MappedFile::Open(path);
+  if (!file) {
+    return std::unexpected(file.error());
+  }
+
+  return ReadBsdfCache(file->bytes(), source_checksum);
+}
+
+}  // namespace libfbsdf
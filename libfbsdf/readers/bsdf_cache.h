@@ -0,0 +1,59 @@
+#ifndef _LIBFBSDF_READERS_BSDF_CACHE_
+#define _LIBFBSDF_READERS_BSDF_CACHE_
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+
+namespace libfbsdf {
+
+// The version of the cache format written by `WriteBsdfCache`. Caches written
+// with any other version are rejected by `ReadBsdfCache`.
+inline constexpr uint32_t kBsdfCacheVersion = 1;
+
+// Returns a 64-bit hash of `source`, the contents of the input a BSDF was read
+// from, for recording in a cache so that caches of inputs that have since
+// changed can be detected. Not suitable for detecting deliberate tampering.
+uint64_t ChecksumBsdfSource(std::span<const std::byte> source);
+
+// Writes `bsdf` to `output` in a native binary format (conventionally with the
+// extension ".fbsdfc") that `ReadBsdfCache` can load without any parsing or
+// validation of the coefficients. The file consists of a header holding the
+// version, `source_checksum`, and the scalar fields of `bsdf`, followed by a
+// table of the sections holding each of its arrays in the layout and format
+// they are stored in. Each section starts on a 64 byte boundary. If `bsdf`
+// shares its coefficients with other BSDFs, only the coefficients of its own
+// series are written, repacked as by `TruncateSeries`, so the BSDF read back
+// from the cache holds its own copy of them.
+//
+// NOTE: Caches are only written and read on little-endian hosts
+std::expected<void, std::string> WriteBsdfCache(
+    const ReadFromStandardBsdfResult& bsdf, uint64_t source_checksum,
+    std::ostream& output);
+
+// Reads a BSDF written by `WriteBsdfCache` from `input`, copying each section
+// directly into the corresponding array of the result. Only the structure of
+// the cache is checked: that its header and sections are complete and that
+// every series starts at a multiple of the series padding and lies within the
+// coefficients, so that the result is safe to evaluate. If `source_checksum`
+// is provided, caches written with a different checksum are rejected as stale.
+std::expected<ReadFromStandardBsdfResult, std::string> ReadBsdfCache(
+    std::span<const std::byte> input,
+    std::optional<uint64_t> source_checksum = std::nullopt);
+
+// As above, but maps the cache file at `path` into memory with `MappedFile` to
+// read it.
+std::expected<ReadFromStandardBsdfResult, std::string> ReadBsdfCache(
+    const std::filesystem::path& path,
+    std::optional<uint64_t> source_checksum = std::nullopt);
+
+}  // namespace libfbsdf
+
+#endif  // _LIBFBSDF_READERS_BSDF_CACHE_
@@ -0,0 +1,383 @@
+#include "libfbsdf/readers/bsdf_cache.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <set>
+#include <span>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "googletest/include/gtest/gtest.h"
+#include "libfbsdf/aligned_vector.h"
+#include "libfbsdf/readers/reciprocal_series.h"
+#include "libfbsdf/readers/series_deduplication.h"
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+#include "test_data/test_data.h"
+
+namespace libfbsdf {
+namespace {
+
+using ::libfbsdf::testing::kTestDataFiles;
+using ::libfbsdf::testing::OpenTestData;
+
+std::string WriteCache(const ReadFromStandardBsdfResult& bsdf,
+                       uint64_t source_checksum = 0) {
+  std::ostringstream output;
+  auto written = WriteBsdfCache(bsdf, source_checksum, output);
+  EXPECT_TRUE(written) << written.error();
+  return std::move(output).str();
+}
+
+std::span<const std::byte> AsBytes(const std::string& contents) {
+  return std::as_bytes(std::span<const char>(contents));
+}
+
+void ExpectSameBsdf(const ReadFromStandardBsdfResult& expected,
+                    const ReadFromStandardBsdfResult& bsdf) {
+  EXPECT_EQ(expected.elevational_samples, bsdf.elevational_samples);
+  EXPECT_EQ(expected.cdf, bsdf.cdf);
+  EXPECT_EQ(GetYCoefficients(expected), bsdf.y_coefficients);
+  EXPECT_EQ(GetRCoefficients(expected), bsdf.r_coefficients);
+  EXPECT_EQ(GetBCoefficients(expected), bsdf.b_coefficients);
+  EXPECT_EQ(expected.series_padding, bsdf.series_padding);
+  EXPECT_EQ(expected.interleaved_color_channels,
+            bsdf.interleaved_color_channels);
+  EXPECT_EQ(expected.coefficient_format, bsdf.coefficient_format);
+  EXPECT_EQ(expected.y_half_coefficients, bsdf.y_half_coefficients);
+  EXPECT_EQ(expected.r_half_coefficients, bsdf.r_half_coefficients);
+  EXPECT_EQ(expected.b_half_coefficients, bsdf.b_half_coefficients);
+  EXPECT_EQ(expected.max_conversion_error, bsdf.max_conversion_error);
+  EXPECT_FALSE(bsdf.shared_coefficients);
+  EXPECT_EQ(expected.series_extents, bsdf.series_extents);
+  EXPECT_EQ(expected.series_offsets, bsdf.series_offsets);
+  EXPECT_EQ(expected.series_lengths, bsdf.series_lengths);
+  EXPECT_EQ(expected.series_scales, bsdf.series_scales);
+  EXPECT_EQ(expected.elevational_guide.intervals,
+            bsdf.elevational_guide.intervals);
+  if (!expected.elevational_guide.intervals.empty()) {
+    EXPECT_EQ(expected.elevational_guide.lower_bound,
+              bsdf.elevational_guide.lower_bound);
+    EXPECT_EQ(expected.elevational_guide.cells_per_unit,
+              bsdf.elevational_guide.cells_per_unit);
+  }
+  EXPECT_EQ(expected.index_of_refraction, bsdf.index_of_refraction);
+  EXPECT_EQ(expected.roughness_top, bsdf.roughness_top);
+  EXPECT_EQ(expected.roughness_bottom, bsdf.roughness_bottom);
+}
+
+ReadFromStandardBsdfResult ReadPaint() {
+  auto bsdf = ReadFromStandardBsdf(*OpenTestData("paint"));
+  EXPECT_TRUE(bsdf) << bsdf.error();
+  return std::move(bsdf).value();
+}
+
+TEST(ChecksumBsdfSource, DetectsChanges) {
+  std::string source = "0123456789abcdefghij";
+  uint64_t checksum = ChecksumBsdfSource(AsBytes(source));
+  EXPECT_EQ(checksum, ChecksumBsdfSource(AsBytes(source)));
+
+  for (size_t i = 0; i < source.size(); i++) {
+    std::string changed = source;
+    changed[i] ^= 0x80;
+    EXPECT_NE(checksum, ChecksumBsdfSource(AsBytes(changed))) << i;
+  }
+
+  EXPECT_NE(checksum, ChecksumBsdfSource(AsBytes(source + '\0')));
+  EXPECT_NE(checksum, ChecksumBsdfSource(AsBytes(source.substr(1))));
+}
+
+TEST(BsdfCache, TestData) {
+  for (const auto& [name, file_params] : kTestDataFiles) {
+    SCOPED_TRACE(name);
+    for (ReadFromStandardBsdfOptions options :
+         {ReadFromStandardBsdfOptions{},
+          ReadFromStandardBsdfOptions{.build_elevational_guide = true,
+                                      .compact_series_extents = true},
+          ReadFromStandardBsdfOptions{.series_padding = 4,
+                                      .interleave_color_channels = true},
+          ReadFromStandardBsdfOptions{
+              .luminance_only = true,
+              .series_padding = 8,
+              .coefficient_format = CoefficientFormat::kFloat16},
+          ReadFromStandardBsdfOptions{
+              .compact_series_extents = true,
+              .coefficient_format = CoefficientFormat::kBFloat16}}) {
+      auto expected = ReadFromStandardBsdf(*OpenTestData(name), options);
+      ASSERT_TRUE(expected) << expected.error();
+
+      std::string cache = WriteCache(*expected, 7);
+      auto bsdf = ReadBsdfCache(AsBytes(cache), 7);
+      ASSERT_TRUE(bsdf) << bsdf.error();
+      ExpectSameBsdf(*expected, *bsdf);
+    }
+  }
+}
+
+TEST(BsdfCache, FoldedAndSharedSeries) {
+  ReadFromStandardBsdfResult leather;
+  {
+    auto bsdf = ReadFromStandardBsdf(*OpenTestData("leather"));
+    ASSERT_TRUE(bsdf) << bsdf.error();
+    leather = std::move(bsdf).value();
+  }
+  ReadFromStandardBsdfResult paint = ReadPaint();
+
+  auto folded = FoldReciprocalSeries(paint, 1e-3);
+  ASSERT_TRUE(folded) << folded.error();
+  ASSERT_GT(folded->num_series_folded, 0u);
+
+  ReadFromStandardBsdfResult* bsdfs[] = {&leather, &paint};
+  auto deduplicated = DeduplicateSeries(bsdfs);
+  ASSERT_TRUE(deduplicated) << deduplicated.error();
+
+  // Only the series of each BSDF are written out of the shared coefficients
+  for (const ReadFromStandardBsdfResult* expected : bsdfs) {
+    std::string cache = WriteCache(*expected);
+    auto bsdf = ReadBsdfCache(AsBytes(cache));
+    ASSERT_TRUE(bsdf) << bsdf.error();
+    EXPECT_FALSE(bsdf->shared_coefficients);
+    EXPECT_EQ(expected->cdf, bsdf->cdf);
+    EXPECT_EQ(expected->series_scales, bsdf->series_scales);
+    ASSERT_EQ(expected->series_extents.size(), bsdf->series_extents.size());
+
+    auto series = [](const AlignedVector<float>& coefficients,
+                     std::pair<size_t, size_t> extent) {
+      return std::vector<float>(
+          coefficients.begin() + extent.first,
+          coefficients.begin() + extent.first + extent.second);
+    };
+
+    std::set<std::pair<size_t, size_t>> extents;
+    for (size_t index = 0; index < bsdf->series_extents.size(); index++) {
+      std::pair<size_t, size_t> expected_extent =
+          expected->series_extents[index];
+      std::pair<size_t, size_t> extent = bsdf->series_extents[index];
+      ASSERT_EQ(expected_extent.second, extent.second);
+      EXPECT_EQ(series(GetYCoefficients(*expected), expected_extent),
+                series(bsdf->y_coefficients, extent));
+      EXPECT_EQ(series(GetRCoefficients(*expected), expected_extent),
+                series(bsdf->r_coefficients, extent));
+      EXPECT_EQ(series(GetBCoefficients(*expected), expected_extent),
+                series(bsdf->b_coefficients, extent));
+      extents.insert(expected_extent);
+    }
+
+    size_t num_coefficients = 0;
+    for (auto [offset, length] : extents) {
+      num_coefficients += length;
+    }
+    EXPECT_EQ(num_coefficients, bsdf->y_coefficients.size());
+    EXPECT_LT(num_coefficients, GetYCoefficients(*expected).size());
+  }
+}
+
+TEST(BsdfCache, SectionsAreAligned) {
+  std::string cache = WriteCache(ReadPaint());
+
+  // The header holds the number of sections after the magic and version, and
+  // is followed by a table of 24 byte entries holding the offset of each
+  uint32_t num_sections;
+  std::memcpy(&num_sections, cache.data() + 12, sizeof(num_sections));
+  ASSERT_GT(num_sections, 0u);
+  for (size_t i = 0; i < num_sections; i++) {
+    uint64_t offset;
+    std::memcpy(&offset, cache.data() + 64 + 24 * i + 8, sizeof(offset));
+    EXPECT_EQ(0u, offset % 64u) << i;
+  }
+}
+
+TEST(BsdfCache, File) {
+  std::filesystem::path path =
+      std::filesystem::temp_directory_path() / "bsdf_cache_test.fbsdfc";
+  ReadFromStandardBsdfResult expected = ReadPaint();
+  std::ofstream(path, std::ios::out | std::ios::binary) << WriteCache(expected);
+
+  auto bsdf = ReadBsdfCache(path);
+  ASSERT_TRUE(bsdf) << bsdf.error();
+  ExpectSameBsdf(expected, *bsdf);
+
+  std::filesystem::remove(path);
+}
+
+TEST(BsdfCache, MissingFile) {
+  auto bsdf = ReadBsdfCache(std::filesystem::path("notarealfile.fbsdfc"));
+  ASSERT_FALSE(bsdf);
+  EXPECT_EQ("Failed to open file", bsdf.error());
+}
+
+TEST(BsdfCache, WriteFails) {
+  std::ostringstream output;
+  output.setstate(std::ios::badbit);
+  auto written = WriteBsdfCache(ReadPaint(), 0, output);
+  ASSERT_FALSE(written);
+  EXPECT_EQ("Failed to write the BSDF cache", written.error());
+}
+
+TEST(BsdfCache, BadMagic) {
+  std::string cache = WriteCache(ReadPaint());
+  cache[0] = 'X';
+
+  auto bsdf = ReadBsdfCache(AsBytes(cache));
+  ASSERT_FALSE(bsdf);
+  EXPECT_EQ("The input is not a BSDF cache", bsdf.error());
+}
+
+TEST(BsdfCache, BadVersion) {
+  std::string cache = WriteCache(ReadPaint());
+  uint32_t version = kBsdfCacheVersion + 1;
+  std::memcpy(cache.data() + 8, &version, sizeof(version));
+
+  auto bsdf = ReadBsdfCache(AsBytes(cache));
+  ASSERT_FALSE(bsdf);
+  EXPECT_EQ("Unsupported BSDF cache version", bsdf.error());
+}
+
+TEST(BsdfCache, SeriesPaddingTooLarge) {
+  for (size_t series_padding : {2u * kMaxSeriesPadding, size_t{1} << 62}) {
+    ReadFromStandardBsdfResult expected = ReadPaint();
+    expected.series_padding = series_padding;
+
+    auto bsdf = ReadBsdfCache(AsBytes(WriteCache(expected)));
+    ASSERT_FALSE(bsdf) << series_padding;
+    EXPECT_EQ("The BSDF cache has an invalid header", bsdf.error());
+  }
+}
+
+TEST(BsdfCache, StaleChecksum) {
+  std::string cache = WriteCache(ReadPaint(), 1);
+
+  EXPECT_TRUE(ReadBsdfCache(AsBytes(cache)));
+  auto bsdf = ReadBsdfCache(AsBytes(cache), 2);
+  ASSERT_FALSE(bsdf);
+  EXPECT_EQ("The BSDF cache was written for a different source", bsdf.error());
+}
+
+TEST(BsdfCache, Truncated) {
+  std::string cache = WriteCache(ReadPaint());
+  for (size_t size : {size_t(0), size_t(63), size_t(80), cache.size() - 1}) {
+    auto bsdf = ReadBsdfCache(AsBytes(cache).first(size));
+    ASSERT_FALSE(bsdf) << size;
+    EXPECT_EQ("Unexpected EOF", bsdf.error()) << size;
+  }
+}
+
+TEST(BsdfCache, SeriesPastCoefficients) {
+  ReadFromStandardBsdfResult expected = ReadPaint();
+  expected.series_extents.back().second = expected.y_coefficients.size();
+
+  auto bsdf = ReadBsdfCache(AsBytes(WriteCache(expected)));
+  ASSERT_FALSE(bsdf);
+  EXPECT_EQ("A series of the BSDF cache extends past its coefficients",
+            bsdf.error());
+}
+
+TEST(BsdfCache, UnalignedSeries) {
+  for (bool interleave_color_channels : {false, true}) {
+    auto expected = ReadFromStandardBsdf(
+        *OpenTestData("paint"),
+        {.series_padding = 4,
+         .interleave_color_channels = interleave_color_channels});
+    ASSERT_TRUE(expected) << expected.error();
+    auto series = std::find_if(
+        expected->series_extents.begin(), expected->series_extents.end(),
+        [](const auto& extent) { return extent.second != 0; });
+    ASSERT_NE(expected->series_extents.end(), series);
+    series->first += 1;
+
+    auto bsdf = ReadBsdfCache(AsBytes(WriteCache(*expected)));
+    ASSERT_FALSE(bsdf) << interleave_color_channels;
+    EXPECT_EQ("A series of the BSDF cache is not aligned to its padding",
+              bsdf.error());
+  }
+}
+
+TEST(BsdfCache, MismatchedCoefficients) {
+  ReadFromStandardBsdfResult expected = ReadPaint();
+  expected.r_coefficients.pop_back();
+
+  auto bsdf = ReadBsdfCache(AsBytes(WriteCache(expected)));
+  ASSERT_FALSE(bsdf);
+  EXPECT_EQ("The coefficient arrays of the BSDF cache have mismatched sizes",
+            bsdf.error());
+}
+
+TEST(BsdfCache, WrongNumberOfSeries) {
+  ReadFromStandardBsdfResult expected = ReadPaint();
+  expected.series_extents.pop_back();
+
+  auto bsdf = ReadBsdfCache(AsBytes(WriteCache(expected)));
+  ASSERT_FALSE(bsdf);
+  EXPECT_EQ("The BSDF cache has the wrong number of series", bsdf.error());
+}
+
+TEST(BsdfCache, InvalidElevationalGuide) {
+  auto expected = ReadFromStandardBsdf(*OpenTestData("paint"),
+                                       {.build_elevational_guide = true});
+  ASSERT_TRUE(expected) << expected.error();
+  expected->elevational_guide.intervals.back() =
+      static_cast<uint32_t>(expected->elevational_samples.size() - 1);
+
+  auto bsdf = ReadBsdfCache(AsBytes(WriteCache(*expected)));
+  ASSERT_FALSE(bsdf);
+  EXPECT_EQ("The BSDF cache has an invalid elevational guide", bsdf.error());
+}
+
+TEST(BsdfCache, CorruptElevationalGuide) {
+  auto expected = ReadFromStandardBsdf(*OpenTestData("leather"),
+                                       {.build_elevational_guide = true});
+  ASSERT_TRUE(expected) << expected.error();
+  std::string cache = WriteCache(*expected);
+
+  // Intervals near the top of the 32-bit range must not wrap past the check
+  for (uint32_t interval : {0xFFFFFFFEu, 0xFFFFFFFFu}) {
+    std::string corrupt = cache;
+    size_t offset = corrupt.rfind(std::string(
+        reinterpret_cast<const char*>(
+            expected->elevational_guide.intervals.data()),
+        expected->elevational_guide.intervals.size() * sizeof(uint32_t)));
+    ASSERT_NE(std::string::npos, offset);
+    std::memcpy(corrupt.data() + offset, &interval, sizeof(interval));
+
+    auto bsdf = ReadBsdfCache(AsBytes(corrupt));
+    ASSERT_FALSE(bsdf) << interval;
+    EXPECT_EQ("The BSDF cache has an invalid elevational guide", bsdf.error());
+  }
+
+  for (float bound : {std::numeric_limits<float>::quiet_NaN(),
+                      std::numeric_limits<float>::infinity()}) {
+    ReadFromStandardBsdfResult corrupt = *expected;
+    corrupt.elevational_guide.cells_per_unit = bound;
+    auto bsdf = ReadBsdfCache(AsBytes(WriteCache(corrupt)));
+    ASSERT_FALSE(bsdf) << bound;
+    EXPECT_EQ("The BSDF cache has an invalid elevational guide", bsdf.error());
+
+    corrupt = *expected;
+    corrupt.elevational_guide.lower_bound = bound;
+    bsdf = ReadBsdfCache(AsBytes(WriteCache(corrupt)));
+    ASSERT_FALSE(bsdf) << bound;
+    EXPECT_EQ("The BSDF cache has an invalid elevational guide", bsdf.error());
+  }
+
+  // Finite grids far larger than their intervals would index past size_t
+  ReadFromStandardBsdfResult corrupt = *expected;
+  corrupt.elevational_guide.cells_per_unit = 1e30f;
+  auto bsdf = ReadBsdfCache(AsBytes(WriteCache(corrupt)));
+  ASSERT_FALSE(bsdf);
+  EXPECT_EQ("The BSDF cache has an invalid elevational guide", bsdf.error());
+
+  corrupt = *expected;
+  corrupt.elevational_guide.lower_bound = -1e30f;
+  bsdf = ReadBsdfCache(AsBytes(WriteCache(corrupt)));
+  ASSERT_FALSE(bsdf);
+  EXPECT_EQ("The BSDF cache has an invalid elevational guide", bsdf.error());
+}
+
+}  // namespace
+}  // namespace libfbsdf
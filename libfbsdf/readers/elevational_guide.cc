@@ -0,0 +1,68 @@
+#include "libfbsdf/readers/elevational_guide.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace libfbsdf {
+namespace {
+
+// The elevational samples of BSDFs are typically packed more densely towards
+// the ends of their range, so the grid has several cells for each sample
+constexpr size_t kCellsPerSample = 4;
+
+size_t SearchElevationalInterval(std::span<const float> elevational_samples,
+                                 float value) {
+  size_t index = std::upper_bound(elevational_samples.begin(),
+                                  elevational_samples.end(), value) -
+                 elevational_samples.begin();
+  return std::min(index == 0 ? 0 : index - 1, elevational_samples.size() - 2);
+}
+
+}  // namespace
+
+ElevationalGuide BuildElevationalGuide(
+    std::span<const float> elevational_samples) {
+  size_t num_cells = kCellsPerSample * elevational_samples.size();
+
+  ElevationalGuide guide;
+  guide.lower_bound = elevational_samples.front();
+  guide.cells_per_unit = static_cast<float>(num_cells) /
+                         (elevational_samples.back() - guide.lower_bound);
+  guide.intervals.reserve(num_cells);
+  for (size_t cell = 0; cell < num_cells; cell++) {
+    float cell_lower_bound =
+        guide.lower_bound + static_cast<float>(cell) / guide.cells_per_unit;
+    guide.intervals.push_back(static_cast<uint32_t>(
+        SearchElevationalInterval(elevational_samples, cell_lower_bound)));
+  }
+
+  return guide;
+}
+
+size_t FindElevationalInterval(std::span<const float> elevational_samples,
+                               const ElevationalGuide& guide, float value) {
+  // The cell is clamped before it is converted since a malformed guide can
+  // place `value` far outside of the range of `size_t`
+  float cell = std::clamp((value - guide.lower_bound) * guide.cells_per_unit,
+                          0.0f, static_cast<float>(guide.intervals.size()));
+  size_t index = guide.intervals[std::min(static_cast<size_t>(cell),
+                                          guide.intervals.size() - 1)];
+
+  // Rounding in the computation of `cell` can land `value` in a neighbouring
+  // cell, so the scan may also need to step backwards
+  size_t last_interval = elevational_samples.size() - 2;
+  while (index < last_interval && elevational_samples[index + 1] <= value) {
+    index += 1;
+  }
+
+  while (index > 0 && value < elevational_samples[index]) {
+    index -= 1;
+  }
+
+  return index;
+}
+
+}  // namespace libfbsdf
@@ -0,0 +1,39 @@
+#ifndef _LIBFBSDF_READERS_ELEVATIONAL_GUIDE_
+#define _LIBFBSDF_READERS_ELEVATIONAL_GUIDE_
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace libfbsdf {
+
+// A uniform grid over the range of the elevational samples of a BSDF that
+// maps the cosine of an elevation angle to the interval between elevational
+// samples that contains it in constant time. Each cell of the grid stores the
+// interval containing the lower bound of the cell so that the interval
+// containing any value in the cell is found with a short linear scan.
+//
+// A default constructed guide is empty and cannot be used for lookups.
+struct ElevationalGuide {
+  float lower_bound;
+  float cells_per_unit;
+  std::vector<uint32_t> intervals;
+};
+
+// Builds the guide for `elevational_samples` which must be sorted and contain
+// at least two samples. The grid is sized so that most cells overlap at most
+// a couple of intervals.
+ElevationalGuide BuildElevationalGuide(
+    std::span<const float> elevational_samples);
+
+// Returns the index `i` of the interval from `elevational_samples[i]` to
+// `elevational_samples[i + 1]` that contains `value`, which must be within the
+// range of `elevational_samples`. Values equal to an interior elevational
+// sample belong to the interval that starts at it.
+size_t FindElevationalInterval(std::span<const float> elevational_samples,
+                               const ElevationalGuide& guide, float value);
+
+}  // namespace libfbsdf
+
+#endif  // _LIBFBSDF_READERS_ELEVATIONAL_GUIDE_
@@ -0,0 +1,81 @@
+#include "libfbsdf/readers/elevational_guide.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "googletest/include/gtest/gtest.h"
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+#include "test_data/test_data.h"
+
+namespace libfbsdf {
+namespace {
+
+using ::libfbsdf::testing::OpenTestData;
+
+size_t BinarySearch(std::span<const float> samples, float value) {
+  size_t index = std::upper_bound(samples.begin(), samples.end(), value) -
+                 samples.begin();
+  return std::min(index - 1, samples.size() - 2);
+}
+
+void ExpectMatchesBinarySearch(std::span<const float> samples) {
+  ElevationalGuide guide = BuildElevationalGuide(samples);
+  EXPECT_EQ(samples.front(), guide.lower_bound);
+  EXPECT_FALSE(guide.intervals.empty());
+
+  for (float sample : samples) {
+    EXPECT_EQ(BinarySearch(samples, sample),
+              FindElevationalInterval(samples, guide, sample))
+        << sample;
+  }
+
+  for (size_t i = 0; i + 1 < samples.size(); i++) {
+    float midpoint = 0.5f * (samples[i] + samples[i + 1]);
+    EXPECT_EQ(BinarySearch(samples, midpoint),
+              FindElevationalInterval(samples, guide, midpoint))
+        << midpoint;
+  }
+
+  for (float value = samples.front(); value <= samples.back();
+       value += 0.001f) {
+    EXPECT_EQ(BinarySearch(samples, value),
+              FindElevationalInterval(samples, guide, value))
+        << value;
+  }
+}
+
+TEST(ElevationalGuide, Uniform) {
+  ExpectMatchesBinarySearch(std::vector<float>({-1.0f, 0.0f, 1.0f}));
+}
+
+TEST(ElevationalGuide, DuplicateAtOrigin) {
+  ExpectMatchesBinarySearch(std::vector<float>(
+      {-1.0f, -0.99f, -0.5f, 0.0f, 0.0f, 0.5f, 0.99f, 1.0f}));
+}
+
+TEST(ElevationalGuide, TestData) {
+  for (const char* name : {"leather", "paint", "roughglass_alpha_0.2",
+                           "roughgold_alpha_0.2"}) {
+    SCOPED_TRACE(name);
+    auto bsdf = ReadFromStandardBsdf(*OpenTestData(name));
+    ASSERT_TRUE(bsdf) << bsdf.error();
+    ExpectMatchesBinarySearch(bsdf->elevational_samples);
+  }
+}
+
+TEST(ElevationalGuide, OversizedGrid) {
+  std::vector<float> samples = {-1.0f, 0.0f, 1.0f};
+  ElevationalGuide guide = BuildElevationalGuide(samples);
+  guide.cells_per_unit = 1e30f;
+
+  for (float value : {-1.0f, -0.5f, 0.0f, 0.5f, 1.0f}) {
+    EXPECT_EQ(BinarySearch(samples, value),
+              FindElevationalInterval(samples, guide, value))
+        << value;
+  }
+}
+
+}  // namespace
+}  // namespace libfbsdf
@@ -0,0 +1,149 @@
+#include "libfbsdf/readers/reciprocal_series.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <expected>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "libfbsdf/aligned_vector.h"
+#include "libfbsdf/readers/series_repacking.h"
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+
+namespace libfbsdf {
+namespace {
+
+// Returns the relative L2 error of `series` when approximated by `scale` times
+// `source`, with the shorter of the two extended with zeros
+double RelativeError(std::span<const float> series,
+                     std::span<const float> source, double scale) {
+  double total = 0.0, error = 0.0;
+  for (size_t k = 0; k < std::max(series.size(), source.size()); k++) {
+    double value = k < series.size() ? series[k] : 0.0;
+    double approximation = k < source.size() ? scale * source[k] : 0.0;
+    total += SeriesTermEnergy(k, value);
+    error += SeriesTermEnergy(k, value - approximation);
+  }
+
+  if (error == 0.0) {
+    return 0.0;
+  }
+
+  if (total == 0.0) {
+    return std::numeric_limits<double>::infinity();
+  }
+
+  return std::sqrt(error / total);
+}
+
+}  // namespace
+
+std::expected<FoldReciprocalSeriesResult, std::string> FoldReciprocalSeries(
+    ReadFromStandardBsdfResult& bsdf, double relative_tolerance) {
+  if (!(relative_tolerance >= 0.0)) {
+    return std::unexpected("relative_tolerance must be a non-negative number");
+  }
+
+  if (bsdf.coefficient_format != CoefficientFormat::kFloat32) {
+    return std::unexpected(
+        "The series must be folded before the coefficients are converted");
+  }
+
+  if (!bsdf.series_scales.empty()) {
+    return std::unexpected("The series have already been folded");
+  }
+
+  if (bsdf.shared_coefficients) {
+    return std::unexpected(
+        "The series must be folded before they are shared with other BSDFs");
+  }
+
+  const std::vector<float>& samples = bsdf.elevational_samples;
+  size_t num_samples = samples.size();
+  bool is_compact = !bsdf.series_lengths.empty();
+  size_t num_series =
+      is_compact ? bsdf.series_lengths.size() : bsdf.series_extents.size();
+  if (num_series != num_samples * num_samples) {
+    return std::unexpected("There must be one series for each pair of "
+                           "elevational samples");
+  }
+
+  FoldReciprocalSeriesResult result{.num_series_folded = 0,
+                                    .max_relative_error = 0.0,
+                                    .num_coefficients_removed = 0,
+                                    .bytes_saved = 0};
+
+  for (size_t i = 0; i < num_samples; i++) {
+    if (samples[i] != -samples[num_samples - 1 - i]) {
+      return result;
+    }
+  }
+
+  std::array<AlignedVector<float>*, 3> channels = GetChannelArrays(bsdf);
+  size_t num_channels = HasColor(bsdf) ? 3 : 1;
+
+  auto channel = [&](size_t index, size_t c) {
+    auto [offset, length] = GetSeriesExtent(bsdf, index);
+    return std::span<const float>(
+        channels[c]->data() + offset + c * GetSeriesChannelStride(bsdf, length),
+        length);
+  };
+
+  // Of each reciprocal pair, the series that comes later in the table is
+  // folded onto the earlier one, which is therefore never folded itself
+  std::vector<size_t> sources(num_series);
+  std::iota(sources.begin(), sources.end(), 0u);
+  std::vector<float> scales(num_series, 1.0f);
+  for (size_t o = 0; o < num_samples; o++) {
+    for (size_t i = 0; i < num_samples; i++) {
+      size_t index = o * num_samples + i;
+      size_t partner =
+          (num_samples - 1 - i) * num_samples + (num_samples - 1 - o);
+      if (partner >= index || samples[o] == 0.0f || samples[i] == 0.0f) {
+        continue;
+      }
+
+      double scale = std::abs(static_cast<double>(samples[i])) /
+                     std::abs(static_cast<double>(samples[o]));
+
+      double error = 0.0;
+      for (size_t c = 0; c < num_channels; c++) {
+        error = std::max(error, RelativeError(channel(index, c),
+                                              channel(partner, c), scale));
+      }
+
+      if (error <= relative_tolerance) {
+        sources[index] = partner;
+        scales[index] = static_cast<float>(scale);
+        result.num_series_folded += 1;
+        result.max_relative_error = std::max(result.max_relative_error, error);
+      }
+    }
+  }
+
+  if (result.num_series_folded == 0) {
+    return result;
+  }
+
+  // Folded series are no longer copied when the rest are repacked
+  std::vector<size_t> lengths(num_series);
+  for (size_t index = 0; index < num_series; index++) {
+    lengths[index] = GetSeriesExtent(bsdf, index).second;
+  }
+
+  RemovedCoefficients removed = RepackSeries(bsdf, sources, lengths);
+  result.num_coefficients_removed = removed.num_coefficients;
+  result.bytes_saved = removed.bytes;
+
+  bsdf.series_scales = std::move(scales);
+
+  return result;
+}
+
+}  // namespace libfbsdf
@@ -0,0 +1,45 @@
+#ifndef _LIBFBSDF_READERS_RECIPROCAL_SERIES_
+#define _LIBFBSDF_READERS_RECIPROCAL_SERIES_
+
+#include <cstddef>
+#include <expected>
+#include <string>
+
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+
+namespace libfbsdf {
+
+struct FoldReciprocalSeriesResult {
+  size_t num_series_folded;
+
+  // The largest relative L2 error over [0, 2 * pi] of any folded series in any
+  // color channel. Never greater than the requested tolerance.
+  double max_relative_error;
+
+  // Counted per color channel, including the padding of the folded series
+  size_t num_coefficients_removed;
+  size_t bytes_saved;
+};
+
+// Reciprocity requires that f(mu_in, mu_out, phi) = f(-mu_out, -mu_in, phi),
+// and since the series of a standard BSDF store f scaled by |mu_in|, the series
+// of each such pair of elevational samples differ only by a factor of
+// |mu_out| / |mu_in|. This finds the pairs whose series agree up to that factor
+// to within `relative_tolerance` of the L2 norm of each series in every color
+// channel, keeps the series of each pair that comes first in the series table,
+// and points the extent of the other at it with the factor recorded in
+// `bsdf.series_scales`. The coefficients are then repacked without the folded
+// series. `GetSeriesExtent` and `GetSeriesScale` together give each series
+// whether or not it was folded, and the evaluators apply both.
+//
+// Nothing is folded unless the elevational samples are symmetric about zero.
+// Series at an elevational sample of zero are never folded since their scale
+// is undefined. Fails if `relative_tolerance` is negative or NaN, if the
+// coefficients are not stored as 32-bit floats, if the series have already
+// been folded, or if the coefficients are shared with other BSDFs.
+std::expected<FoldReciprocalSeriesResult, std::string> FoldReciprocalSeries(
+    ReadFromStandardBsdfResult& bsdf, double relative_tolerance);
+
+}  // namespace libfbsdf
+
+#endif  // _LIBFBSDF_READERS_RECIPROCAL_SERIES_
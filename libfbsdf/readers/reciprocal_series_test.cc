@@ -0,0 +1,283 @@
+#include "libfbsdf/readers/reciprocal_series.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "googletest/include/gtest/gtest.h"
+#include "libfbsdf/aligned_vector.h"
+#include "libfbsdf/readers/series_truncation.h"
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+#include "test_data/test_data.h"
+
+namespace libfbsdf {
+namespace {
+
+using ::libfbsdf::testing::kTestDataFiles;
+using ::libfbsdf::testing::OpenTestData;
+
+constexpr size_t kNumSamples = 4;
+
+size_t Partner(size_t index) {
+  size_t o = index / kNumSamples, i = index % kNumSamples;
+  return (kNumSamples - 1 - i) * kNumSamples + (kNumSamples - 1 - o);
+}
+
+// Makes a BSDF whose series are exactly reciprocal, with the series of each
+// reciprocal pair sharing the coefficients of f before they are scaled by
+// |mu_in|, except for the series of `perturbed_index`
+ReadFromStandardBsdfResult MakeReciprocalBsdf(
+    size_t perturbed_index = kNumSamples * kNumSamples) {
+  ReadFromStandardBsdfResult result;
+  result.elevational_samples = {-1.0f, -0.5f, 0.5f, 1.0f};
+  result.cdf.resize(kNumSamples * kNumSamples, 0.0f);
+  for (size_t index = 0; index < kNumSamples * kNumSamples; index++) {
+    size_t key = std::min(index, Partner(index));
+    std::vector<float> f = {1.0f + key, 0.25f * key, 0.125f};
+    if (key % 3 == 0) {
+      f.pop_back();
+    }
+    if (index == perturbed_index) {
+      f[0] += 0.01f;
+    }
+
+    float mu_in = std::abs(result.elevational_samples[index % kNumSamples]);
+    result.series_extents.emplace_back(result.y_coefficients.size(),
+                                       f.size());
+    for (float coefficient : f) {
+      result.y_coefficients.push_back(mu_in * coefficient);
+    }
+  }
+  result.index_of_refraction = 1.0f;
+  result.roughness_top = 0.0f;
+  result.roughness_bottom = 0.0f;
+  return result;
+}
+
+// Returns the coefficient `k` of series `index` of color channel `c`,
+// unfolding it if needed
+double GetCoefficient(const ReadFromStandardBsdfResult& bsdf,
+                      const AlignedVector<float>& coefficients, size_t c,
+                      size_t index, size_t k) {
+  auto [offset, length] = GetSeriesExtent(bsdf, index);
+  if (k >= length) {
+    return 0.0;
+  }
+
+  return GetSeriesScale(bsdf, index) *
+         coefficients[offset + c * GetSeriesChannelStride(bsdf, length) + k];
+}
+
+TEST(FoldReciprocalSeries, InvalidTolerance) {
+  ReadFromStandardBsdfResult bsdf = MakeReciprocalBsdf();
+  for (double tolerance : {-0.1, static_cast<double>(NAN)}) {
+    auto result = FoldReciprocalSeries(bsdf, tolerance);
+    ASSERT_FALSE(result);
+    EXPECT_EQ("relative_tolerance must be a non-negative number",
+              result.error());
+  }
+}
+
+TEST(FoldReciprocalSeries, Folds) {
+  ReadFromStandardBsdfResult expected = MakeReciprocalBsdf();
+  ReadFromStandardBsdfResult bsdf = expected;
+
+  auto result = FoldReciprocalSeries(bsdf, 1e-6);
+  ASSERT_TRUE(result) << result.error();
+
+  // The series on the anti-diagonal are their own partners
+  EXPECT_EQ(6u, result->num_series_folded);
+  EXPECT_LE(result->max_relative_error, 1e-6);
+
+  size_t num_removed = 0;
+  for (size_t index = 0; index < kNumSamples * kNumSamples; index++) {
+    if (Partner(index) < index) {
+      num_removed += expected.series_extents[index].second;
+      EXPECT_EQ(bsdf.series_extents[Partner(index)],
+                bsdf.series_extents[index]);
+    } else {
+      EXPECT_EQ(1.0f, GetSeriesScale(bsdf, index));
+    }
+
+    for (size_t k = 0; k < 3; k++) {
+      double value = GetCoefficient(expected, expected.y_coefficients, 0,
+                                    index, k);
+      EXPECT_NEAR(value, GetCoefficient(bsdf, bsdf.y_coefficients, 0, index, k),
+                  1e-6 * std::abs(value))
+          << index << " " << k;
+    }
+  }
+
+  EXPECT_EQ(num_removed, result->num_coefficients_removed);
+  EXPECT_EQ(num_removed * sizeof(float), result->bytes_saved);
+  EXPECT_EQ(expected.y_coefficients.size() - num_removed,
+            bsdf.y_coefficients.size());
+
+  auto refolded = FoldReciprocalSeries(bsdf, 1e-6);
+  ASSERT_FALSE(refolded);
+  EXPECT_EQ("The series have already been folded", refolded.error());
+
+  auto truncated = TruncateSeries(bsdf, 0.01);
+  ASSERT_FALSE(truncated);
+  EXPECT_EQ("The series must be truncated before they are folded",
+            truncated.error());
+}
+
+TEST(FoldReciprocalSeries, Tolerance) {
+  ReadFromStandardBsdfResult bsdf = MakeReciprocalBsdf(/*perturbed_index=*/7);
+
+  auto result = FoldReciprocalSeries(bsdf, 1e-6);
+  ASSERT_TRUE(result) << result.error();
+  EXPECT_EQ(5u, result->num_series_folded);
+  EXPECT_NE(bsdf.series_extents[Partner(7)], bsdf.series_extents[7]);
+  EXPECT_EQ(1.0f, GetSeriesScale(bsdf, 7));
+
+  bsdf = MakeReciprocalBsdf(/*perturbed_index=*/7);
+  result = FoldReciprocalSeries(bsdf, 0.01);
+  ASSERT_TRUE(result) << result.error();
+  EXPECT_EQ(6u, result->num_series_folded);
+  EXPECT_GT(result->max_relative_error, 1e-6);
+  EXPECT_LE(result->max_relative_error, 0.01);
+  EXPECT_EQ(bsdf.series_extents[Partner(7)], bsdf.series_extents[7]);
+}
+
+TEST(FoldReciprocalSeries, AsymmetricSamples) {
+  ReadFromStandardBsdfResult expected = MakeReciprocalBsdf();
+  expected.elevational_samples[1] = -0.25f;
+  ReadFromStandardBsdfResult bsdf = expected;
+
+  auto result = FoldReciprocalSeries(bsdf, 1.0);
+  ASSERT_TRUE(result) << result.error();
+  EXPECT_EQ(0u, result->num_series_folded);
+  EXPECT_EQ(0u, result->bytes_saved);
+  EXPECT_EQ(expected.y_coefficients, bsdf.y_coefficients);
+  EXPECT_EQ(expected.series_extents, bsdf.series_extents);
+  EXPECT_TRUE(bsdf.series_scales.empty());
+}
+
+TEST(FoldReciprocalSeries, HalfCoefficients) {
+  auto bsdf = ReadFromStandardBsdf(
+      *OpenTestData("paint"),
+      {.coefficient_format = CoefficientFormat::kFloat16});
+  ASSERT_TRUE(bsdf) << bsdf.error();
+
+  auto result = FoldReciprocalSeries(*bsdf, 0.01);
+  ASSERT_FALSE(result);
+  EXPECT_EQ("The series must be folded before the coefficients are converted",
+            result.error());
+}
+
+// Checks that every series of `bsdf` is within `tolerance` of the same series
+// of `expected` in every channel
+void ExpectUnfolds(const ReadFromStandardBsdfResult& expected,
+                   const ReadFromStandardBsdfResult& bsdf, double tolerance) {
+  const AlignedVector<float>* expected_channels[3] = {
+      &expected.y_coefficients, &expected.r_coefficients,
+      &expected.b_coefficients};
+  const AlignedVector<float>* channels[3] = {
+      &bsdf.y_coefficients, &bsdf.r_coefficients, &bsdf.b_coefficients};
+  if (bsdf.interleaved_color_channels) {
+    channels[1] = &bsdf.y_coefficients;
+    channels[2] = &bsdf.y_coefficients;
+  }
+
+  size_t num_channels = HasColor(expected) ? 3 : 1;
+  for (size_t index = 0; index < expected.series_extents.size(); index++) {
+    size_t length = std::max(expected.series_extents[index].second,
+                             GetSeriesExtent(bsdf, index).second);
+    for (size_t c = 0; c < num_channels; c++) {
+      double norm = 0.0, error = 0.0;
+      for (size_t k = 0; k < length; k++) {
+        double value =
+            GetCoefficient(expected, *expected_channels[c], c, index, k);
+        double difference =
+            value - GetCoefficient(bsdf, *channels[c], c, index, k);
+        norm += (k == 0 ? 2.0 : 1.0) * value * value;
+        error += (k == 0 ? 2.0 : 1.0) * difference * difference;
+      }
+
+      // Allows for rounding of the scale
+      EXPECT_LE(std::sqrt(error), tolerance * std::sqrt(norm) + 1e-6)
+          << index << " " << c;
+    }
+  }
+}
+
+TEST(FoldReciprocalSeries, TestData) {
+  for (const auto& [name, file_params] : kTestDataFiles) {
+    auto expected = ReadFromStandardBsdf(*OpenTestData(name));
+    ASSERT_TRUE(expected) << name << ": " << expected.error();
+
+    ReadFromStandardBsdfResult bsdf = *expected;
+    auto result = FoldReciprocalSeries(bsdf, 1e-3);
+    ASSERT_TRUE(result) << name << ": " << result.error();
+    EXPECT_GT(result->num_series_folded, 0u) << name;
+    EXPECT_LE(result->max_relative_error, 1e-3) << name;
+    EXPECT_EQ(expected->y_coefficients.size() - bsdf.y_coefficients.size(),
+              result->num_coefficients_removed)
+        << name;
+
+    SCOPED_TRACE(name);
+    ExpectUnfolds(*expected, bsdf, 1e-3);
+  }
+}
+
+TEST(FoldReciprocalSeries, CompactSeriesExtents) {
+  auto expected = ReadFromStandardBsdf(*OpenTestData("roughgold_alpha_0.2"));
+  ASSERT_TRUE(expected) << expected.error();
+  auto bsdf = ReadFromStandardBsdf(*OpenTestData("roughgold_alpha_0.2"),
+                                   {.compact_series_extents = true});
+  ASSERT_TRUE(bsdf) << bsdf.error();
+
+  auto expected_result = FoldReciprocalSeries(*expected, 1e-3);
+  ASSERT_TRUE(expected_result) << expected_result.error();
+  auto result = FoldReciprocalSeries(*bsdf, 1e-3);
+  ASSERT_TRUE(result) << result.error();
+
+  EXPECT_EQ(expected_result->num_series_folded, result->num_series_folded);
+  EXPECT_EQ(expected_result->bytes_saved, result->bytes_saved);
+  EXPECT_EQ(expected->y_coefficients, bsdf->y_coefficients);
+  EXPECT_EQ(expected->series_scales, bsdf->series_scales);
+  EXPECT_TRUE(bsdf->series_extents.empty());
+  for (size_t i = 0; i < expected->series_extents.size(); i++) {
+    EXPECT_EQ(expected->series_extents[i], GetSeriesExtent(*bsdf, i));
+  }
+}
+
+TEST(FoldReciprocalSeries, InterleavedColorChannels) {
+  auto expected = ReadFromStandardBsdf(*OpenTestData("paint"));
+  ASSERT_TRUE(expected) << expected.error();
+  auto bsdf = ReadFromStandardBsdf(
+      *OpenTestData("paint"),
+      {.series_padding = 4, .interleave_color_channels = true});
+  ASSERT_TRUE(bsdf) << bsdf.error();
+
+  auto expected_result = FoldReciprocalSeries(*expected, 1e-3);
+  ASSERT_TRUE(expected_result) << expected_result.error();
+  auto result = FoldReciprocalSeries(*bsdf, 1e-3);
+  ASSERT_TRUE(result) << result.error();
+  EXPECT_EQ(expected_result->num_series_folded, result->num_series_folded);
+  EXPECT_EQ(expected_result->max_relative_error, result->max_relative_error);
+  EXPECT_EQ(expected->series_scales, bsdf->series_scales);
+
+  // Each remaining series keeps its padding
+  size_t num_samples = bsdf->elevational_samples.size();
+  size_t num_coefficients = 0;
+  for (size_t index = 0; index < bsdf->series_extents.size(); index++) {
+    size_t o = index / num_samples, i = index % num_samples;
+    size_t partner =
+        (num_samples - 1 - i) * num_samples + (num_samples - 1 - o);
+    if (partner >= index ||
+        bsdf->series_extents[partner] != bsdf->series_extents[index]) {
+      num_coefficients += 3 * GetSeriesChannelStride(
+                                  *bsdf, bsdf->series_extents[index].second);
+    }
+  }
+  EXPECT_EQ(num_coefficients, bsdf->y_coefficients.size());
+
+  ExpectUnfolds(*expected, *bsdf, 1e-3);
+}
+
+}  // namespace
+}  // namespace libfbsdf
@@ -0,0 +1,249 @@
+#include "libfbsdf/readers/series_deduplication.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <limits>
+#include <memory>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "libfbsdf/aligned_vector.h"
+#include "libfbsdf/readers/series_repacking.h"
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+
+namespace libfbsdf {
+namespace {
+
+// Returns the 64-bit FNV-1a hash of `bytes` continuing from `hash`
+uint64_t Hash(std::span<const std::byte> bytes, uint64_t hash) {
+  for (std::byte byte : bytes) {
+    hash = (hash ^ static_cast<uint64_t>(byte)) * 0x100000001B3u;
+  }
+  return hash;
+}
+
+size_t GetNumSeries(const ReadFromStandardBsdfResult& bsdf) {
+  return bsdf.series_lengths.empty() ? bsdf.series_extents.size()
+                                     : bsdf.series_lengths.size();
+}
+
+std::expected<void, std::string> CheckCanDeduplicate(
+    const ReadFromStandardBsdfResult& bsdf) {
+  if (bsdf.coefficient_format != CoefficientFormat::kFloat32) {
+    return std::unexpected(
+        "The series must be deduplicated before the coefficients are "
+        "converted");
+  }
+
+  if (bsdf.shared_coefficients) {
+    return std::unexpected(
+        "The coefficients are already shared with other BSDFs");
+  }
+
+  return std::expected<void, std::string>();
+}
+
+// Copies the coefficients of each distinct series of `bsdfs` into `output`
+// and records the extent of every series in it in `extents`. Every BSDF must
+// have the coefficient layout of the first. With interleaved color channels,
+// the whole of each series is stored and compared in `y_coefficients`.
+DeduplicateSeriesResult Deduplicate(
+    std::span<ReadFromStandardBsdfResult* const> bsdfs,
+    SharedCoefficients& output,
+    std::vector<std::vector<std::pair<size_t, size_t>>>& extents) {
+  const ReadFromStandardBsdfResult& layout = *bsdfs.front();
+  size_t num_channels = HasColor(layout) ? 3 : 1;
+  size_t num_arrays = layout.interleaved_color_channels ? 1 : num_channels;
+  AlignedVector<float>* outputs[3] = {&output.y_coefficients,
+                                      &output.r_coefficients,
+                                      &output.b_coefficients};
+
+  size_t num_input_coefficients = 0;
+  for (const ReadFromStandardBsdfResult* bsdf : bsdfs) {
+    num_input_coefficients += bsdf->y_coefficients.size();
+  }
+  for (size_t c = 0; c < num_arrays; c++) {
+    outputs[c]->reserve(num_input_coefficients);
+  }
+
+  DeduplicateSeriesResult result{.num_series_deduplicated = 0,
+                                 .num_coefficients_removed = 0,
+                                 .bytes_saved = 0};
+
+  // The indices into `stored_extents` of the stored series with each hash
+  std::unordered_map<uint64_t, std::vector<size_t>> stored;
+  std::vector<std::pair<size_t, size_t>> stored_extents;
+
+  extents.clear();
+  for (const ReadFromStandardBsdfResult* bsdf : bsdfs) {
+    std::array<const AlignedVector<float>*, 3> inputs =
+        GetChannelArrays(*bsdf);
+
+    std::vector<std::pair<size_t, size_t>>& bsdf_extents =
+        extents.emplace_back();
+    for (size_t index = 0; index < GetNumSeries(*bsdf); index++) {
+      auto [offset, length] = GetSeriesExtent(*bsdf, index);
+      if (length == 0) {
+        bsdf_extents.emplace_back(0, 0);
+        continue;
+      }
+
+      // The padding of every series is zero, so comparing whole padded series
+      // is the same as comparing their coefficients
+      size_t size = GetPaddedSeriesLength(*bsdf, length) *
+                    (bsdf->interleaved_color_channels ? num_channels : 1u);
+      auto series = [&](const AlignedVector<float>& coefficients,
+                        size_t start) {
+        return std::as_bytes(
+            std::span<const float>(coefficients.data() + start, size));
+      };
+
+      uint64_t hash = 0xCBF29CE484222325u ^ length;
+      for (size_t c = 0; c < num_arrays; c++) {
+        hash = Hash(series(*inputs[c], offset), hash);
+      }
+
+      std::vector<size_t>& candidates = stored[hash];
+      bool found = false;
+      for (size_t candidate : candidates) {
+        auto [stored_offset, stored_length] = stored_extents[candidate];
+        if (stored_length != length) {
+          continue;
+        }
+
+        found = true;
+        for (size_t c = 0; c < num_arrays && found; c++) {
+          std::span<const std::byte> lhs = series(*inputs[c], offset);
+          std::span<const std::byte> rhs = series(*outputs[c], stored_offset);
+          found = std::memcmp(lhs.data(), rhs.data(), lhs.size()) == 0;
+        }
+
+        if (found) {
+          bsdf_extents.push_back(stored_extents[candidate]);
+          result.num_series_deduplicated += 1;
+          break;
+        }
+      }
+
+      if (found) {
+        continue;
+      }
+
+      size_t stored_offset = outputs[0]->size();
+      for (size_t c = 0; c < num_arrays; c++) {
+        outputs[c]->insert(outputs[c]->end(),
+                           inputs[c]->begin() + offset,
+                           inputs[c]->begin() + offset + size);
+      }
+
+      candidates.push_back(stored_extents.size());
+      stored_extents.emplace_back(stored_offset, length);
+      bsdf_extents.emplace_back(stored_offset, length);
+    }
+  }
+
+  RemovedCoefficients removed = CountRemovedCoefficients(
+      layout, num_input_coefficients, output.y_coefficients.size());
+  result.num_coefficients_removed = removed.num_coefficients;
+  result.bytes_saved = removed.bytes;
+
+  for (size_t c = 0; c < num_arrays; c++) {
+    outputs[c]->shrink_to_fit();
+  }
+
+  return result;
+}
+
+void SetSeriesExtents(
+    ReadFromStandardBsdfResult& bsdf,
+    const std::vector<std::pair<size_t, size_t>>& extents) {
+  for (size_t index = 0; index < extents.size(); index++) {
+    if (bsdf.series_lengths.empty()) {
+      bsdf.series_extents[index] = extents[index];
+    } else {
+      bsdf.series_offsets[index] = static_cast<uint32_t>(extents[index].first);
+      bsdf.series_lengths[index] =
+          static_cast<uint16_t>(extents[index].second);
+    }
+  }
+}
+
+}  // namespace
+
+std::expected<DeduplicateSeriesResult, std::string> DeduplicateSeries(
+    ReadFromStandardBsdfResult& bsdf) {
+  if (auto checked = CheckCanDeduplicate(bsdf); !checked) {
+    return std::unexpected(checked.error());
+  }
+
+  // The coefficients are deduplicated into new arrays which then replace
+  // those of `bsdf`. Since there are never more coefficients than before, the
+  // compact series extents remain representable.
+  ReadFromStandardBsdfResult* bsdfs[] = {&bsdf};
+  SharedCoefficients coefficients;
+  std::vector<std::vector<std::pair<size_t, size_t>>> extents;
+  DeduplicateSeriesResult result = Deduplicate(bsdfs, coefficients, extents);
+
+  SetSeriesExtents(bsdf, extents.front());
+  bsdf.y_coefficients = std::move(coefficients.y_coefficients);
+  bsdf.r_coefficients = std::move(coefficients.r_coefficients);
+  bsdf.b_coefficients = std::move(coefficients.b_coefficients);
+
+  return result;
+}
+
+std::expected<DeduplicateSeriesResult, std::string> DeduplicateSeries(
+    std::span<ReadFromStandardBsdfResult* const> bsdfs) {
+  if (bsdfs.empty()) {
+    return DeduplicateSeriesResult{.num_series_deduplicated = 0,
+                                   .num_coefficients_removed = 0,
+                                   .bytes_saved = 0};
+  }
+
+  const ReadFromStandardBsdfResult& layout = *bsdfs.front();
+  for (const ReadFromStandardBsdfResult* bsdf : bsdfs) {
+    if (auto checked = CheckCanDeduplicate(*bsdf); !checked) {
+      return std::unexpected(checked.error());
+    }
+
+    if (HasColor(*bsdf) != HasColor(layout) ||
+        bsdf->interleaved_color_channels != layout.interleaved_color_channels ||
+        bsdf->series_padding != layout.series_padding) {
+      return std::unexpected(
+          "The BSDFs must have the same color channels, channel layout, and "
+          "series padding to share their coefficients");
+    }
+  }
+
+  auto coefficients = std::make_shared<SharedCoefficients>();
+  std::vector<std::vector<std::pair<size_t, size_t>>> extents;
+  DeduplicateSeriesResult result = Deduplicate(bsdfs, *coefficients, extents);
+
+  for (const ReadFromStandardBsdfResult* bsdf : bsdfs) {
+    if (!bsdf->series_lengths.empty() &&
+        coefficients->y_coefficients.size() >
+            std::numeric_limits<uint32_t>::max()) {
+      return std::unexpected("The shared coefficients are too many for "
+                             "compact series extents");
+    }
+  }
+
+  for (size_t i = 0; i < bsdfs.size(); i++) {
+    ReadFromStandardBsdfResult& bsdf = *bsdfs[i];
+    SetSeriesExtents(bsdf, extents[i]);
+    bsdf.y_coefficients = AlignedVector<float>();
+    bsdf.r_coefficients = AlignedVector<float>();
+    bsdf.b_coefficients = AlignedVector<float>();
+    bsdf.shared_coefficients = coefficients;
+  }
+
+  return result;
+}
+
+}  // namespace libfbsdf
@@ -0,0 +1,47 @@
+#ifndef _LIBFBSDF_READERS_SERIES_DEDUPLICATION_
+#define _LIBFBSDF_READERS_SERIES_DEDUPLICATION_
+
+#include <cstddef>
+#include <expected>
+#include <span>
+#include <string>
+
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+
+namespace libfbsdf {
+
+struct DeduplicateSeriesResult {
+  // The number of non-empty series pointed at coefficients stored for another
+  // series, including any that already shared coefficients
+  size_t num_series_deduplicated;
+
+  // Counted per color channel, including the padding of the removed series
+  size_t num_coefficients_removed;
+  size_t bytes_saved;
+};
+
+// Stores the coefficients of each distinct Fourier series of `bsdf` once and
+// points the extents of every series with the same coefficients at them, then
+// repacks the coefficients. Series are found by hashing their coefficients and
+// are only considered the same if they have the same length and the same bits
+// in every color channel, so evaluation is unchanged. This targets series that
+// repeat within a BSDF, such as all zero transmission series or constant
+// diffuse terms. Fails if the coefficients of `bsdf` are not stored as 32-bit
+// floats or are shared with other BSDFs.
+std::expected<DeduplicateSeriesResult, std::string> DeduplicateSeries(
+    ReadFromStandardBsdfResult& bsdf);
+
+// As above, but for the series of all of `bsdfs` together. Their coefficients
+// are moved into a single `SharedCoefficients` held by each of them that
+// stores each distinct series once, and their own coefficient arrays are left
+// empty. Since the extents of the series index the shared arrays, the BSDFs
+// must all have the same color channels, channel layout, and series padding.
+// Fails, leaving `bsdfs` unchanged, if they do not, if any of them fails as
+// above, or if the shared coefficients are too many for the compact series
+// extents of any of them.
+std::expected<DeduplicateSeriesResult, std::string> DeduplicateSeries(
+    std::span<ReadFromStandardBsdfResult* const> bsdfs);
+
+}  // namespace libfbsdf
+
+#endif  // _LIBFBSDF_READERS_SERIES_DEDUPLICATION_
@@ -0,0 +1,268 @@
+#include "libfbsdf/readers/series_deduplication.h"
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#include "googlemock/include/gmock/gmock.h"
+#include "googletest/include/gtest/gtest.h"
+#include "libfbsdf/aligned_vector.h"
+#include "libfbsdf/readers/reciprocal_series.h"
+#include "libfbsdf/readers/series_truncation.h"
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+#include "libfbsdf/readers/test_standard_bsdf.h"
+#include "test_data/test_data.h"
+
+namespace libfbsdf {
+namespace {
+
+using ::libfbsdf::testing::kTestDataFiles;
+using ::libfbsdf::testing::MakeSeriesBsdf;
+using ::libfbsdf::testing::OpenTestData;
+using ::testing::ElementsAre;
+using ::testing::Pair;
+
+// Checks that the series at `index` of `bsdf` has the same coefficients in
+// every channel as the series at `index` of `expected`
+void ExpectSameSeries(const ReadFromStandardBsdfResult& expected,
+                      const ReadFromStandardBsdfResult& bsdf, size_t index) {
+  const AlignedVector<float>* expected_channels[3] = {
+      &expected.y_coefficients, &expected.r_coefficients,
+      &expected.b_coefficients};
+  const AlignedVector<float>* channels[3] = {
+      &GetYCoefficients(bsdf), &GetRCoefficients(bsdf),
+      &GetBCoefficients(bsdf)};
+  if (expected.interleaved_color_channels) {
+    expected_channels[1] = &expected.y_coefficients;
+    expected_channels[2] = &expected.y_coefficients;
+    channels[1] = &GetYCoefficients(bsdf);
+    channels[2] = &GetYCoefficients(bsdf);
+  }
+
+  auto [expected_offset, expected_length] = GetSeriesExtent(expected, index);
+  auto [offset, length] = GetSeriesExtent(bsdf, index);
+  ASSERT_EQ(expected_length, length) << index;
+
+  size_t expected_stride = GetSeriesChannelStride(expected, length);
+  size_t stride = GetSeriesChannelStride(bsdf, length);
+  for (size_t c = 0; c < (HasColor(expected) ? 3u : 1u); c++) {
+    EXPECT_EQ(0, std::memcmp((*expected_channels[c]).data() +
+                                 expected_offset + c * expected_stride,
+                             (*channels[c]).data() + offset + c * stride,
+                             length * sizeof(float)))
+        << index << " " << c;
+  }
+}
+
+TEST(DeduplicateSeries, Monochrome) {
+  ReadFromStandardBsdfResult bsdf =
+      MakeSeriesBsdf({{1.0f, 2.0f}, {1.0f, 2.0f}, {}, {1.0f, 2.0f, 0.0f}});
+
+  auto result = DeduplicateSeries(bsdf);
+  ASSERT_TRUE(result) << result.error();
+  EXPECT_EQ(1u, result->num_series_deduplicated);
+  EXPECT_EQ(2u, result->num_coefficients_removed);
+  EXPECT_EQ(2u * sizeof(float), result->bytes_saved);
+
+  EXPECT_THAT(bsdf.y_coefficients, ElementsAre(1.0f, 2.0f, 1.0f, 2.0f, 0.0f));
+  EXPECT_THAT(bsdf.series_extents,
+              ElementsAre(Pair(0, 2), Pair(0, 2), Pair(0, 0), Pair(2, 3)));
+}
+
+TEST(DeduplicateSeries, ComparesBits) {
+  ReadFromStandardBsdfResult bsdf =
+      MakeSeriesBsdf({{0.0f}, {-0.0f}, {0.0f}, {-0.0f}});
+
+  auto result = DeduplicateSeries(bsdf);
+  ASSERT_TRUE(result) << result.error();
+  EXPECT_EQ(2u, result->num_series_deduplicated);
+  EXPECT_THAT(bsdf.series_extents,
+              ElementsAre(Pair(0, 1), Pair(1, 1), Pair(0, 1), Pair(1, 1)));
+}
+
+TEST(DeduplicateSeries, ComparesEveryChannel) {
+  ReadFromStandardBsdfResult bsdf =
+      MakeSeriesBsdf({{1.0f}, {1.0f}, {1.0f}, {}},
+                     {{2.0f}, {2.0f}, {3.0f}, {}},
+                     {{4.0f}, {4.0f}, {4.0f}, {}});
+
+  auto result = DeduplicateSeries(bsdf);
+  ASSERT_TRUE(result) << result.error();
+  EXPECT_EQ(1u, result->num_series_deduplicated);
+  EXPECT_EQ(1u, result->num_coefficients_removed);
+  EXPECT_EQ(3u * sizeof(float), result->bytes_saved);
+
+  EXPECT_THAT(bsdf.y_coefficients, ElementsAre(1.0f, 1.0f));
+  EXPECT_THAT(bsdf.r_coefficients, ElementsAre(2.0f, 3.0f));
+  EXPECT_THAT(bsdf.b_coefficients, ElementsAre(4.0f, 4.0f));
+  EXPECT_THAT(bsdf.series_extents,
+              ElementsAre(Pair(0, 1), Pair(0, 1), Pair(1, 1), Pair(0, 0)));
+}
+
+TEST(DeduplicateSeries, HalfCoefficients) {
+  auto bsdf = ReadFromStandardBsdf(
+      *OpenTestData("paint"),
+      {.coefficient_format = CoefficientFormat::kFloat16});
+  ASSERT_TRUE(bsdf) << bsdf.error();
+
+  auto result = DeduplicateSeries(*bsdf);
+  ASSERT_FALSE(result);
+  EXPECT_EQ("The series must be deduplicated before the coefficients are "
+            "converted",
+            result.error());
+}
+
+TEST(DeduplicateSeries, TestData) {
+  for (const auto& [name, file_params] : kTestDataFiles) {
+    SCOPED_TRACE(name);
+    for (ReadFromStandardBsdfOptions options :
+         {ReadFromStandardBsdfOptions{},
+          ReadFromStandardBsdfOptions{.compact_series_extents = true},
+          ReadFromStandardBsdfOptions{.series_padding = 4,
+                                      .interleave_color_channels = true}}) {
+      auto expected = ReadFromStandardBsdf(*OpenTestData(name), options);
+      ASSERT_TRUE(expected) << expected.error();
+
+      ReadFromStandardBsdfResult bsdf = *expected;
+      auto result = DeduplicateSeries(bsdf);
+      ASSERT_TRUE(result) << result.error();
+      EXPECT_EQ(expected->y_coefficients.size() - bsdf.y_coefficients.size(),
+                result->num_coefficients_removed *
+                    (bsdf.interleaved_color_channels ? 3u : 1u));
+      EXPECT_EQ(0u, bsdf.y_coefficients.size() % bsdf.series_padding);
+
+      for (size_t i = 0; i < expected->cdf.size(); i++) {
+        ExpectSameSeries(*expected, bsdf, i);
+      }
+
+      // Deduplicating again finds nothing more
+      result = DeduplicateSeries(bsdf);
+      ASSERT_TRUE(result) << result.error();
+      EXPECT_EQ(0u, result->num_coefficients_removed);
+    }
+  }
+}
+
+TEST(DeduplicateSeries, TruncateAndFold) {
+  auto expected = ReadFromStandardBsdf(*OpenTestData("paint"));
+  ASSERT_TRUE(expected) << expected.error();
+  ReadFromStandardBsdfResult bsdf = *expected;
+  auto deduplicated = DeduplicateSeries(bsdf);
+  ASSERT_TRUE(deduplicated) << deduplicated.error();
+  ASSERT_GT(deduplicated->num_series_deduplicated, 0u);
+
+  // Series that share coefficients are truncated alike and stay shared
+  auto expected_truncated = TruncateSeries(*expected, 0.01);
+  ASSERT_TRUE(expected_truncated) << expected_truncated.error();
+  auto truncated = TruncateSeries(bsdf, 0.01);
+  ASSERT_TRUE(truncated) << truncated.error();
+  EXPECT_EQ(expected_truncated->max_relative_error,
+            truncated->max_relative_error);
+  for (size_t i = 0; i < expected->cdf.size(); i++) {
+    ExpectSameSeries(*expected, bsdf, i);
+  }
+
+  auto rededuplicated = DeduplicateSeries(bsdf);
+  ASSERT_TRUE(rededuplicated) << rededuplicated.error();
+  EXPECT_EQ(0u, rededuplicated->num_coefficients_removed);
+
+  auto expected_folded = FoldReciprocalSeries(*expected, 1e-3);
+  ASSERT_TRUE(expected_folded) << expected_folded.error();
+  auto folded = FoldReciprocalSeries(bsdf, 1e-3);
+  ASSERT_TRUE(folded) << folded.error();
+  EXPECT_EQ(expected_folded->num_series_folded, folded->num_series_folded);
+  EXPECT_EQ(expected->series_scales, bsdf.series_scales);
+  for (size_t i = 0; i < expected->cdf.size(); i++) {
+    ExpectSameSeries(*expected, bsdf, i);
+  }
+}
+
+TEST(DeduplicateSeries, AcrossBsdfs) {
+  std::vector<ReadFromStandardBsdfResult> expected;
+  for (const char* name : {"leather", "paint", "roughgold_alpha_0.2"}) {
+    auto bsdf = ReadFromStandardBsdf(*OpenTestData(name));
+    ASSERT_TRUE(bsdf) << name << ": " << bsdf.error();
+    expected.push_back(*std::move(bsdf));
+  }
+
+  std::vector<ReadFromStandardBsdfResult> bsdfs = expected;
+  std::vector<ReadFromStandardBsdfResult*> pointers;
+  size_t num_coefficients = 0, num_removed = 0;
+  for (ReadFromStandardBsdfResult& bsdf : bsdfs) {
+    pointers.push_back(&bsdf);
+    num_coefficients += bsdf.y_coefficients.size();
+
+    ReadFromStandardBsdfResult copy = bsdf;
+    auto result = DeduplicateSeries(copy);
+    ASSERT_TRUE(result) << result.error();
+    num_removed += result->num_coefficients_removed;
+  }
+
+  auto result = DeduplicateSeries(pointers);
+  ASSERT_TRUE(result) << result.error();
+
+  // Nothing can be removed across the BSDFs that is not removed within them
+  EXPECT_GE(result->num_coefficients_removed, num_removed);
+  EXPECT_EQ(3u * sizeof(float) * result->num_coefficients_removed,
+            result->bytes_saved);
+
+  for (size_t b = 0; b < bsdfs.size(); b++) {
+    EXPECT_TRUE(bsdfs[b].y_coefficients.empty());
+    EXPECT_TRUE(bsdfs[b].r_coefficients.empty());
+    EXPECT_TRUE(bsdfs[b].b_coefficients.empty());
+    ASSERT_EQ(bsdfs[0].shared_coefficients, bsdfs[b].shared_coefficients);
+    EXPECT_TRUE(HasColor(bsdfs[b]));
+    for (size_t i = 0; i < expected[b].cdf.size(); i++) {
+      ExpectSameSeries(expected[b], bsdfs[b], i);
+    }
+  }
+  EXPECT_EQ(num_coefficients - result->num_coefficients_removed,
+            bsdfs[0].shared_coefficients->y_coefficients.size());
+
+  auto again = DeduplicateSeries(pointers);
+  ASSERT_FALSE(again);
+  EXPECT_EQ("The coefficients are already shared with other BSDFs",
+            again.error());
+
+  auto truncated = TruncateSeries(bsdfs[0], 0.01);
+  ASSERT_FALSE(truncated);
+  EXPECT_EQ("The series must be truncated before they are shared with other "
+            "BSDFs",
+            truncated.error());
+
+  auto folded = FoldReciprocalSeries(bsdfs[0], 1e-3);
+  ASSERT_FALSE(folded);
+  EXPECT_EQ("The series must be folded before they are shared with other "
+            "BSDFs",
+            folded.error());
+
+  auto converted = ConvertCoefficients(bsdfs[0], CoefficientFormat::kFloat16);
+  ASSERT_FALSE(converted);
+  EXPECT_EQ("Coefficients shared with other BSDFs cannot be converted",
+            converted.error());
+}
+
+TEST(DeduplicateSeries, AcrossBsdfsWithDifferentLayouts) {
+  auto color = ReadFromStandardBsdf(*OpenTestData("paint"));
+  ASSERT_TRUE(color) << color.error();
+  for (ReadFromStandardBsdfOptions options :
+       {ReadFromStandardBsdfOptions{.luminance_only = true},
+        ReadFromStandardBsdfOptions{.series_padding = 4},
+        ReadFromStandardBsdfOptions{.interleave_color_channels = true}}) {
+    auto other = ReadFromStandardBsdf(*OpenTestData("leather"), options);
+    ASSERT_TRUE(other) << other.error();
+
+    ReadFromStandardBsdfResult expected = *other;
+    ReadFromStandardBsdfResult* bsdfs[] = {&*color, &*other};
+    auto result = DeduplicateSeries(bsdfs);
+    ASSERT_FALSE(result);
+    EXPECT_EQ("The BSDFs must have the same color channels, channel layout, "
+              "and series padding to share their coefficients",
+              result.error());
+    EXPECT_EQ(expected.y_coefficients, other->y_coefficients);
+    EXPECT_FALSE(other->shared_coefficients);
+  }
+}
+
+}  // namespace
+}  // namespace libfbsdf
@@ -0,0 +1,160 @@
+#include "libfbsdf/readers/series_repacking.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "libfbsdf/aligned_vector.h"
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+
+namespace libfbsdf {
+
+std::array<const AlignedVector<float>*, 3> GetChannelArrays(
+    const ReadFromStandardBsdfResult& bsdf) {
+  if (bsdf.interleaved_color_channels) {
+    return {&GetYCoefficients(bsdf), &GetYCoefficients(bsdf),
+            &GetYCoefficients(bsdf)};
+  }
+
+  return {&GetYCoefficients(bsdf), &GetRCoefficients(bsdf),
+          &GetBCoefficients(bsdf)};
+}
+
+std::array<AlignedVector<float>*, 3> GetChannelArrays(
+    ReadFromStandardBsdfResult& bsdf) {
+  if (bsdf.interleaved_color_channels) {
+    return {&bsdf.y_coefficients, &bsdf.y_coefficients, &bsdf.y_coefficients};
+  }
+
+  return {&bsdf.y_coefficients, &bsdf.r_coefficients, &bsdf.b_coefficients};
+}
+
+RemovedCoefficients CountRemovedCoefficients(
+    const ReadFromStandardBsdfResult& bsdf, size_t num_coefficients_before,
+    size_t num_coefficients_after) {
+  size_t num_channels = HasColor(bsdf) ? 3 : 1;
+  size_t num_coefficients = (num_coefficients_before - num_coefficients_after) /
+                            (bsdf.interleaved_color_channels ? num_channels : 1u);
+  return RemovedCoefficients{
+      .num_coefficients = num_coefficients,
+      .bytes = num_coefficients * num_channels * sizeof(float)};
+}
+
+RemovedCoefficients RepackSeries(
+    ReadFromStandardBsdfResult& bsdf, std::span<const size_t> sources,
+    std::span<const size_t> lengths,
+    const std::array<const AlignedVector<float>*, 3>& inputs,
+    const std::array<AlignedVector<float>*, 3>& outputs) {
+  bool is_interleaved = bsdf.interleaved_color_channels;
+  size_t num_channels = HasColor(bsdf) ? 3 : 1;
+  size_t num_arrays = is_interleaved ? 1 : num_channels;
+  size_t num_coefficients_before = inputs[0]->size();
+
+  // Ordering by length as well as offset places series that share
+  // coefficients, such as those deduplicated by `DeduplicateSeries`, next to
+  // each other
+  std::vector<size_t> order;
+  for (size_t index = 0; index < sources.size(); index++) {
+    if (sources[index] == index) {
+      order.push_back(index);
+    }
+  }
+
+  std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+    return GetSeriesExtent(bsdf, lhs) < GetSeriesExtent(bsdf, rhs);
+  });
+
+  // The destinations are found before anything is copied so that the outputs
+  // are only resized once, which never reallocates them when repacking in
+  // place
+  struct Copy {
+    size_t source;
+    size_t length;
+    size_t destination;
+    size_t new_length;
+  };
+
+  std::vector<Copy> copies;
+  std::vector<std::pair<size_t, size_t>> extents(sources.size());
+  size_t num_coefficients = 0;
+  std::pair<size_t, size_t> previous_extent(
+      std::numeric_limits<size_t>::max(), 0);
+  size_t previous = 0;
+  for (size_t index : order) {
+    std::pair<size_t, size_t> extent = GetSeriesExtent(bsdf, index);
+    if (extent == previous_extent) {
+      extents[index] = extents[previous];
+      continue;
+    }
+
+    previous_extent = extent;
+    previous = index;
+
+    copies.push_back({extent.first, extent.second, num_coefficients,
+                      lengths[index]});
+    extents[index] = {num_coefficients, lengths[index]};
+
+    size_t padded_length = GetPaddedSeriesLength(bsdf, lengths[index]);
+    num_coefficients +=
+        is_interleaved ? num_channels * padded_length : padded_length;
+  }
+
+  for (size_t c = 0; c < num_arrays; c++) {
+    if (outputs[c]->size() < num_coefficients) {
+      outputs[c]->resize(num_coefficients);
+    }
+  }
+
+  for (const Copy& copy : copies) {
+    size_t stride = GetSeriesChannelStride(bsdf, copy.length);
+    size_t new_stride = GetSeriesChannelStride(bsdf, copy.new_length);
+    size_t padded_length = GetPaddedSeriesLength(bsdf, copy.new_length);
+    for (size_t c = 0; c < num_channels; c++) {
+      size_t source = copy.source + c * stride;
+      size_t destination = copy.destination + c * new_stride;
+
+      if (inputs[c] != outputs[c] || source != destination) {
+        std::copy_n(inputs[c]->begin() + source, copy.new_length,
+                    outputs[c]->begin() + destination);
+      }
+
+      // The padding must be zeroed again as removed coefficients or those of
+      // another series may have been left there
+      std::fill(outputs[c]->begin() + destination + copy.new_length,
+                outputs[c]->begin() + destination + padded_length, 0.0f);
+    }
+  }
+
+  for (size_t index = 0; index < sources.size(); index++) {
+    auto [offset, length] = extents[sources[index]];
+    if (bsdf.series_lengths.empty()) {
+      bsdf.series_extents[index] = {offset, length};
+    } else {
+      bsdf.series_offsets[index] = static_cast<uint32_t>(offset);
+      bsdf.series_lengths[index] = static_cast<uint16_t>(length);
+    }
+  }
+
+  for (size_t c = 0; c < num_arrays; c++) {
+    outputs[c]->resize(num_coefficients);
+    outputs[c]->shrink_to_fit();
+  }
+
+  return CountRemovedCoefficients(bsdf, num_coefficients_before,
+                                  num_coefficients);
+}
+
+RemovedCoefficients RepackSeries(ReadFromStandardBsdfResult& bsdf,
+                                 std::span<const size_t> sources,
+                                 std::span<const size_t> lengths) {
+  std::array<AlignedVector<float>*, 3> channels = GetChannelArrays(bsdf);
+  return RepackSeries(bsdf, sources, lengths,
+                      {channels[0], channels[1], channels[2]}, channels);
+}
+
+}  // namespace libfbsdf
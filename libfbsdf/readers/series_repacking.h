@@ -0,0 +1,71 @@
+#ifndef _LIBFBSDF_READERS_SERIES_REPACKING_
+#define _LIBFBSDF_READERS_SERIES_REPACKING_
+
+#include <array>
+#include <cstddef>
+#include <span>
+
+#include "libfbsdf/aligned_vector.h"
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+
+namespace libfbsdf {
+
+// The square of the L2 norm of the term `k` of a Fourier cosine series over
+// [0, 2 * pi] up to a common factor of pi
+inline double SeriesTermEnergy(size_t k, double coefficient) {
+  double squared = coefficient * coefficient;
+  return k == 0 ? 2.0 * squared : squared;
+}
+
+// Returns the arrays holding the 32-bit coefficients of the luminance, red,
+// and blue channels of `bsdf`, which are its shared coefficients if it has any.
+// Interleaved channels are all stored in the luminance array with each series
+// followed by its other channels at multiples of its channel stride, so all
+// three point at the luminance array.
+std::array<const AlignedVector<float>*, 3> GetChannelArrays(
+    const ReadFromStandardBsdfResult& bsdf);
+
+// As above, but for the arrays owned by `bsdf` itself.
+std::array<AlignedVector<float>*, 3> GetChannelArrays(
+    ReadFromStandardBsdfResult& bsdf);
+
+// The coefficients removed from a BSDF, counted per color channel as in the
+// separate channel layout and including any padding removed along with them.
+struct RemovedCoefficients {
+  size_t num_coefficients;
+  size_t bytes;
+};
+
+// Returns the coefficients removed from a BSDF with the color channels and
+// channel layout of `bsdf` when its coefficient arrays shrink from
+// `num_coefficients_before` to `num_coefficients_after` coefficients each.
+RemovedCoefficients CountRemovedCoefficients(
+    const ReadFromStandardBsdfResult& bsdf, size_t num_coefficients_before,
+    size_t num_coefficients_after);
+
+// Copies each series of `bsdf` that is its own entry in `sources` from
+// `inputs` to `outputs` one after another in order of their extents,
+// shortening the series at each such index to `lengths[index]` and zeroing its
+// padding, then points the series at each index at the copy of the series at
+// `sources[index]`. Series of `bsdf` that share coefficients continue to share
+// them and must be given the same length. Only the copied series are kept in
+// `outputs`, which are resized to fit them.
+//
+// Since no series is lengthened or moved forwards when they are copied in
+// order of their extents, `inputs` and `outputs` may be the same arrays to
+// repack the coefficients in place. The extents of series that do not share
+// coefficients must not overlap.
+RemovedCoefficients RepackSeries(
+    ReadFromStandardBsdfResult& bsdf, std::span<const size_t> sources,
+    std::span<const size_t> lengths,
+    const std::array<const AlignedVector<float>*, 3>& inputs,
+    const std::array<AlignedVector<float>*, 3>& outputs);
+
+// As above, but repacks the coefficients of `bsdf` in place.
+RemovedCoefficients RepackSeries(ReadFromStandardBsdfResult& bsdf,
+                                 std::span<const size_t> sources,
+                                 std::span<const size_t> lengths);
+
+}  // namespace libfbsdf
+
+#endif  // _LIBFBSDF_READERS_SERIES_REPACKING_
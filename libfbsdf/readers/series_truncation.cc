@@ -0,0 +1,134 @@
+#include "libfbsdf/readers/series_truncation.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <expected>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "libfbsdf/aligned_vector.h"
+#include "libfbsdf/readers/series_repacking.h"
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+
+namespace libfbsdf {
+namespace {
+
+// Returns the length of the shortest prefix of `series` whose tail has at most
+// `threshold` of the L2 norm of the series
+size_t TruncatedLength(std::span<const float> series, double threshold) {
+  double total = 0.0;
+  for (size_t k = 0; k < series.size(); k++) {
+    total += SeriesTermEnergy(k, series[k]);
+  }
+
+  double max_tail = threshold * threshold * total;
+  double tail = 0.0;
+  size_t length = series.size();
+  while (length > 0) {
+    tail += SeriesTermEnergy(length - 1, series[length - 1]);
+    if (tail > max_tail) {
+      break;
+    }
+
+    length -= 1;
+  }
+
+  return length;
+}
+
+// Updates the error bounds of `result` for truncating `series` to `length`
+void UpdateErrors(std::span<const float> series, size_t length,
+                  TruncateSeriesResult& result) {
+  double total = 0.0, tail = 0.0, absolute_error = 0.0;
+  for (size_t k = 0; k < series.size(); k++) {
+    total += SeriesTermEnergy(k, series[k]);
+    if (k >= length) {
+      tail += SeriesTermEnergy(k, series[k]);
+      absolute_error += std::abs(series[k]);
+    }
+  }
+
+  if (tail > 0.0) {
+    result.max_relative_error =
+        std::max(result.max_relative_error, std::sqrt(tail / total));
+    result.max_absolute_error =
+        std::max(result.max_absolute_error, absolute_error);
+  }
+}
+
+}  // namespace
+
+std::expected<TruncateSeriesResult, std::string> TruncateSeries(
+    ReadFromStandardBsdfResult& bsdf, double relative_threshold) {
+  // Written so that NaNs are also rejected. At one or more, whole series
+  // including their constant terms would be removed and no longer match the
+  // CDF of the BSDF.
+  if (!(relative_threshold >= 0.0 && relative_threshold < 1.0)) {
+    return std::unexpected("relative_threshold must be in the range [0, 1)");
+  }
+
+  if (bsdf.coefficient_format != CoefficientFormat::kFloat32) {
+    return std::unexpected(
+        "The coefficients must be truncated before they are converted");
+  }
+
+  if (!bsdf.series_scales.empty()) {
+    return std::unexpected("The series must be truncated before they are "
+                           "folded");
+  }
+
+  if (bsdf.shared_coefficients) {
+    return std::unexpected("The series must be truncated before they are "
+                           "shared with other BSDFs");
+  }
+
+  TruncateSeriesResult result{.max_relative_error = 0.0,
+                              .max_absolute_error = 0.0,
+                              .num_coefficients_removed = 0,
+                              .bytes_saved = 0};
+
+  std::array<AlignedVector<float>*, 3> channels = GetChannelArrays(bsdf);
+  size_t num_channels = HasColor(bsdf) ? 3 : 1;
+
+  // Truncation never lengthens a series, so series extents in the compact
+  // layout always remain representable. Series that share coefficients have
+  // the same coefficients and so are truncated alike.
+  bool is_compact = !bsdf.series_lengths.empty();
+  size_t num_series =
+      is_compact ? bsdf.series_lengths.size() : bsdf.series_extents.size();
+  std::vector<size_t> sources(num_series);
+  std::vector<size_t> lengths(num_series);
+  for (size_t index = 0; index < num_series; index++) {
+    auto [offset, length] = GetSeriesExtent(bsdf, index);
+    size_t stride = GetSeriesChannelStride(bsdf, length);
+
+    // Every channel must meet the threshold, so the longest is kept
+    size_t truncated_length = 0;
+    for (size_t c = 0; c < num_channels; c++) {
+      std::span<const float> series(channels[c]->data() + offset + c * stride,
+                                    length);
+      truncated_length = std::max(truncated_length,
+                                  TruncatedLength(series, relative_threshold));
+    }
+
+    for (size_t c = 0; c < num_channels; c++) {
+      std::span<const float> series(channels[c]->data() + offset + c * stride,
+                                    length);
+      UpdateErrors(series, truncated_length, result);
+    }
+
+    sources[index] = index;
+    lengths[index] = truncated_length;
+  }
+
+  RemovedCoefficients removed = RepackSeries(bsdf, sources, lengths);
+  result.num_coefficients_removed = removed.num_coefficients;
+  result.bytes_saved = removed.bytes;
+
+  return result;
+}
+
+}  // namespace libfbsdf
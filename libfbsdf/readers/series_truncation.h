@@ -0,0 +1,45 @@
+#ifndef _LIBFBSDF_READERS_SERIES_TRUNCATION_
+#define _LIBFBSDF_READERS_SERIES_TRUNCATION_
+
+#include <cstddef>
+#include <expected>
+#include <string>
+
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+
+namespace libfbsdf {
+
+struct TruncateSeriesResult {
+  // The largest relative L2 error over [0, 2 * pi] of any truncated series in
+  // any color channel. Never greater than the requested threshold.
+  double max_relative_error;
+
+  // The largest absolute error at any azimuthal angle of any truncated series
+  // in any color channel, bounded by the sum of the magnitudes of the removed
+  // coefficients.
+  double max_absolute_error;
+
+  // Counted per color channel, including any padding removed along with the
+  // truncated coefficients
+  size_t num_coefficients_removed;
+  size_t bytes_saved;
+};
+
+// Shortens each Fourier series of `bsdf` to the shortest prefix whose
+// truncated tail has at most `relative_threshold` of the L2 norm of the series
+// in every color channel, then repacks the coefficients so that no space is
+// left between series other than their padding. Since evaluation cost is
+// linear in series length, this trades a bounded loss of accuracy for speed
+// and memory on BSDFs with long tails of near zero coefficients. Only series
+// whose coefficients are all zero are truncated to nothing. Fails if
+// `relative_threshold` is not in [0, 1), if the coefficients of `bsdf` are
+// not stored as 32-bit floats, if its series have been folded by
+// `FoldReciprocalSeries`, or if its coefficients are shared with other BSDFs,
+// since all of these can be done after truncation. Series of `bsdf` that share
+// coefficients are truncated alike and continue to share them.
+std::expected<TruncateSeriesResult, std::string> TruncateSeries(
+    ReadFromStandardBsdfResult& bsdf, double relative_threshold);
+
+}  // namespace libfbsdf
+
+#endif  // _LIBFBSDF_READERS_SERIES_TRUNCATION_
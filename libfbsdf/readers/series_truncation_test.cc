@@ -0,0 +1,265 @@
+#include "libfbsdf/readers/series_truncation.h"
+
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <span>
+#include <vector>
+
+#include "googlemock/include/gmock/gmock.h"
+#include "googletest/include/gtest/gtest.h"
+#include "libfbsdf/aligned_vector.h"
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+#include "libfbsdf/readers/test_standard_bsdf.h"
+#include "test_data/test_data.h"
+
+namespace libfbsdf {
+namespace {
+
+using ::libfbsdf::testing::kTestDataFiles;
+using ::libfbsdf::testing::MakeSeriesBsdf;
+using ::libfbsdf::testing::OpenTestData;
+using ::testing::ElementsAre;
+using ::testing::Pair;
+
+TEST(TruncateSeries, InvalidThreshold) {
+  ReadFromStandardBsdfResult bsdf = MakeSeriesBsdf({{1.0f}, {}, {}, {}});
+  for (double threshold : {-0.1, 1.0, 2.0, static_cast<double>(NAN)}) {
+    auto result = TruncateSeries(bsdf, threshold);
+    ASSERT_FALSE(result);
+    EXPECT_EQ("relative_threshold must be in the range [0, 1)",
+              result.error());
+  }
+}
+
+TEST(TruncateSeries, ZeroThreshold) {
+  ReadFromStandardBsdfResult bsdf = MakeSeriesBsdf(
+      {{1.0f, 0.0f, 0.5f, 0.0f, 0.0f}, {0.0f, 0.0f}, {}, {2.0f}});
+
+  auto result = TruncateSeries(bsdf, 0.0);
+  ASSERT_TRUE(result) << result.error();
+  EXPECT_EQ(0.0, result->max_relative_error);
+  EXPECT_EQ(0.0, result->max_absolute_error);
+  EXPECT_EQ(4u, result->num_coefficients_removed);
+  EXPECT_EQ(4u * sizeof(float), result->bytes_saved);
+
+  EXPECT_THAT(bsdf.y_coefficients, ElementsAre(1.0f, 0.0f, 0.5f, 2.0f));
+  EXPECT_THAT(bsdf.series_extents,
+              ElementsAre(Pair(0, 3), Pair(3, 0), Pair(3, 0), Pair(3, 1)));
+}
+
+TEST(TruncateSeries, Monochrome) {
+  ReadFromStandardBsdfResult bsdf = MakeSeriesBsdf(
+      {{0.1f}, {1.0f, 0.5f, 0.01f, 0.001f}, {}, {1.0f, -0.001f}});
+
+  auto result = TruncateSeries(bsdf, 0.01);
+  ASSERT_TRUE(result) << result.error();
+  EXPECT_NEAR(std::sqrt((0.01 * 0.01 + 0.001 * 0.001) /
+                        (2.0 + 0.25 + 0.01 * 0.01 + 0.001 * 0.001)),
+              result->max_relative_error, 1e-9);
+  EXPECT_NEAR(0.011, result->max_absolute_error, 1e-9);
+  EXPECT_EQ(3u, result->num_coefficients_removed);
+  EXPECT_EQ(3u * sizeof(float), result->bytes_saved);
+
+  EXPECT_THAT(bsdf.y_coefficients, ElementsAre(0.1f, 1.0f, 0.5f, 1.0f));
+  EXPECT_THAT(bsdf.series_extents,
+              ElementsAre(Pair(0, 1), Pair(1, 2), Pair(3, 0), Pair(3, 1)));
+}
+
+TEST(TruncateSeries, KeepsConstantTerm) {
+  ReadFromStandardBsdfResult bsdf =
+      MakeSeriesBsdf({{0.1f, 1.0f}, {1.0f, 0.1f}, {0.0f, 0.0f}, {}});
+
+  // Only series that are entirely zero are removed, even when nearly all of
+  // the energy of a series may be truncated
+  auto result = TruncateSeries(bsdf, 0.999);
+  ASSERT_TRUE(result) << result.error();
+  EXPECT_THAT(bsdf.y_coefficients, ElementsAre(0.1f, 1.0f));
+  EXPECT_THAT(bsdf.series_extents,
+              ElementsAre(Pair(0, 1), Pair(1, 1), Pair(2, 0), Pair(2, 0)));
+}
+
+TEST(TruncateSeries, KeepsLongestChannel) {
+  ReadFromStandardBsdfResult bsdf = MakeSeriesBsdf(
+      {{1.0f, 0.0f, 0.0f}, {1.0f, 0.0f}, {}, {}},
+      {{1.0f, 1.0f, 0.0f}, {1.0f, 0.0f}, {}, {}},
+      {{1.0f, 0.0f, 1.0f}, {1.0f, 0.0f}, {}, {}});
+
+  auto result = TruncateSeries(bsdf, 0.01);
+  ASSERT_TRUE(result) << result.error();
+  EXPECT_EQ(0.0, result->max_relative_error);
+  EXPECT_EQ(0.0, result->max_absolute_error);
+  EXPECT_EQ(1u, result->num_coefficients_removed);
+  EXPECT_EQ(3u * sizeof(float), result->bytes_saved);
+
+  EXPECT_THAT(bsdf.y_coefficients, ElementsAre(1.0f, 0.0f, 0.0f, 1.0f));
+  EXPECT_THAT(bsdf.r_coefficients, ElementsAre(1.0f, 1.0f, 0.0f, 1.0f));
+  EXPECT_THAT(bsdf.b_coefficients, ElementsAre(1.0f, 0.0f, 1.0f, 1.0f));
+  EXPECT_THAT(bsdf.series_extents,
+              ElementsAre(Pair(0, 3), Pair(3, 1), Pair(4, 0), Pair(4, 0)));
+}
+
+// Sums the series at `index` of `coefficients` at `phi`
+double Sum(const ReadFromStandardBsdfResult& bsdf,
+           std::span<const float> coefficients, size_t index, double phi) {
+  auto [offset, length] = bsdf.series_extents[index];
+  double value = 0.0;
+  for (size_t k = 0; k < length; k++) {
+    value += coefficients[offset + k] * std::cos(k * phi);
+  }
+  return value;
+}
+
+TEST(TruncateSeries, TestData) {
+  for (const auto& [name, file_params] : kTestDataFiles) {
+    auto expected = ReadFromStandardBsdf(*OpenTestData(name));
+    ASSERT_TRUE(expected) << name << ": " << expected.error();
+
+    ReadFromStandardBsdfResult bsdf = *expected;
+    auto result = TruncateSeries(bsdf, 0.01);
+    ASSERT_TRUE(result) << name << ": " << result.error();
+    EXPECT_LE(result->max_relative_error, 0.01) << name;
+    EXPECT_EQ(expected->y_coefficients.size() - bsdf.y_coefficients.size(),
+              result->num_coefficients_removed)
+        << name;
+
+    size_t num_channels = expected->r_coefficients.empty() ? 1 : 3;
+    EXPECT_EQ(result->num_coefficients_removed * num_channels * sizeof(float),
+              result->bytes_saved)
+        << name;
+
+    for (size_t i = 0; i < bsdf.series_extents.size(); i++) {
+      EXPECT_LE(bsdf.series_extents[i].second,
+                expected->series_extents[i].second)
+          << name;
+      for (double phi : {0.0, 1.0, std::numbers::pi}) {
+        EXPECT_NEAR(Sum(*expected, expected->y_coefficients, i, phi),
+                    Sum(bsdf, bsdf.y_coefficients, i, phi),
+                    result->max_absolute_error + 1e-5)
+            << name;
+      }
+    }
+  }
+}
+
+TEST(TruncateSeries, CompactSeriesExtents) {
+  auto expected = ReadFromStandardBsdf(*OpenTestData("roughgold_alpha_0.2"));
+  ASSERT_TRUE(expected) << expected.error();
+  auto bsdf = ReadFromStandardBsdf(*OpenTestData("roughgold_alpha_0.2"),
+                                   {.compact_series_extents = true});
+  ASSERT_TRUE(bsdf) << bsdf.error();
+
+  auto expected_result = TruncateSeries(*expected, 0.01);
+  ASSERT_TRUE(expected_result) << expected_result.error();
+  auto result = TruncateSeries(*bsdf, 0.01);
+  ASSERT_TRUE(result) << result.error();
+
+  EXPECT_EQ(expected_result->max_relative_error, result->max_relative_error);
+  EXPECT_EQ(expected_result->max_absolute_error, result->max_absolute_error);
+  EXPECT_EQ(expected_result->bytes_saved, result->bytes_saved);
+  EXPECT_EQ(expected->y_coefficients, bsdf->y_coefficients);
+  EXPECT_TRUE(bsdf->series_extents.empty());
+  for (size_t i = 0; i < expected->series_extents.size(); i++) {
+    EXPECT_EQ(expected->series_extents[i], GetSeriesExtent(*bsdf, i));
+  }
+}
+
+TEST(TruncateSeries, SeriesPadding) {
+  auto expected = ReadFromStandardBsdf(*OpenTestData("paint"));
+  ASSERT_TRUE(expected) << expected.error();
+  auto bsdf =
+      ReadFromStandardBsdf(*OpenTestData("paint"), {.series_padding = 8});
+  ASSERT_TRUE(bsdf) << bsdf.error();
+
+  auto expected_result = TruncateSeries(*expected, 0.01);
+  ASSERT_TRUE(expected_result) << expected_result.error();
+  auto result = TruncateSeries(*bsdf, 0.01);
+  ASSERT_TRUE(result) << result.error();
+  EXPECT_EQ(expected_result->max_relative_error, result->max_relative_error);
+  EXPECT_EQ(expected_result->max_absolute_error, result->max_absolute_error);
+
+  // Truncated series keep their padding, which must be zeroed
+  size_t num_coefficients = 0;
+  for (size_t i = 0; i < bsdf->series_extents.size(); i++) {
+    auto [expected_offset, length] = expected->series_extents[i];
+    auto [offset, padded_length] = bsdf->series_extents[i];
+    ASSERT_EQ(length, padded_length);
+    EXPECT_EQ(num_coefficients, offset);
+
+    for (size_t k = 0; k < GetPaddedSeriesLength(*bsdf, length); k++) {
+      float expected_y =
+          k < length ? expected->y_coefficients[expected_offset + k] : 0.0f;
+      float expected_r =
+          k < length ? expected->r_coefficients[expected_offset + k] : 0.0f;
+      float expected_b =
+          k < length ? expected->b_coefficients[expected_offset + k] : 0.0f;
+      EXPECT_EQ(expected_y, bsdf->y_coefficients[offset + k]);
+      EXPECT_EQ(expected_r, bsdf->r_coefficients[offset + k]);
+      EXPECT_EQ(expected_b, bsdf->b_coefficients[offset + k]);
+    }
+
+    num_coefficients += GetPaddedSeriesLength(*bsdf, length);
+  }
+
+  EXPECT_EQ(num_coefficients, bsdf->y_coefficients.size());
+}
+
+TEST(TruncateSeries, InterleavedColorChannels) {
+  auto expected = ReadFromStandardBsdf(*OpenTestData("paint"),
+                                       {.series_padding = 4});
+  ASSERT_TRUE(expected) << expected.error();
+  auto bsdf = ReadFromStandardBsdf(
+      *OpenTestData("paint"),
+      {.series_padding = 4, .interleave_color_channels = true});
+  ASSERT_TRUE(bsdf) << bsdf.error();
+  ASSERT_TRUE(bsdf->interleaved_color_channels);
+
+  auto expected_result = TruncateSeries(*expected, 0.01);
+  ASSERT_TRUE(expected_result) << expected_result.error();
+  auto result = TruncateSeries(*bsdf, 0.01);
+  ASSERT_TRUE(result) << result.error();
+  EXPECT_EQ(expected_result->max_relative_error, result->max_relative_error);
+  EXPECT_EQ(expected_result->max_absolute_error, result->max_absolute_error);
+  EXPECT_EQ(expected_result->num_coefficients_removed,
+            result->num_coefficients_removed);
+  EXPECT_EQ(expected_result->bytes_saved, result->bytes_saved);
+
+  // Each channel of a truncated series keeps its padding, which must be zeroed
+  const AlignedVector<float>* channels[3] = {&expected->y_coefficients,
+                                             &expected->r_coefficients,
+                                             &expected->b_coefficients};
+  size_t num_coefficients = 0;
+  for (size_t i = 0; i < bsdf->series_extents.size(); i++) {
+    auto [expected_offset, expected_length] = expected->series_extents[i];
+    auto [offset, length] = bsdf->series_extents[i];
+    ASSERT_EQ(expected_length, length);
+    EXPECT_EQ(num_coefficients, offset);
+
+    size_t stride = GetSeriesChannelStride(*bsdf, length);
+    for (size_t c = 0; c < 3; c++) {
+      for (size_t k = 0; k < stride; k++) {
+        EXPECT_EQ((*channels[c])[expected_offset + k],
+                  bsdf->y_coefficients[offset + c * stride + k]);
+      }
+    }
+
+    num_coefficients += 3 * stride;
+  }
+
+  EXPECT_EQ(num_coefficients, bsdf->y_coefficients.size());
+}
+
+TEST(TruncateSeries, HalfCoefficients) {
+  auto bsdf = ReadFromStandardBsdf(
+      *OpenTestData("paint"),
+      {.coefficient_format = CoefficientFormat::kFloat16});
+  ASSERT_TRUE(bsdf) << bsdf.error();
+
+  auto result = TruncateSeries(*bsdf, 0.01);
+  ASSERT_FALSE(result);
+  EXPECT_EQ("The coefficients must be truncated before they are converted",
+            result.error());
+}
+
+}  // namespace
+}  // namespace libfbsdf
@@ -0,0 +1,209 @@
+#include "libfbsdf/readers/standard_bsdf_batch_reader.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <ios>
+#include <istream>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "libfbsdf/gzip_istream.h"
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+
+namespace libfbsdf {
+namespace {
+
+typedef std::vector<std::expected<ReadFromStandardBsdfResult, std::string>>
+    BatchResult;
+
+// A queue of task indices owned by one worker. The owner takes tasks from the
+// front while idle workers steal from the back.
+class TaskQueue {
+ public:
+  void Push(size_t task) { tasks_.push_back(task); }
+
+  std::optional<size_t> Pop() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (tasks_.empty()) {
+      return std::nullopt;
+    }
+
+    size_t task = tasks_.front();
+    tasks_.pop_front();
+    return task;
+  }
+
+  std::optional<size_t> Steal() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (tasks_.empty()) {
+      return std::nullopt;
+    }
+
+    size_t task = tasks_.back();
+    tasks_.pop_back();
+    return task;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::deque<size_t> tasks_;
+};
+
+// Runs `run_task` once for each of `num_tasks` tasks on a pool of work stealing
+// threads. Tasks with larger `task_sizes` are started first.
+void RunTasks(std::span<const uintmax_t> task_sizes, size_t num_threads,
+              const std::function<void(size_t)>& run_task) {
+  std::vector<size_t> order(task_sizes.size());
+  std::iota(order.begin(), order.end(), 0u);
+  std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+    return task_sizes[lhs] > task_sizes[rhs];
+  });
+
+  if (num_threads == 0) {
+    num_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  num_threads = std::max<size_t>(1u, std::min(num_threads, order.size()));
+
+  // Tasks are dealt out round-robin so that each worker starts with its share
+  // of the largest tasks
+  std::vector<TaskQueue> queues(num_threads);
+  for (size_t i = 0; i < order.size(); i++) {
+    queues[i % num_threads].Push(order[i]);
+  }
+
+  // Since no tasks are added once the workers start, a worker can exit as soon
+  // as it fails to find a task in any queue
+  auto worker = [&](size_t worker_index) {
+    for (;;) {
+      std::optional<size_t> task = queues[worker_index].Pop();
+      for (size_t i = 1; !task && i < num_threads; i++) {
+        task = queues[(worker_index + i) % num_threads].Steal();
+      }
+
+      if (!task) {
+        return;
+      }
+
+      run_task(*task);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < num_threads; i++) {
+    threads.emplace_back(worker, i);
+  }
+
+  worker(0);
+
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+bool IsGzipCompressed(std::istream& input) {
+  char magic[2];
+  bool result = input.read(magic, sizeof(magic)) && magic[0] == '\x1f' &&
+                magic[1] == '\x8b';
+  input.clear();
+  input.seekg(0);
+  return result;
+}
+
+std::expected<ReadFromStandardBsdfResult, std::string> ReadFromPath(
+    const std::filesystem::path& path,
+    const ReadFromStandardBsdfOptions& options) {
+  std::ifstream input(path, std::ios::in | std::ios::binary);
+  if (!input) {
+    return std::unexpected("Failed to open file");
+  }
+
+  if (IsGzipCompressed(input)) {
+    GzipIstream decompressed(input);
+    std::expected<ReadFromStandardBsdfResult, std::string> result =
+        ReadFromStandardBsdf(decompressed, options);
+
+    // The gzip trailer is only checked once the rest of the input has been
+    // decompressed
+    decompressed.clear();
+    decompressed.ignore(std::numeric_limits<std::streamsize>::max());
+    if (decompressed.failed()) {
+      return std::unexpected("Failed to decompress file");
+    }
+
+    return result;
+  }
+
+  return ReadFromStandardBsdf(input, options);
+}
+
+uintmax_t RemainingSize(std::istream& input) {
+  std::istream::pos_type start = input.tellg();
+  if (start == std::istream::pos_type(-1) ||
+      !input.seekg(0, std::ios_base::end)) {
+    input.clear();
+    return 0;
+  }
+
+  std::istream::pos_type end = input.tellg();
+  input.seekg(start);
+
+  if (end == std::istream::pos_type(-1) || end < start) {
+    return 0;
+  }
+
+  return static_cast<uintmax_t>(end - start);
+}
+
+}  // namespace
+
+std::vector<std::expected<ReadFromStandardBsdfResult, std::string>>
+ReadFromStandardBsdfBatch(std::span<const std::filesystem::path> paths,
+                          size_t num_threads,
+                          const ReadFromStandardBsdfOptions& options) {
+  std::vector<uintmax_t> sizes;
+  for (const std::filesystem::path& path : paths) {
+    std::error_code error;
+    uintmax_t size = std::filesystem::file_size(path, error);
+    sizes.push_back(error ? 0u : size);
+  }
+
+  BatchResult results(paths.size(), std::unexpected(std::string()));
+  RunTasks(sizes, num_threads, [&](size_t task) {
+    results[task] = ReadFromPath(paths[task], options);
+  });
+
+  return results;
+}
+
+std::vector<std::expected<ReadFromStandardBsdfResult, std::string>>
+ReadFromStandardBsdfBatch(std::span<std::istream* const> inputs,
+                          size_t num_threads,
+                          const ReadFromStandardBsdfOptions& options) {
+  std::vector<uintmax_t> sizes;
+  for (std::istream* input : inputs) {
+    sizes.push_back(RemainingSize(*input));
+  }
+
+  BatchResult results(inputs.size(), std::unexpected(std::string()));
+  RunTasks(sizes, num_threads, [&](size_t task) {
+    results[task] = ReadFromStandardBsdf(*inputs[task], options);
+  });
+
+  return results;
+}
+
+}  // namespace libfbsdf
@@ -0,0 +1,44 @@
+#ifndef _LIBFBSDF_READERS_STANDARD_BSDF_BATCH_READER_
+#define _LIBFBSDF_READERS_STANDARD_BSDF_BATCH_READER_
+
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <istream>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+
+namespace libfbsdf {
+
+// Reads a batch of "standard" BSDF files in parallel. Each file is read as if
+// by `ReadFromStandardBsdf` and files that are gzip compressed are
+// transparently decompressed while they are read.
+//
+// The files are spread across a pool of `num_threads` threads (including the
+// calling thread) that steal work from each other as they become idle, with the
+// largest files scheduled first. If `num_threads` is zero, the number of
+// hardware threads is used instead. Each file is read with `options`.
+//
+// Returns one result per input path in the same order as `paths`.
+std::vector<std::expected<ReadFromStandardBsdfResult, std::string>>
+ReadFromStandardBsdfBatch(std::span<const std::filesystem::path> paths,
+                          size_t num_threads = 0,
+                          const ReadFromStandardBsdfOptions& options = {});
+
+// Reads a batch of "standard" BSDF inputs in parallel. Behaves the same as the
+// overload above except that inputs are read from the streams provided. Inputs
+// are not decompressed and inputs that are not seekable are scheduled last.
+//
+// NOTE: Behavior is undefined if any input is not a binary stream or if the
+//       same stream is passed more than once
+std::vector<std::expected<ReadFromStandardBsdfResult, std::string>>
+ReadFromStandardBsdfBatch(std::span<std::istream* const> inputs,
+                          size_t num_threads = 0,
+                          const ReadFromStandardBsdfOptions& options = {});
+
+}  // namespace libfbsdf
+
+#endif  // _LIBFBSDF_READERS_STANDARD_BSDF_BATCH_READER_
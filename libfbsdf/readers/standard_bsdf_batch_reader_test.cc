@@ -0,0 +1,181 @@
+#include "libfbsdf/readers/standard_bsdf_batch_reader.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <istream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "googletest/include/gtest/gtest.h"
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+#include "libfbsdf/test_bsdf_writer.h"
+#include "test_data/test_data.h"
+
+namespace libfbsdf {
+namespace {
+
+using ::libfbsdf::testing::BsdfData;
+using ::libfbsdf::testing::Flags;
+using ::libfbsdf::testing::kTestDataFiles;
+using ::libfbsdf::testing::MakeBsdfFile;
+using ::libfbsdf::testing::OpenTestData;
+
+void ExpectEqual(const ReadFromStandardBsdfResult& actual,
+                 const ReadFromStandardBsdfResult& expected) {
+  EXPECT_EQ(actual.elevational_samples, expected.elevational_samples);
+  EXPECT_EQ(actual.cdf, expected.cdf);
+  EXPECT_EQ(actual.series_extents, expected.series_extents);
+  EXPECT_EQ(actual.series_offsets, expected.series_offsets);
+  EXPECT_EQ(actual.series_lengths, expected.series_lengths);
+  EXPECT_EQ(actual.y_coefficients, expected.y_coefficients);
+  EXPECT_EQ(actual.r_coefficients, expected.r_coefficients);
+  EXPECT_EQ(actual.b_coefficients, expected.b_coefficients);
+  EXPECT_EQ(actual.index_of_refraction, expected.index_of_refraction);
+  EXPECT_EQ(actual.roughness_top, expected.roughness_top);
+  EXPECT_EQ(actual.roughness_bottom, expected.roughness_bottom);
+}
+
+std::string MakeValidBsdfFile() {
+  BsdfData data(std::vector<float>({-1.0f, 0.0f, 1.0f}), 1, 1);
+  for (size_t i = 0; i < 3; i++) {
+    for (size_t j = 0; j < 3; j++) {
+      data.AddCoefficient(0, i, j, 1.0f);
+      data.SetCdf(0, i, j, 0.0f);
+    }
+  }
+
+  Flags flags{.is_bsdf = true, .uses_harmonic_extrapolation = false};
+  return MakeBsdfFile(flags, data, {}, {}, "", 1.0f, 2.0f, 3.0f);
+}
+
+TEST(StandardBsdfBatchReader, EmptyBatch) {
+  std::vector<std::filesystem::path> paths;
+  EXPECT_TRUE(ReadFromStandardBsdfBatch(paths).empty());
+
+  std::vector<std::istream*> inputs;
+  EXPECT_TRUE(ReadFromStandardBsdfBatch(inputs).empty());
+}
+
+TEST(StandardBsdfBatchReader, MissingFile) {
+  std::vector<std::filesystem::path> paths = {
+      std::filesystem::temp_directory_path() / "libfbsdf_does_not_exist.bsdf"};
+
+  auto results = ReadFromStandardBsdfBatch(paths);
+  ASSERT_EQ(results.size(), 1u);
+  ASSERT_FALSE(results[0]);
+  EXPECT_EQ(results[0].error(), "Failed to open file");
+}
+
+TEST(StandardBsdfBatchReader, CorruptedGzipTrailer) {
+  const std::filesystem::path& valid_path =
+      kTestDataFiles.at("roughgold_alpha_0.2").path;
+
+  std::ifstream valid(valid_path, std::ios::in | std::ios::binary);
+  std::string contents((std::istreambuf_iterator<char>(valid)),
+                       std::istreambuf_iterator<char>());
+  ASSERT_GE(contents.size(), 8u);
+
+  // The gzip trailer holds the CRC32 of the decompressed data followed by its
+  // size
+  contents[contents.size() - 8u] ^= 0xFF;
+
+  std::filesystem::path corrupted_path =
+      std::filesystem::temp_directory_path() /
+      "libfbsdf_corrupted_trailer.bsdf.gz";
+  std::ofstream(corrupted_path, std::ios::out | std::ios::binary) << contents;
+
+  std::vector<std::filesystem::path> paths = {valid_path, corrupted_path};
+  auto results = ReadFromStandardBsdfBatch(paths);
+  std::filesystem::remove(corrupted_path);
+
+  ASSERT_EQ(results.size(), 2u);
+  EXPECT_TRUE(results[0]) << results[0].error();
+  ASSERT_FALSE(results[1]);
+  EXPECT_EQ(results[1].error(), "Failed to decompress file");
+}
+
+TEST(StandardBsdfBatchReader, StreamsKeepInputOrder) {
+  BsdfData data(std::vector<float>({0.0f}), 1, 1);
+  Flags flags{.is_bsdf = false, .uses_harmonic_extrapolation = false};
+  std::stringstream valid(MakeValidBsdfFile());
+  std::stringstream empty("");
+  std::stringstream not_a_bsdf(
+      MakeBsdfFile(flags, data, {}, {}, "", 1.0f, 1.0f, 1.0f));
+  std::vector<std::istream*> inputs = {&valid, &empty, &not_a_bsdf};
+
+  for (size_t num_threads : {0u, 1u, 2u, 8u}) {
+    for (std::istream* input : inputs) {
+      input->clear();
+      input->seekg(0);
+    }
+
+    auto results = ReadFromStandardBsdfBatch(inputs, num_threads);
+    ASSERT_EQ(results.size(), 3u);
+
+    ASSERT_TRUE(results[0]) << results[0].error();
+    EXPECT_EQ(results[0]->elevational_samples.size(), 3u);
+    EXPECT_EQ(results[0]->y_coefficients.size(), 9u);
+
+    ASSERT_FALSE(results[1]);
+    EXPECT_EQ(results[1].error(), "The input must start with the magic string");
+
+    ASSERT_FALSE(results[2]);
+    EXPECT_EQ(results[2].error(),
+              "The input does not indicate that it is a BSDF");
+  }
+}
+
+TEST(StandardBsdfBatchReader, TestDataMatchesSequentialReads) {
+  std::vector<std::filesystem::path> paths;
+  std::vector<std::unique_ptr<std::istream>> expected_inputs;
+  for (const auto& [name, file_params] : kTestDataFiles) {
+    paths.push_back(file_params.path);
+    expected_inputs.push_back(OpenTestData(name));
+  }
+
+  for (size_t num_threads : {1u, 3u}) {
+    auto results = ReadFromStandardBsdfBatch(paths, num_threads);
+    ASSERT_EQ(results.size(), paths.size());
+
+    for (size_t i = 0; i < results.size(); i++) {
+      expected_inputs[i]->clear();
+      expected_inputs[i]->seekg(0);
+      auto expected = ReadFromStandardBsdf(*expected_inputs[i]);
+      ASSERT_TRUE(expected) << expected.error();
+      ASSERT_TRUE(results[i]) << results[i].error();
+      ExpectEqual(*results[i], *expected);
+    }
+  }
+}
+
+TEST(StandardBsdfBatchReader, PassesOptions) {
+  std::vector<std::filesystem::path> paths;
+  std::vector<std::unique_ptr<std::istream>> expected_inputs;
+  for (const auto& [name, file_params] : kTestDataFiles) {
+    paths.push_back(file_params.path);
+    expected_inputs.push_back(OpenTestData(name));
+  }
+
+  ReadFromStandardBsdfOptions options{.build_elevational_guide = true,
+                                      .luminance_only = true,
+                                      .compact_series_extents = true};
+  auto results = ReadFromStandardBsdfBatch(paths, 2, options);
+  ASSERT_EQ(results.size(), paths.size());
+
+  for (size_t i = 0; i < results.size(); i++) {
+    auto expected = ReadFromStandardBsdf(*expected_inputs[i], options);
+    ASSERT_TRUE(expected) << expected.error();
+    ASSERT_TRUE(results[i]) << results[i].error();
+    ExpectEqual(*results[i], *expected);
+    EXPECT_EQ(results[i]->elevational_guide.intervals,
+              expected->elevational_guide.intervals);
+  }
+}
+
+}  // namespace
+}  // namespace libfbsdf
@@ -1,13 +1,21 @@
 #include "libfbsdf/readers/standard_bsdf_reader.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <expected>
 #include <istream>
+#include <limits>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "libfbsdf/aligned_vector.h"
 #include "libfbsdf/bsdf_reader.h"
+#include "libfbsdf/half_float.h"
+#include "libfbsdf/readers/elevational_guide.h"
 #include "libfbsdf/readers/validating_bsdf_reader.h"
 
 namespace libfbsdf {
@@ -15,10 +23,19 @@ namespace {
 
 class StandardBsdfReader final : public ValidatingBsdfReader {
  public:
+  StandardBsdfReader(bool luminance_only, bool interleave_color_channels,
+                     size_t series_padding)
+      : luminance_only_(luminance_only),
+        interleave_color_channels_(interleave_color_channels),
+        series_padding_(series_padding) {}
+
   std::vector<float> elevational_samples;
   std::vector<float> cdf;
-  std::vector<std::pair<uint32_t, uint32_t>> interleaved_extents;
-  std::vector<float> interleaved_coefficients;
+  AlignedVector<float> y_coefficients;
+  AlignedVector<float> r_coefficients;
+  AlignedVector<float> b_coefficients;
+  std::vector<std::pair<size_t, size_t>> series_extents;
+  bool interleaved_color_channels = false;
   uint32_t num_color_channels;
   float index_of_refraction;
   float roughness_top;
@@ -39,10 +56,30 @@ class StandardBsdfReader final : public ValidatingBsdfReader {
       std::vector<float> values) override;
 
   std::expected<void, std::string> HandleSeries(
-      std::vector<std::pair<uint32_t, uint32_t>> series_extents) override;
+      std::vector<std::pair<uint32_t, uint32_t>> series) override;
+
+  std::expected<void, std::string> HandleCoefficientRange(
+      size_t first_index, std::span<const float> coefficients) override;
+
+  // The range of the coefficients array in the input covered by the first
+  // basis function of a series along with the location of the series in each
+  // of the output channels. The channels of interleaved outputs are stored
+  // `output_channel_stride` coefficients apart in the same array.
+  struct Interval {
+    size_t input_begin;
+    size_t input_end;
+    size_t length;
+    size_t output_offset;
+    size_t output_channel_stride;
+  };
 
-  std::expected<void, std::string> HandleCoefficients(
-      std::vector<float> coefficients) override;
+  bool luminance_only_;
+  bool interleave_color_channels_;
+  size_t series_padding_;
+
+  // Sorted by `input_begin`
+  std::vector<Interval> intervals_;
+  size_t first_active_interval_ = 0;
 };
 
 std::expected<BsdfReader::Options, std::string> StandardBsdfReader::Start(
@@ -71,7 +108,13 @@ std::expected<BsdfReader::Options, std::string> StandardBsdfReader::Start(
   this->roughness_top = roughness_top;
   this->roughness_bottom = roughness_bottom;
 
-  return Options();
+  // Only the first basis function is used. Its coefficients are interleaved
+  // with those of the other basis functions and are filtered out in
+  // `HandleCoefficientRange`.
+  Options options;
+  options.max_cdf_basis_functions = 1;
+
+  return options;
 }
 
 std::expected<void, std::string> StandardBsdfReader::HandleElevationalSamples(
@@ -83,30 +126,203 @@ std::expected<void, std::string> StandardBsdfReader::HandleElevationalSamples(
 
 std::expected<void, std::string> StandardBsdfReader::HandleCdf(
     std::vector<float> values) {
-  if (cdf.empty()) {
-    cdf = std::move(values);
-  }
+  cdf = std::move(values);
 
   return std::expected<void, std::string>();
 }
 
 std::expected<void, std::string> StandardBsdfReader::HandleSeries(
-    std::vector<std::pair<uint32_t, uint32_t>> series_extents) {
-  interleaved_extents = std::move(series_extents);
+    std::vector<std::pair<uint32_t, uint32_t>> series) {
+  // The series are provided before any of the coefficients, which allows the
+  // channel vectors to be sized exactly up front and each coefficient to be
+  // scattered directly into its final location as it is read.
+  series_extents.reserve(series.size());
+  intervals_.reserve(series.size());
+
+  // The luminance channel comes first in each series, so the intervals of a
+  // luminance only read simply end where the red channel begins
+  size_t num_channels_read = luminance_only_ ? 1u : num_color_channels;
+  interleaved_color_channels =
+      interleave_color_channels_ && num_channels_read == 3;
+
+  size_t num_coefficients = 0;
+  size_t num_channels_stored = interleaved_color_channels ? 3u : 1u;
+  for (auto [offset, length] : series) {
+    size_t remaining = (std::numeric_limits<size_t>::max() - num_coefficients) /
+                       num_channels_stored;
+    if (remaining < series_padding_ - 1u ||
+        static_cast<size_t>(length) > remaining - (series_padding_ - 1u)) {
+      return std::unexpected("The input has too many coefficients to be padded");
+    }
+
+    series_extents.emplace_back(num_coefficients, length);
+
+    size_t padded_length =
+        (static_cast<size_t>(length) + series_padding_ - 1u) &
+        ~(series_padding_ - 1u);
+    size_t channel_stride = interleaved_color_channels ? padded_length : 0u;
+
+    if (length != 0) {
+      size_t input_end =
+          offset + static_cast<size_t>(length) * num_channels_read;
+      intervals_.push_back({.input_begin = offset,
+                            .input_end = input_end,
+                            .length = length,
+                            .output_offset = num_coefficients,
+                            .output_channel_stride = channel_stride});
+    }
+
+    // Padding is left zeroed when the channel vectors are resized below
+    num_coefficients += num_channels_stored * padded_length;
+  }
+
+  // Series are usually stored in order so sorting can typically be skipped
+  auto by_input_begin = [](const Interval& lhs, const Interval& rhs) {
+    return lhs.input_begin < rhs.input_begin;
+  };
+
+  if (!std::is_sorted(intervals_.begin(), intervals_.end(), by_input_begin)) {
+    std::sort(intervals_.begin(), intervals_.end(), by_input_begin);
+  }
+
+  y_coefficients.resize(num_coefficients);
+  if (num_channels_read == 3 && !interleaved_color_channels) {
+    r_coefficients.resize(num_coefficients);
+    b_coefficients.resize(num_coefficients);
+  }
+
   return std::expected<void, std::string>();
 }
 
-std::expected<void, std::string> StandardBsdfReader::HandleCoefficients(
-    std::vector<float> coefficients) {
-  interleaved_coefficients = std::move(coefficients);
+std::expected<void, std::string> StandardBsdfReader::HandleCoefficientRange(
+    size_t first_index, std::span<const float> coefficients) {
+  size_t end_index = first_index + coefficients.size();
+
+  while (first_active_interval_ < intervals_.size() &&
+         intervals_[first_active_interval_].input_end <= first_index) {
+    first_active_interval_ += 1;
+  }
+
+  AlignedVector<float>* outputs[3] = {&y_coefficients, &r_coefficients,
+                                    &b_coefficients};
+  if (interleaved_color_channels) {
+    outputs[1] = &y_coefficients;
+    outputs[2] = &y_coefficients;
+  }
+  for (size_t i = first_active_interval_;
+       i < intervals_.size() && intervals_[i].input_begin < end_index; i++) {
+    const Interval& interval = intervals_[i];
+
+    size_t begin = std::max(interval.input_begin, first_index);
+    size_t end = std::min(interval.input_end, end_index);
+    while (begin < end) {
+      size_t channel = (begin - interval.input_begin) / interval.length;
+      size_t index = (begin - interval.input_begin) % interval.length;
+      size_t count = std::min(end - begin, interval.length - index);
+
+      std::copy_n(coefficients.begin() + (begin - first_index), count,
+                  outputs[channel]->begin() + interval.output_offset +
+                      channel * interval.output_channel_stride + index);
+
+      begin += count;
+    }
+  }
+
   return std::expected<void, std::string>();
 }
 
+// Converts `values` to `format`, storing the bits in `output`. Returns the
+// largest relative error of any non-zero value, or infinity if any value
+// overflows.
+double ConvertChannel(std::span<const float> values, CoefficientFormat format,
+                      AlignedVector<uint16_t>& output) {
+  output.resize(values.size());
+
+  float (*widen)(uint16_t);
+  if (format == CoefficientFormat::kFloat16) {
+    FloatsToFloat16(values, output);
+    widen = Float16ToFloat;
+  } else {
+    FloatsToBFloat16(values, output);
+    widen = BFloat16ToFloat;
+  }
+
+  double max_error = 0.0;
+  for (size_t i = 0; i < values.size(); i++) {
+    if (values[i] != 0.0f) {
+      double value = values[i];
+      max_error = std::max(
+          max_error, std::abs(widen(output[i]) - value) / std::abs(value));
+    }
+  }
+
+  return max_error;
+}
+
 }  // namespace
 
+std::expected<void, std::string> ConvertCoefficients(
+    ReadFromStandardBsdfResult& bsdf, CoefficientFormat format) {
+  if (bsdf.coefficient_format != CoefficientFormat::kFloat32) {
+    return std::unexpected("The coefficients have already been converted");
+  }
+
+  if (bsdf.shared_coefficients) {
+    return std::unexpected(
+        "Coefficients shared with other BSDFs cannot be converted");
+  }
+
+  if (format == CoefficientFormat::kFloat32) {
+    return std::expected<void, std::string>();
+  }
+
+  // Every channel is converted before any is committed so that `bsdf` is left
+  // unchanged on failure
+  AlignedVector<float>* inputs[3] = {&bsdf.y_coefficients, &bsdf.r_coefficients,
+                                     &bsdf.b_coefficients};
+  AlignedVector<uint16_t> outputs[3];
+  double max_error = 0.0;
+  for (size_t c = 0; c < 3; c++) {
+    max_error =
+        std::max(max_error, ConvertChannel(*inputs[c], format, outputs[c]));
+  }
+
+  if (std::isinf(max_error)) {
+    if (format == CoefficientFormat::kBFloat16) {
+      return std::unexpected(
+          "The coefficients are too large to be stored as bfloat16");
+    }
+
+    return std::unexpected(
+        "The coefficients are too large to be stored as float16");
+  }
+
+  bsdf.coefficient_format = format;
+  bsdf.y_half_coefficients = std::move(outputs[0]);
+  bsdf.r_half_coefficients = std::move(outputs[1]);
+  bsdf.b_half_coefficients = std::move(outputs[2]);
+  bsdf.max_conversion_error = max_error;
+  for (AlignedVector<float>* input : inputs) {
+    *input = AlignedVector<float>();
+  }
+
+  return std::expected<void, std::string>();
+}
+
 std::expected<ReadFromStandardBsdfResult, std::string> ReadFromStandardBsdf(
-    std::istream& input) {
-  StandardBsdfReader bsdf_reader;
+    std::istream& input, const ReadFromStandardBsdfOptions& options) {
+  if (options.series_padding == 0 ||
+      (options.series_padding & (options.series_padding - 1u)) != 0) {
+    return std::unexpected("series_padding must be a power of two");
+  }
+
+  if (options.series_padding > kMaxSeriesPadding) {
+    return std::unexpected("series_padding must be at most 64");
+  }
+
+  StandardBsdfReader bsdf_reader(options.luminance_only,
+                                 options.interleave_color_channels,
+                                 options.series_padding);
   if (std::expected<void, std::string> error = bsdf_reader.ReadFrom(input);
       !error) {
     return std::unexpected(std::move(error.error()));
@@ -124,19 +340,39 @@ std::expected<ReadFromStandardBsdfResult, std::string> ReadFromStandardBsdf(
   result.roughness_top = bsdf_reader.roughness_top;
   result.roughness_bottom = bsdf_reader.roughness_bottom;
 
-  std::vector<float>* outputs[3] = {
-      &result.y_coefficients, &result.r_coefficients, &result.b_coefficients};
-  for (auto [start, length] : bsdf_reader.interleaved_extents) {
-    result.series_extents.emplace_back(result.y_coefficients.size(), length);
-
-    size_t next_coefficient = start;
-    for (uint32_t channel = 0; channel < bsdf_reader.num_color_channels;
-         channel++) {
-      for (size_t i = 0; i < length; i++) {
-        outputs[channel]->push_back(
-            bsdf_reader.interleaved_coefficients[next_coefficient++]);
-      }
+  result.y_coefficients = std::move(bsdf_reader.y_coefficients);
+  result.r_coefficients = std::move(bsdf_reader.r_coefficients);
+  result.b_coefficients = std::move(bsdf_reader.b_coefficients);
+  result.series_extents = std::move(bsdf_reader.series_extents);
+  result.series_padding = options.series_padding;
+  result.interleaved_color_channels = bsdf_reader.interleaved_color_channels;
+
+  if (options.compact_series_extents &&
+      result.y_coefficients.size() <= std::numeric_limits<uint32_t>::max() &&
+      std::all_of(result.series_extents.begin(), result.series_extents.end(),
+                  [](const std::pair<size_t, size_t>& extent) {
+                    return extent.second <=
+                           std::numeric_limits<uint16_t>::max();
+                  })) {
+    result.series_offsets.reserve(result.series_extents.size());
+    result.series_lengths.reserve(result.series_extents.size());
+    for (auto [offset, length] : result.series_extents) {
+      result.series_offsets.push_back(static_cast<uint32_t>(offset));
+      result.series_lengths.push_back(static_cast<uint16_t>(length));
     }
+
+    result.series_extents = {};
+  }
+
+  if (options.build_elevational_guide) {
+    result.elevational_guide =
+        BuildElevationalGuide(result.elevational_samples);
+  }
+
+  if (std::expected<void, std::string> error =
+          ConvertCoefficients(result, options.coefficient_format);
+      !error) {
+    return std::unexpected(std::move(error.error()));
   }
 
   return result;
@@ -5,24 +5,132 @@
 #include <cstdint>
 #include <expected>
 #include <istream>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "libfbsdf/aligned_vector.h"
+#include "libfbsdf/half_float.h"
+#include "libfbsdf/readers/elevational_guide.h"
+
 namespace libfbsdf {
 
+// The format the coefficients of a BSDF are stored in. The 16-bit formats
+// halve the memory used by the coefficients at the cost of precision: float16
+// keeps 11 significant bits but cannot represent magnitudes of 65520 or more,
+// while bfloat16 keeps only 8 significant bits but the full range of a float.
+enum class CoefficientFormat {
+  kFloat32,
+  kFloat16,
+  kBFloat16,
+};
+
+// The 32-bit coefficients of several BSDFs stored once for all of them by
+// `DeduplicateSeries`, in the same layout as in `ReadFromStandardBsdfResult`.
+struct SharedCoefficients {
+  AlignedVector<float> y_coefficients;
+  AlignedVector<float> r_coefficients;
+  AlignedVector<float> b_coefficients;
+};
+
 struct ReadFromStandardBsdfResult {
   std::vector<float> elevational_samples;
   std::vector<float> cdf;
-  std::vector<float> y_coefficients;
-  std::vector<float> r_coefficients;
-  std::vector<float> b_coefficients;
+
+  // The coefficients of each color channel. Each series is followed by zeros
+  // up to a multiple of `series_padding` coefficients. If the color channels
+  // are interleaved, the padded luminance, red, and blue coefficients of each
+  // series are instead stored one after another in `y_coefficients` and
+  // `r_coefficients` and `b_coefficients` are left empty. Either way, the
+  // luminance coefficients of a series start at its offset.
+  AlignedVector<float> y_coefficients;
+  AlignedVector<float> r_coefficients;
+  AlignedVector<float> b_coefficients;
+  size_t series_padding = 1;
+  bool interleaved_color_channels = false;
+
+  // If the coefficients are stored in a 16-bit format, the bits of each
+  // coefficient are instead stored in these arrays in the same layout and the
+  // arrays above are left empty. `max_conversion_error` is the largest relative
+  // error of any non-zero coefficient after conversion, which is one for
+  // coefficients too small to be represented as anything but zero.
+  CoefficientFormat coefficient_format = CoefficientFormat::kFloat32;
+  AlignedVector<uint16_t> y_half_coefficients;
+  AlignedVector<uint16_t> r_half_coefficients;
+  AlignedVector<uint16_t> b_half_coefficients;
+  double max_conversion_error = 0.0;
+
+  // If the series of this BSDF have been deduplicated together with those of
+  // other BSDFs, the 32-bit coefficients are instead stored in these arrays
+  // shared between them and the arrays above are left empty. Null otherwise.
+  // `GetYCoefficients` and its siblings read whichever arrays are in use.
+  std::shared_ptr<const SharedCoefficients> shared_coefficients;
+
+  // The offset and length of the series of each pair of elevational samples.
+  // These are stored either as pairs in `series_extents` or, if compact series
+  // extents were requested, as 32-bit offsets and 16-bit lengths in
+  // `series_offsets` and `series_lengths` with the other layout left empty.
+  // `GetSeriesExtent` reads an extent from either layout.
   std::vector<std::pair<size_t, size_t>> series_extents;
+  std::vector<uint32_t> series_offsets;
+  std::vector<uint16_t> series_lengths;
+
+  // The factor the coefficients at the extent of each series must be scaled by
+  // to give that series, which differs from one only for series folded onto
+  // their reciprocal by `FoldReciprocalSeries`. Empty unless series have been
+  // folded. `GetSeriesScale` reads a scale whether or not this is empty.
+  std::vector<float> series_scales;
+
+  ElevationalGuide elevational_guide;  // Empty unless requested
   float index_of_refraction;
   float roughness_top;
   float roughness_bottom;
 };
 
+// The largest supported series padding. Padding a series of floats to 64
+// coefficients already fills four 64 byte cache lines, so larger paddings only
+// waste memory.
+inline constexpr size_t kMaxSeriesPadding = 64u;
+
+// Controls the optional work performed by `ReadFromStandardBsdf`.
+struct ReadFromStandardBsdfOptions {
+  // If true, the result also contains a guide for locating the intervals
+  // between its elevational samples in constant time which is used by the
+  // evaluators when present.
+  bool build_elevational_guide = false;
+
+  // If true, only the luminance channel of inputs with three color channels is
+  // stored and `r_coefficients` and `b_coefficients` are left empty, so that
+  // the result is indistinguishable from a monochrome BSDF. The coefficients of
+  // the other channels are still validated.
+  bool luminance_only = false;
+
+  // If true, the series extents are stored in `series_offsets` and
+  // `series_lengths` which take 6 bytes per series instead of 16, keeping them
+  // cache resident for typical numbers of elevational samples. Ignored if any
+  // series is longer than 65535 coefficients or if there are 2^32 or more
+  // coefficients.
+  bool compact_series_extents = false;
+
+  // Pads each series with zeros to a multiple of this many coefficients so
+  // that vectorized evaluation can load whole blocks of a series without
+  // masking. Since the coefficient arrays are aligned to 64 bytes, a padding
+  // of 16 also aligns the start of every series to 64 bytes. Must be a power
+  // of two no larger than `kMaxSeriesPadding`.
+  size_t series_padding = 1;
+
+  // If true, the color channels of inputs with three color channels are left
+  // interleaved by series as they are in the input so that evaluating a series
+  // reads a single sequential range of memory instead of one from each of
+  // three separate arrays. Ignored if `luminance_only` is true.
+  bool interleave_color_channels = false;
+
+  // The format to convert the coefficients to once they are read. See
+  // `ConvertCoefficients`.
+  CoefficientFormat coefficient_format = CoefficientFormat::kFloat32;
+};
+
 // This function allows from reading from "standard" BSDF inputs (the common
 // use case for rendering) without the need to derive from any of the BSDF
 // reader types. In addition to the typical validation performed on inputs by
@@ -32,14 +140,100 @@ struct ReadFromStandardBsdfResult {
 //  1) The BSDF bit in their header is set to true
 //  2) The harmonic extrapolation bit in their header is set to false
 //  3) Contain at least 3 elevational samples
-//  4) Contain one or more basis functions (only the first will be used)
+//  4) Contain one or more basis functions (only the first will be read)
 //  5) Have one or three color channels
 //
 // Additionally, for BSDF inputs containing three color channels, this function
 // will also handle the process of de-interleaving the three channels so that
-// each channel is stored separately and updating the series extents to match.
+// each channel is stored separately and updating the series extents to match,
+// unless interleaved color channels are requested.
 std::expected<ReadFromStandardBsdfResult, std::string> ReadFromStandardBsdf(
-    std::istream& input);
+    std::istream& input, const ReadFromStandardBsdfOptions& options = {});
+
+// Converts the 32-bit coefficients of `bsdf` to `format`, releasing the 32-bit
+// arrays and recording the largest relative error of the conversion in
+// `bsdf.max_conversion_error`. Since the evaluators widen the coefficients
+// again as they are summed, this trades precision for memory alone. Fails,
+// leaving `bsdf` unchanged, if the coefficients have already been converted,
+// if they are shared with other BSDFs, or if any coefficient is too large for
+// float16.
+std::expected<void, std::string> ConvertCoefficients(
+    ReadFromStandardBsdfResult& bsdf, CoefficientFormat format);
+
+// Returns the offset and length of the series at `index` of `bsdf` from
+// whichever layout its series extents are stored in.
+inline std::pair<size_t, size_t> GetSeriesExtent(
+    const ReadFromStandardBsdfResult& bsdf, size_t index) {
+  if (!bsdf.series_lengths.empty()) {
+    return {bsdf.series_offsets[index], bsdf.series_lengths[index]};
+  }
+
+  return bsdf.series_extents[index];
+}
+
+// Returns the factor the coefficients at the extent of the series at `index`
+// of `bsdf` must be scaled by to give that series.
+inline float GetSeriesScale(const ReadFromStandardBsdfResult& bsdf,
+                            size_t index) {
+  return bsdf.series_scales.empty() ? 1.0f : bsdf.series_scales[index];
+}
+
+// Returns the length of a series of `length` coefficients of `bsdf` including
+// its padding.
+inline size_t GetPaddedSeriesLength(const ReadFromStandardBsdfResult& bsdf,
+                                    size_t length) {
+  return (length + bsdf.series_padding - 1u) & ~(bsdf.series_padding - 1u);
+}
+
+// Returns the arrays holding the 32-bit coefficients of each color channel of
+// `bsdf`, which are its shared coefficients if it has any.
+inline const AlignedVector<float>& GetYCoefficients(
+    const ReadFromStandardBsdfResult& bsdf) {
+  return bsdf.shared_coefficients ? bsdf.shared_coefficients->y_coefficients
+                                  : bsdf.y_coefficients;
+}
+
+inline const AlignedVector<float>& GetRCoefficients(
+    const ReadFromStandardBsdfResult& bsdf) {
+  return bsdf.shared_coefficients ? bsdf.shared_coefficients->r_coefficients
+                                  : bsdf.r_coefficients;
+}
+
+inline const AlignedVector<float>& GetBCoefficients(
+    const ReadFromStandardBsdfResult& bsdf) {
+  return bsdf.shared_coefficients ? bsdf.shared_coefficients->b_coefficients
+                                  : bsdf.b_coefficients;
+}
+
+// Returns true if `bsdf` has red and blue coefficients in any layout.
+inline bool HasColor(const ReadFromStandardBsdfResult& bsdf) {
+  return bsdf.interleaved_color_channels || !GetRCoefficients(bsdf).empty() ||
+         !bsdf.r_half_coefficients.empty();
+}
+
+// Returns the luminance coefficient at `index` of `bsdf` in any format.
+inline float GetLuminanceCoefficient(const ReadFromStandardBsdfResult& bsdf,
+                                     size_t index) {
+  switch (bsdf.coefficient_format) {
+    case CoefficientFormat::kFloat16:
+      return Float16ToFloat(bsdf.y_half_coefficients[index]);
+    case CoefficientFormat::kBFloat16:
+      return BFloat16ToFloat(bsdf.y_half_coefficients[index]);
+    case CoefficientFormat::kFloat32:
+      break;
+  }
+
+  return GetYCoefficients(bsdf)[index];
+}
+
+// Returns the distance in coefficients from each color channel of a series of
+// `length` coefficients of `bsdf` to the next if its color channels are
+// interleaved, or zero if each channel is stored in a separate array.
+inline size_t GetSeriesChannelStride(const ReadFromStandardBsdfResult& bsdf,
+                                     size_t length) {
+  return bsdf.interleaved_color_channels ? GetPaddedSeriesLength(bsdf, length)
+                                         : 0u;
+}
 
 }  // namespace libfbsdf
 
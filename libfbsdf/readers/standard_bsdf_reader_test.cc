@@ -1,9 +1,12 @@
 #include "libfbsdf/readers/standard_bsdf_reader.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <expected>
 #include <istream>
+#include <limits>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -11,6 +14,10 @@
 
 #include "googlemock/include/gmock/gmock.h"
 #include "googletest/include/gtest/gtest.h"
+#include "libfbsdf/aligned_vector.h"
+#include "libfbsdf/half_float.h"
+#include "libfbsdf/readers/elevational_guide.h"
+#include "libfbsdf/readers/validating_bsdf_reader.h"
 #include "libfbsdf/test_bsdf_writer.h"
 #include "test_data/test_data.h"
 
@@ -23,10 +30,14 @@ using ::libfbsdf::testing::Flags;
 using ::libfbsdf::testing::kTestDataFiles;
 using ::libfbsdf::testing::MakeEmptyBsdfFile;
 using ::libfbsdf::testing::MakeMinimalBsdfFile;
+using ::libfbsdf::testing::MakeSyntheticBsdfFile;
 using ::libfbsdf::testing::OpenTestData;
+using ::libfbsdf::testing::SyntheticBsdfParams;
 using ::testing::ElementsAre;
 using ::testing::IsEmpty;
+using ::testing::Not;
 using ::testing::Pair;
+using ::testing::SizeIs;
 
 TEST(StandardBsdfReader, NotABsdf) {
   BsdfData data(std::vector<float>({0.0f}), 1, 1);
@@ -209,6 +220,39 @@ TEST(ValidatingBsdfReader, IgnoresExtraBasisFunctions) {
               ElementsAre(0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0));
 }
 
+TEST(StandardBsdfReader, SkipsExtraBasisFunctions) {
+  BsdfData data(std::vector<float>({-1.0f, 0.0f, 1.0f}), 2, 3);
+  for (size_t x = 0; x < 3; x++) {
+    for (size_t y = 0; y < 3; y++) {
+      for (size_t channel = 0; channel < 3; channel++) {
+        data.AddCoefficient(0, channel, x, y, 1.0f + channel);
+        data.AddCoefficient(1, channel, x, y, -1.0f);
+      }
+
+      data.SetCdf(0, x, y, 0.0f);
+      // Not a valid CDF, but the CDF of the second basis function is skipped
+      data.SetCdf(1, x, y, 2.0f);
+    }
+  }
+
+  Flags flags{.is_bsdf = true, .uses_harmonic_extrapolation = false};
+
+  std::string bsdf_file_bytes =
+      MakeBsdfFile(flags, data, {}, {}, "", 1.0f, 1.0f, 1.0f);
+  std::stringstream stream(bsdf_file_bytes);
+
+  auto result = ReadFromStandardBsdf(stream);
+  ASSERT_TRUE(result) << result.error();
+  EXPECT_THAT(result->cdf,
+              ElementsAre(0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0));
+  EXPECT_THAT(result->y_coefficients,
+              ElementsAre(1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0));
+  EXPECT_THAT(result->r_coefficients,
+              ElementsAre(2.0, 2.0, 2.0, 2.0, 2.0, 2.0, 2.0, 2.0, 2.0));
+  EXPECT_THAT(result->b_coefficients,
+              ElementsAre(3.0, 3.0, 3.0, 3.0, 3.0, 3.0, 3.0, 3.0, 3.0));
+}
+
 TEST(ValidatingBsdfReader, OneColorChannel) {
   BsdfData data(std::vector<float>({-1.0f, 0.0f, 1.0f}), 1, 1);
   data.AddCoefficient(0, 0, 0, 1.0f);
@@ -313,5 +357,495 @@ TEST(ValidatingBsdfReader, ThreeColorChannel) {
   EXPECT_EQ(3.0, result->roughness_bottom);
 }
 
+TEST(StandardBsdfReader, SyntheticBsdf) {
+  SyntheticBsdfParams params{.num_elevational_samples = 7,
+                             .num_basis_functions = 2,
+                             .num_color_channels = 3,
+                             .longest_series_length = 4};
+  std::stringstream stream(MakeSyntheticBsdfFile(params));
+
+  auto result = ReadFromStandardBsdf(stream);
+  ASSERT_TRUE(result) << result.error();
+  EXPECT_THAT(result->elevational_samples, SizeIs(7));
+  EXPECT_EQ(-1.0f, result->elevational_samples.front());
+  EXPECT_EQ(1.0f, result->elevational_samples.back());
+  EXPECT_THAT(result->cdf, SizeIs(49));
+  ASSERT_THAT(result->series_extents, SizeIs(49));
+
+  size_t num_coefficients = 0;
+  for (size_t y = 0; y < 7; y++) {
+    for (size_t x = 0; x < 7; x++) {
+      size_t length = 1 + (x + y) % 4;
+      EXPECT_THAT(result->series_extents[y * 7 + x],
+                  Pair(num_coefficients, length));
+      for (size_t k = 0; k < length; k++) {
+        EXPECT_EQ(1.0f / (k + 1.0f),
+                  result->y_coefficients[num_coefficients + k]);
+        EXPECT_EQ(2.0f / (k + 1.0f),
+                  result->r_coefficients[num_coefficients + k]);
+        EXPECT_EQ(3.0f / (k + 1.0f),
+                  result->b_coefficients[num_coefficients + k]);
+      }
+      num_coefficients += length;
+    }
+  }
+
+  EXPECT_THAT(result->y_coefficients, SizeIs(num_coefficients));
+  EXPECT_THAT(result->elevational_guide.intervals, IsEmpty());
+}
+
+TEST(StandardBsdfReader, BuildsElevationalGuide) {
+  SyntheticBsdfParams params{.num_elevational_samples = 7,
+                             .num_basis_functions = 1,
+                             .num_color_channels = 1,
+                             .longest_series_length = 4};
+  std::stringstream stream(MakeSyntheticBsdfFile(params));
+
+  auto result =
+      ReadFromStandardBsdf(stream, {.build_elevational_guide = true});
+  ASSERT_TRUE(result) << result.error();
+  EXPECT_EQ(-1.0f, result->elevational_guide.lower_bound);
+  ASSERT_THAT(result->elevational_guide.intervals, Not(IsEmpty()));
+  EXPECT_EQ(0u, result->elevational_guide.intervals.front());
+  EXPECT_EQ(5u, result->elevational_guide.intervals.back());
+  EXPECT_EQ(3u, FindElevationalInterval(result->elevational_samples,
+                                        result->elevational_guide, 0.1f));
+}
+
+TEST(StandardBsdfReader, LuminanceOnly) {
+  SyntheticBsdfParams params{.num_elevational_samples = 7,
+                             .num_basis_functions = 2,
+                             .num_color_channels = 3,
+                             .longest_series_length = 4};
+  std::stringstream stream(MakeSyntheticBsdfFile(params));
+
+  auto result = ReadFromStandardBsdf(stream, {.luminance_only = true});
+  ASSERT_TRUE(result) << result.error();
+  EXPECT_THAT(result->r_coefficients, IsEmpty());
+  EXPECT_THAT(result->b_coefficients, IsEmpty());
+  ASSERT_THAT(result->series_extents, SizeIs(49));
+
+  size_t num_coefficients = 0;
+  for (size_t y = 0; y < 7; y++) {
+    for (size_t x = 0; x < 7; x++) {
+      size_t length = 1 + (x + y) % 4;
+      EXPECT_THAT(result->series_extents[y * 7 + x],
+                  Pair(num_coefficients, length));
+      for (size_t k = 0; k < length; k++) {
+        EXPECT_EQ(1.0f / (k + 1.0f),
+                  result->y_coefficients[num_coefficients + k]);
+      }
+      num_coefficients += length;
+    }
+  }
+
+  EXPECT_THAT(result->y_coefficients, SizeIs(num_coefficients));
+}
+
+TEST(StandardBsdfReader, LuminanceOnlyStillValidates) {
+  SyntheticBsdfParams params{.num_elevational_samples = 7,
+                             .num_basis_functions = 1,
+                             .num_color_channels = 3,
+                             .longest_series_length = 4};
+  std::string bsdf_file_bytes = MakeSyntheticBsdfFile(params);
+
+  // Truncates the blue channel of the last series
+  bsdf_file_bytes.resize(bsdf_file_bytes.size() - sizeof(float));
+  std::stringstream stream(bsdf_file_bytes);
+
+  auto result = ReadFromStandardBsdf(stream, {.luminance_only = true});
+  EXPECT_FALSE(result);
+}
+
+TEST(StandardBsdfReader, InterleavedColorChannelsLuminanceOnly) {
+  SyntheticBsdfParams params{.num_elevational_samples = 7,
+                             .num_basis_functions = 1,
+                             .num_color_channels = 3,
+                             .longest_series_length = 4};
+  std::stringstream stream(MakeSyntheticBsdfFile(params));
+
+  auto result = ReadFromStandardBsdf(
+      stream, {.luminance_only = true, .interleave_color_channels = true});
+  ASSERT_TRUE(result) << result.error();
+  EXPECT_FALSE(result->interleaved_color_channels);
+  EXPECT_FALSE(HasColor(*result));
+  EXPECT_THAT(result->r_coefficients, IsEmpty());
+  EXPECT_THAT(result->b_coefficients, IsEmpty());
+}
+
+TEST(StandardBsdfReader, ConvertCoefficientsTwice) {
+  SyntheticBsdfParams params{.num_elevational_samples = 7,
+                             .num_basis_functions = 1,
+                             .num_color_channels = 1,
+                             .longest_series_length = 4};
+  std::stringstream stream(MakeSyntheticBsdfFile(params));
+  auto result = ReadFromStandardBsdf(
+      stream, {.coefficient_format = CoefficientFormat::kBFloat16});
+  ASSERT_TRUE(result) << result.error();
+
+  for (CoefficientFormat format :
+       {CoefficientFormat::kFloat32, CoefficientFormat::kFloat16}) {
+    auto converted = ConvertCoefficients(*result, format);
+    ASSERT_FALSE(converted);
+    EXPECT_EQ("The coefficients have already been converted",
+              converted.error());
+    EXPECT_EQ(CoefficientFormat::kBFloat16, result->coefficient_format);
+  }
+}
+
+TEST(StandardBsdfReader, ConvertCoefficientsTooLargeForFloat16) {
+  ReadFromStandardBsdfResult bsdf;
+  bsdf.y_coefficients = {1.0f, 65520.0f};
+  bsdf.series_extents = {{0, 2}};
+
+  auto converted = ConvertCoefficients(bsdf, CoefficientFormat::kFloat16);
+  ASSERT_FALSE(converted);
+  EXPECT_EQ("The coefficients are too large to be stored as float16",
+            converted.error());
+  EXPECT_EQ(CoefficientFormat::kFloat32, bsdf.coefficient_format);
+  EXPECT_THAT(bsdf.y_coefficients, ElementsAre(1.0f, 65520.0f));
+  EXPECT_THAT(bsdf.y_half_coefficients, IsEmpty());
+
+  // bfloat16 has the range of a float
+  converted = ConvertCoefficients(bsdf, CoefficientFormat::kBFloat16);
+  ASSERT_TRUE(converted) << converted.error();
+  EXPECT_THAT(bsdf.y_half_coefficients,
+              ElementsAre(FloatToBFloat16(1.0f), FloatToBFloat16(65520.0f)));
+  EXPECT_THAT(bsdf.y_coefficients, IsEmpty());
+}
+
+TEST(StandardBsdfReader, ConvertCoefficientsTooLargeForBFloat16) {
+  ReadFromStandardBsdfResult bsdf;
+  bsdf.y_coefficients = {1.0f, std::numeric_limits<float>::max()};
+  bsdf.series_extents = {{0, 2}};
+
+  auto converted = ConvertCoefficients(bsdf, CoefficientFormat::kBFloat16);
+  ASSERT_FALSE(converted);
+  EXPECT_EQ("The coefficients are too large to be stored as bfloat16",
+            converted.error());
+  EXPECT_EQ(CoefficientFormat::kFloat32, bsdf.coefficient_format);
+  EXPECT_THAT(bsdf.y_coefficients,
+              ElementsAre(1.0f, std::numeric_limits<float>::max()));
+  EXPECT_THAT(bsdf.y_half_coefficients, IsEmpty());
+}
+
+TEST(StandardBsdfReader, SeriesPaddingNotAPowerOfTwo) {
+  for (size_t series_padding : {0u, 3u, 12u}) {
+    std::stringstream stream(MakeMinimalBsdfFile(1.0f, 1.0f, 1.0f));
+    auto result =
+        ReadFromStandardBsdf(stream, {.series_padding = series_padding});
+    ASSERT_FALSE(result);
+    EXPECT_EQ("series_padding must be a power of two", result.error());
+  }
+}
+
+TEST(StandardBsdfReader, SeriesPaddingTooLarge) {
+  for (size_t series_padding :
+       {2u * kMaxSeriesPadding, size_t{1} << 62,
+        size_t{1} << (std::numeric_limits<size_t>::digits - 1)}) {
+    auto result = ReadFromStandardBsdf(*OpenTestData("roughgold_alpha_0.2"),
+                                       {.series_padding = series_padding});
+    ASSERT_FALSE(result) << series_padding;
+    EXPECT_EQ("series_padding must be at most 64", result.error());
+  }
+
+  auto result = ReadFromStandardBsdf(*OpenTestData("roughgold_alpha_0.2"),
+                                     {.series_padding = kMaxSeriesPadding});
+  ASSERT_TRUE(result) << result.error();
+  EXPECT_EQ(kMaxSeriesPadding, result->series_padding);
+  EXPECT_EQ(0u, result->y_coefficients.size() % kMaxSeriesPadding);
+}
+
+TEST(StandardBsdfReader, CompactSeriesExtentsTooLong) {
+  BsdfData data(std::vector<float>({-1.0f, 0.0f, 1.0f}), 1, 1);
+  for (size_t i = 0; i < 3; i++) {
+    for (size_t j = 0; j < 3; j++) {
+      data.AddCoefficient(0, i, j, 1.0f);
+      data.SetCdf(0, i, j, 0.0f);
+    }
+  }
+
+  for (size_t k = 1; k < 65536; k++) {
+    data.AddCoefficient(0, 1, 1, 0.0f);
+  }
+
+  Flags flags{.is_bsdf = true, .uses_harmonic_extrapolation = false};
+  std::stringstream stream(
+      MakeBsdfFile(flags, data, {}, {}, "", 1.0f, 2.0f, 3.0f));
+
+  auto result = ReadFromStandardBsdf(stream, {.compact_series_extents = true});
+  ASSERT_TRUE(result) << result.error();
+  EXPECT_THAT(result->series_offsets, IsEmpty());
+  EXPECT_THAT(result->series_lengths, IsEmpty());
+  ASSERT_THAT(result->series_extents, SizeIs(9));
+  EXPECT_THAT(result->series_extents[4], Pair(4, 65536));
+  EXPECT_THAT(GetSeriesExtent(*result, 4), Pair(4, 65536));
+}
+
+class InterleavedBsdfReader final : public ValidatingBsdfReader {
+ public:
+  std::vector<std::pair<uint32_t, uint32_t>> series;
+  std::vector<float> coefficients;
+  size_t num_color_channels;
+
+ private:
+  std::expected<Options, std::string> Start(const Flags& flags,
+                                            uint32_t num_basis_functions,
+                                            size_t num_color_channels,
+                                            float index_of_refraction,
+                                            float roughness_top,
+                                            float roughness_bottom) override {
+    this->num_color_channels = num_color_channels;
+    return Options();
+  }
+
+  std::expected<void, std::string> HandleSeries(
+      std::vector<std::pair<uint32_t, uint32_t>> series) override {
+    this->series = std::move(series);
+    return std::expected<void, std::string>();
+  }
+
+  std::expected<void, std::string> HandleCoefficients(
+      std::vector<float> coefficients) override {
+    this->coefficients = std::move(coefficients);
+    return std::expected<void, std::string>();
+  }
+};
+
+TEST(StandardBsdfReader, TestDataDeinterleavesCoefficients) {
+  for (const auto& [name, file_params] : kTestDataFiles) {
+    auto input = OpenTestData(name);
+    auto result = ReadFromStandardBsdf(*input);
+    ASSERT_TRUE(result) << name << ": " << result.error();
+
+    input->clear();
+    input->seekg(0);
+    InterleavedBsdfReader reader;
+    ASSERT_TRUE(reader.ReadFrom(*input));
+
+    std::vector<std::pair<size_t, size_t>> expected_extents;
+    AlignedVector<float> expected[3];
+    for (auto [offset, length] : reader.series) {
+      expected_extents.emplace_back(expected[0].size(), length);
+      for (size_t channel = 0; channel < reader.num_color_channels;
+           channel++) {
+        for (size_t i = 0; i < length; i++) {
+          expected[channel].push_back(
+              reader.coefficients[offset + channel * length + i]);
+        }
+      }
+    }
+
+    EXPECT_EQ(result->series_extents, expected_extents) << name;
+    EXPECT_EQ(result->y_coefficients, expected[0]) << name;
+    EXPECT_EQ(result->r_coefficients, expected[1]) << name;
+    EXPECT_EQ(result->b_coefficients, expected[2]) << name;
+  }
+}
+
+TEST(StandardBsdfReader, TestDataLuminanceOnly) {
+  for (const auto& [name, file_params] : kTestDataFiles) {
+    auto expected = ReadFromStandardBsdf(*OpenTestData(name));
+    ASSERT_TRUE(expected) << name << ": " << expected.error();
+
+    auto result =
+        ReadFromStandardBsdf(*OpenTestData(name), {.luminance_only = true});
+    ASSERT_TRUE(result) << name << ": " << result.error();
+
+    EXPECT_EQ(result->elevational_samples, expected->elevational_samples)
+        << name;
+    EXPECT_EQ(result->cdf, expected->cdf) << name;
+    EXPECT_EQ(result->series_extents, expected->series_extents) << name;
+    EXPECT_EQ(result->y_coefficients, expected->y_coefficients) << name;
+    EXPECT_THAT(result->r_coefficients, IsEmpty()) << name;
+    EXPECT_THAT(result->b_coefficients, IsEmpty()) << name;
+  }
+}
+
+TEST(StandardBsdfReader, TestDataCompactSeriesExtents) {
+  for (const auto& [name, file_params] : kTestDataFiles) {
+    auto expected = ReadFromStandardBsdf(*OpenTestData(name));
+    ASSERT_TRUE(expected) << name << ": " << expected.error();
+    EXPECT_THAT(expected->series_offsets, IsEmpty()) << name;
+    EXPECT_THAT(expected->series_lengths, IsEmpty()) << name;
+
+    auto result = ReadFromStandardBsdf(*OpenTestData(name),
+                                       {.compact_series_extents = true});
+    ASSERT_TRUE(result) << name << ": " << result.error();
+    EXPECT_THAT(result->series_extents, IsEmpty()) << name;
+    ASSERT_THAT(result->series_offsets,
+                SizeIs(expected->series_extents.size()))
+        << name;
+    ASSERT_THAT(result->series_lengths,
+                SizeIs(expected->series_extents.size()))
+        << name;
+
+    for (size_t i = 0; i < expected->series_extents.size(); i++) {
+      EXPECT_EQ(expected->series_extents[i], GetSeriesExtent(*result, i))
+          << name;
+      EXPECT_EQ(expected->series_extents[i], GetSeriesExtent(*expected, i))
+          << name;
+    }
+
+    EXPECT_EQ(result->y_coefficients, expected->y_coefficients) << name;
+  }
+}
+
+TEST(StandardBsdfReader, TestDataSeriesPadding) {
+  for (const auto& [name, file_params] : kTestDataFiles) {
+    auto expected = ReadFromStandardBsdf(*OpenTestData(name));
+    ASSERT_TRUE(expected) << name << ": " << expected.error();
+    EXPECT_EQ(1u, expected->series_padding);
+
+    auto result =
+        ReadFromStandardBsdf(*OpenTestData(name), {.series_padding = 16});
+    ASSERT_TRUE(result) << name << ": " << result.error();
+    EXPECT_EQ(16u, result->series_padding);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(result->y_coefficients.data()) %
+                      kCoefficientAlignment)
+        << name;
+
+    size_t num_coefficients = 0;
+    for (size_t i = 0; i < expected->series_extents.size(); i++) {
+      auto [expected_offset, length] = expected->series_extents[i];
+      EXPECT_THAT(result->series_extents[i], Pair(num_coefficients, length))
+          << name;
+
+      size_t padded_length = GetPaddedSeriesLength(*result, length);
+      EXPECT_EQ(0u, padded_length % 16u) << name;
+      EXPECT_LT(padded_length - length, 16u) << name;
+
+      for (size_t k = 0; k < padded_length; k++) {
+        float expected_y =
+            k < length ? expected->y_coefficients[expected_offset + k] : 0.0f;
+        EXPECT_EQ(expected_y, result->y_coefficients[num_coefficients + k])
+            << name;
+        if (!expected->r_coefficients.empty()) {
+          float expected_r =
+              k < length ? expected->r_coefficients[expected_offset + k]
+                         : 0.0f;
+          EXPECT_EQ(expected_r, result->r_coefficients[num_coefficients + k])
+              << name;
+        }
+      }
+
+      num_coefficients += padded_length;
+    }
+
+    EXPECT_EQ(num_coefficients, result->y_coefficients.size()) << name;
+  }
+}
+
+TEST(StandardBsdfReader, TestDataInterleavedColorChannels) {
+  for (const auto& [name, file_params] : kTestDataFiles) {
+    for (size_t series_padding : {1u, 4u}) {
+      auto expected = ReadFromStandardBsdf(*OpenTestData(name),
+                                           {.series_padding = series_padding});
+      ASSERT_TRUE(expected) << name << ": " << expected.error();
+      EXPECT_FALSE(expected->interleaved_color_channels) << name;
+
+      auto result = ReadFromStandardBsdf(
+          *OpenTestData(name), {.series_padding = series_padding,
+                                .interleave_color_channels = true});
+      ASSERT_TRUE(result) << name << ": " << result.error();
+      EXPECT_EQ(HasColor(*expected), result->interleaved_color_channels)
+          << name;
+      EXPECT_EQ(HasColor(*expected), HasColor(*result)) << name;
+      EXPECT_THAT(result->r_coefficients, IsEmpty()) << name;
+      EXPECT_THAT(result->b_coefficients, IsEmpty()) << name;
+
+      const AlignedVector<float>* channels[3] = {&expected->y_coefficients,
+                                                 &expected->r_coefficients,
+                                                 &expected->b_coefficients};
+      size_t num_channels = HasColor(*expected) ? 3 : 1;
+
+      size_t num_coefficients = 0;
+      for (size_t i = 0; i < expected->series_extents.size(); i++) {
+        auto [expected_offset, length] = expected->series_extents[i];
+        EXPECT_THAT(result->series_extents[i], Pair(num_coefficients, length))
+            << name;
+
+        size_t padded_length = GetPaddedSeriesLength(*result, length);
+        size_t stride = GetSeriesChannelStride(*result, length);
+        EXPECT_EQ(num_channels == 3 ? padded_length : 0u, stride) << name;
+
+        for (size_t c = 0; c < num_channels; c++) {
+          for (size_t k = 0; k < padded_length; k++) {
+            EXPECT_EQ((*channels[c])[expected_offset + k],
+                      result->y_coefficients[num_coefficients + c * stride + k])
+                << name;
+          }
+        }
+
+        num_coefficients += num_channels * padded_length;
+      }
+
+      EXPECT_EQ(num_coefficients, result->y_coefficients.size()) << name;
+    }
+  }
+}
+
+TEST(StandardBsdfReader, TestDataCoefficientFormat) {
+  for (const auto& [name, file_params] : kTestDataFiles) {
+    auto expected = ReadFromStandardBsdf(*OpenTestData(name));
+    ASSERT_TRUE(expected) << name << ": " << expected.error();
+    EXPECT_EQ(CoefficientFormat::kFloat32, expected->coefficient_format);
+    EXPECT_EQ(0.0, expected->max_conversion_error);
+
+    for (CoefficientFormat format :
+         {CoefficientFormat::kFloat16, CoefficientFormat::kBFloat16}) {
+      auto result = ReadFromStandardBsdf(*OpenTestData(name),
+                                         {.coefficient_format = format});
+      ASSERT_TRUE(result) << name << ": " << result.error();
+      EXPECT_EQ(format, result->coefficient_format) << name;
+      EXPECT_EQ(result->series_extents, expected->series_extents) << name;
+      EXPECT_EQ(HasColor(*expected), HasColor(*result)) << name;
+      EXPECT_THAT(result->y_coefficients, IsEmpty()) << name;
+      EXPECT_THAT(result->r_coefficients, IsEmpty()) << name;
+      EXPECT_THAT(result->b_coefficients, IsEmpty()) << name;
+
+      const AlignedVector<float>* inputs[3] = {&expected->y_coefficients,
+                                               &expected->r_coefficients,
+                                               &expected->b_coefficients};
+      const AlignedVector<uint16_t>* outputs[3] = {
+          &result->y_half_coefficients, &result->r_half_coefficients,
+          &result->b_half_coefficients};
+
+      double max_error = 0.0;
+      for (size_t c = 0; c < 3; c++) {
+        ASSERT_EQ(inputs[c]->size(), outputs[c]->size()) << name;
+        for (size_t i = 0; i < inputs[c]->size(); i++) {
+          float value = (*inputs[c])[i];
+          uint16_t bits = format == CoefficientFormat::kFloat16
+                              ? FloatToFloat16(value)
+                              : FloatToBFloat16(value);
+          ASSERT_EQ(bits, (*outputs[c])[i]) << name;
+
+          float widened = format == CoefficientFormat::kFloat16
+                              ? Float16ToFloat(bits)
+                              : BFloat16ToFloat(bits);
+          if (value != 0.0f) {
+            max_error = std::max(
+                max_error, std::abs(static_cast<double>(widened) - value) /
+                               std::abs(static_cast<double>(value)));
+          }
+        }
+      }
+
+      EXPECT_EQ(max_error, result->max_conversion_error) << name;
+      EXPECT_EQ(GetLuminanceCoefficient(*result, 0),
+                format == CoefficientFormat::kFloat16
+                    ? Float16ToFloat(result->y_half_coefficients[0])
+                    : BFloat16ToFloat(result->y_half_coefficients[0]))
+          << name;
+
+      // bfloat16 keeps 8 significant bits over the whole range of a float
+      if (format == CoefficientFormat::kBFloat16) {
+        EXPECT_LE(result->max_conversion_error, std::ldexp(1.0, -8)) << name;
+      }
+    }
+  }
+}
+
 }  // namespace
 }  // namespace libfbsdf
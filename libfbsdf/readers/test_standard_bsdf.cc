@@ -0,0 +1,53 @@
+#include "libfbsdf/readers/test_standard_bsdf.h"
+
+#include <cstddef>
+#include <vector>
+
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+
+namespace libfbsdf {
+namespace testing {
+
+ReadFromStandardBsdfResult MakeSeriesBsdf(
+    const std::vector<std::vector<float>>& y_series,
+    const std::vector<std::vector<float>>& r_series,
+    const std::vector<std::vector<float>>& b_series) {
+  ReadFromStandardBsdfResult result;
+  result.elevational_samples = {-1.0f, 1.0f};
+  result.cdf.resize(4, 0.0f);
+  for (size_t i = 0; i < y_series.size(); i++) {
+    result.series_extents.emplace_back(result.y_coefficients.size(),
+                                       y_series[i].size());
+    result.y_coefficients.insert(result.y_coefficients.end(),
+                                 y_series[i].begin(), y_series[i].end());
+    if (!r_series.empty()) {
+      result.r_coefficients.insert(result.r_coefficients.end(),
+                                   r_series[i].begin(), r_series[i].end());
+      result.b_coefficients.insert(result.b_coefficients.end(),
+                                   b_series[i].begin(), b_series[i].end());
+    }
+  }
+  result.index_of_refraction = 1.0f;
+  result.roughness_top = 0.0f;
+  result.roughness_bottom = 0.0f;
+  return result;
+}
+
+ReadFromStandardBsdfResult MakeMonochromeBsdf() {
+  ReadFromStandardBsdfResult result;
+  result.elevational_samples = {-1.0f, 0.0f, 1.0f};
+  result.cdf.resize(9, 0.0f);
+  for (size_t i = 0; i < 9; i++) {
+    result.series_extents.emplace_back(result.y_coefficients.size(), i % 4);
+    for (size_t k = 0; k < i % 4; k++) {
+      result.y_coefficients.push_back(static_cast<float>(i + 1) / (k + 1));
+    }
+  }
+  result.index_of_refraction = 1.0f;
+  result.roughness_top = 0.0f;
+  result.roughness_bottom = 0.0f;
+  return result;
+}
+
+}  // namespace testing
+}  // namespace libfbsdf
@@ -0,0 +1,27 @@
+#ifndef _LIBFBSDF_READERS_TEST_STANDARD_BSDF_
+#define _LIBFBSDF_READERS_TEST_STANDARD_BSDF_
+
+#include <vector>
+
+#include "libfbsdf/readers/standard_bsdf_reader.h"
+
+namespace libfbsdf {
+namespace testing {
+
+// Makes a BSDF with two elevational samples and a series for each entry of
+// `y_series`, stored one after another without padding. If `r_series` and
+// `b_series` are given, they hold the red and blue channels of each series and
+// are stored in separate arrays.
+ReadFromStandardBsdfResult MakeSeriesBsdf(
+    const std::vector<std::vector<float>>& y_series,
+    const std::vector<std::vector<float>>& r_series = {},
+    const std::vector<std::vector<float>>& b_series = {});
+
+// Makes a BSDF with a single color channel and three elevational samples. The
+// series of each pair of samples has between zero and three coefficients.
+ReadFromStandardBsdfResult MakeMonochromeBsdf();
+
+}  // namespace testing
+}  // namespace libfbsdf
+
+#endif  // _LIBFBSDF_READERS_TEST_STANDARD_BSDF_
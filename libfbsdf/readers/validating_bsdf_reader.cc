@@ -5,6 +5,7 @@
 #include <cstdint>
 #include <expected>
 #include <limits>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
@@ -67,6 +68,7 @@ std::expected<BsdfReader::Options, std::string> ValidatingBsdfReader::Start(
   num_coefficients_ = num_coefficients;
   num_parameters_ = num_parameters;
   num_parameter_values_ = num_parameter_values;
+  next_coefficient_index_ = 0u;
   zero_duplicate_already_allowed_ = false;
 
   return Start(flags, num_basis_functions, num_color_channels,
@@ -75,75 +77,121 @@ std::expected<BsdfReader::Options, std::string> ValidatingBsdfReader::Start(
 
 std::expected<void, std::string> ValidatingBsdfReader::HandleElevationalSample(
     float value) {
-  if (auto valid = ValidateElevationalSamples(
-          elevational_samples_, value, options_.allow_duplicates_at_origin,
-          zero_duplicate_already_allowed_);
-      !valid) {
-    return valid;
-  }
+  return HandleElevationalSampleChunk(std::span<const float>(&value, 1));
+}
 
-  elevational_samples_.reserve(num_elevational_samples_1d_);
-  elevational_samples_.push_back(value);
+std::expected<void, std::string> ValidatingBsdfReader::HandleCdf(float value) {
+  return HandleCdfChunk(std::span<const float>(&value, 1));
+}
 
-  std::expected<void, std::string> result;
-  if (elevational_samples_.size() == num_elevational_samples_1d_) {
-    result = HandleElevationalSamples(std::move(elevational_samples_));
-    elevational_samples_.clear();
-  }
+std::expected<void, std::string> ValidatingBsdfReader::HandleSeries(
+    uint32_t offset, uint32_t length) {
+  uint32_t offset_and_length[2] = {offset, length};
+  return HandleSeriesChunk(offset_and_length);
+}
 
-  return result;
+std::expected<void, std::string> ValidatingBsdfReader::HandleCoefficient(
+    float value) {
+  return HandleCoefficientChunk(std::span<const float>(&value, 1));
 }
 
-std::expected<void, std::string> ValidatingBsdfReader::HandleCdf(float value) {
-  if (options_.clamp_cdf) {
-    value = std::clamp(value, 0.0f, 1.0f);
-  } else if (value < 0.0f || value > 1.0f) {
-    return std::unexpected("Input contained a CDF value that was out of range");
-  }
+std::expected<void, std::string> ValidatingBsdfReader::HandleSampleCount(
+    uint32_t value) {
+  return HandleSampleCountChunk(std::span<const uint32_t>(&value, 1));
+}
 
-  if (cdf_.empty() && value != 0.0f) {
-    return std::unexpected(
-        "Input contained a CDF range that did not start with zero");
-  }
+std::expected<void, std::string> ValidatingBsdfReader::HandleSamplePosition(
+    float value) {
+  return HandleSamplePositionChunk(std::span<const float>(&value, 1));
+}
 
-  cdf_.reserve(num_elevational_samples_2d_);
-  cdf_.push_back(value);
+std::expected<void, std::string>
+ValidatingBsdfReader::HandleElevationalSampleChunk(
+    std::span<const float> values) {
+  elevational_samples_.reserve(num_elevational_samples_1d_);
+  for (float value : values) {
+    if (auto valid = ValidateElevationalSamples(
+            elevational_samples_, value, options_.allow_duplicates_at_origin,
+            zero_duplicate_already_allowed_);
+        !valid) {
+      return valid;
+    }
+
+    elevational_samples_.push_back(value);
+  }
 
   std::expected<void, std::string> result;
-  if (cdf_.size() == num_elevational_samples_2d_) {
-    result = HandleCdf(std::move(cdf_));
-    cdf_.clear();
+  if (elevational_samples_.size() == num_elevational_samples_1d_) {
+    result = HandleElevationalSamples(std::move(elevational_samples_));
+    elevational_samples_.clear();
   }
 
   return result;
 }
 
-std::expected<void, std::string> ValidatingBsdfReader::HandleSeries(
-    uint32_t offset, uint32_t length) {
-  if (length != 0u && offset >= num_coefficients_) {
-    return std::unexpected("Input contained an offset that was out of bounds");
-  }
-
-  if (!options_.ignore_longest_series_length &&
-      length > length_longest_series_) {
-    return std::unexpected(
-        "Input contained a series that was longer than the maximum length "
-        "defined in the input");
-  }
-
-  size_t series_length = num_coefficients_per_length_ * length;
-  if (series_length / num_coefficients_per_length_ != length) {
-    return std::unexpected("Input is too large to fit into memory");
+std::expected<void, std::string> ValidatingBsdfReader::HandleCdfChunk(
+    std::span<const float> values) {
+  cdf_.reserve(num_elevational_samples_2d_);
+  for (float value : values) {
+    if (options_.clamp_cdf) {
+      value = std::clamp(value, 0.0f, 1.0f);
+    } else if (value < 0.0f || value > 1.0f) {
+      return std::unexpected(
+          "Input contained a CDF value that was out of range");
+    }
+
+    if (cdf_.empty() && value != 0.0f) {
+      return std::unexpected(
+          "Input contained a CDF range that did not start with zero");
+    }
+
+    cdf_.push_back(value);
+
+    if (cdf_.size() == num_elevational_samples_2d_) {
+      if (auto result = HandleCdf(std::move(cdf_)); !result) {
+        return result;
+      }
+
+      cdf_.clear();
+      cdf_.reserve(num_elevational_samples_2d_);
+    }
   }
 
-  if (num_coefficients_ < series_length ||
-      (series_length != 0u && num_coefficients_ - series_length < offset)) {
-    return std::unexpected(
-        "Input contained a series that extended out of bounds");
-  }
+  return std::expected<void, std::string>();
+}
 
+std::expected<void, std::string> ValidatingBsdfReader::HandleSeriesChunk(
+    std::span<const uint32_t> offsets_and_lengths) {
   series_.reserve(num_elevational_samples_2d_);
-  series_.emplace_back(offset, length);
+  for (size_t i = 0; i + 1 < offsets_and_lengths.size(); i += 2) {
+    uint32_t offset = offsets_and_lengths[i];
+    uint32_t length = offsets_and_lengths[i + 1];
+
+    if (length != 0u && offset >= num_coefficients_) {
+      return std::unexpected(
+          "Input contained an offset that was out of bounds");
+    }
+
+    if (!options_.ignore_longest_series_length &&
+        length > length_longest_series_) {
+      return std::unexpected(
+          "Input contained a series that was longer than the maximum length "
+          "defined in the input");
+    }
+
+    size_t series_length = num_coefficients_per_length_ * length;
+    if (series_length / num_coefficients_per_length_ != length) {
+      return std::unexpected("Input is too large to fit into memory");
+    }
+
+    if (num_coefficients_ < series_length ||
+        (series_length != 0u && num_coefficients_ - series_length < offset)) {
+      return std::unexpected(
+          "Input contained a series that extended out of bounds");
+    }
+
+    series_.emplace_back(offset, length);
+  }
 
   std::expected<void, std::string> result;
   if (series_.size() == num_elevational_samples_2d_) {
@@ -154,10 +202,11 @@ std::expected<void, std::string> ValidatingBsdfReader::HandleSeries(
   return result;
 }
 
-std::expected<void, std::string> ValidatingBsdfReader::HandleCoefficient(
-    float value) {
+std::expected<void, std::string> ValidatingBsdfReader::HandleCoefficientRange(
+    size_t first_index, std::span<const float> coefficients) {
   coefficients_.reserve(num_coefficients_);
-  coefficients_.push_back(value);
+  coefficients_.insert(coefficients_.end(), coefficients.begin(),
+                       coefficients.end());
 
   std::expected<void, std::string> result;
   if (coefficients_.size() == num_coefficients_) {
@@ -168,10 +217,18 @@ std::expected<void, std::string> ValidatingBsdfReader::HandleCoefficient(
   return result;
 }
 
-std::expected<void, std::string> ValidatingBsdfReader::HandleSampleCount(
-    uint32_t value) {
+std::expected<void, std::string> ValidatingBsdfReader::HandleCoefficientChunk(
+    std::span<const float> values) {
+  size_t first_index = next_coefficient_index_;
+  next_coefficient_index_ += values.size();
+  return HandleCoefficientRange(first_index, values);
+}
+
+std::expected<void, std::string> ValidatingBsdfReader::HandleSampleCountChunk(
+    std::span<const uint32_t> values) {
   parameter_sample_counts_.reserve(num_parameters_);
-  parameter_sample_counts_.push_back(value);
+  parameter_sample_counts_.insert(parameter_sample_counts_.end(),
+                                  values.begin(), values.end());
 
   std::expected<void, std::string> result;
   if (parameter_sample_counts_.size() == num_parameters_) {
@@ -182,10 +239,11 @@ std::expected<void, std::string> ValidatingBsdfReader::HandleSampleCount(
   return result;
 }
 
-std::expected<void, std::string> ValidatingBsdfReader::HandleSamplePosition(
-    float value) {
+std::expected<void, std::string>
+ValidatingBsdfReader::HandleSamplePositionChunk(std::span<const float> values) {
   parameter_samples_.reserve(num_parameter_values_);
-  parameter_samples_.push_back(value);
+  parameter_samples_.insert(parameter_samples_.end(), values.begin(),
+                            values.end());
 
   std::expected<void, std::string> result;
   if (parameter_samples_.size() == num_parameter_values_) {
@@ -4,6 +4,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <expected>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
@@ -64,7 +65,8 @@ class ValidatingBsdfReader : public BsdfReader {
 
   // Provides the two dimensional CDF for each elevational sample.
   //
-  // Will be called in order once per basis function in the input, if present.
+  // Will be called in order once per basis function in the input, if present,
+  // up to the `max_cdf_basis_functions` returned by `Start`.
   virtual std::expected<void, std::string> HandleCdf(
       std::vector<float> values) {
     return std::expected<void, std::string>();
@@ -95,6 +97,19 @@ class ValidatingBsdfReader : public BsdfReader {
     return std::expected<void, std::string>();
   }
 
+  // Provides a contiguous range of the Fourier coefficients stored in the
+  // input starting at index `first_index` of the coefficients array. Ranges
+  // are provided in order and the span is only valid for the duration of the
+  // call. Since the series are provided before any coefficients, this allows
+  // coefficients to be placed directly into their final location as they are
+  // read.
+  //
+  // By default, ranges are accumulated and passed to `HandleCoefficients` once
+  // every coefficient has been read. Derived classes that override this
+  // callback will not receive calls to `HandleCoefficients`.
+  virtual std::expected<void, std::string> HandleCoefficientRange(
+      size_t first_index, std::span<const float> coefficients);
+
   // TODO: Document what this contains
   //
   // Will be called once per input, if present.
@@ -136,6 +151,7 @@ class ValidatingBsdfReader : public BsdfReader {
   uint32_t num_parameters_ = 0u;
   uint32_t num_parameter_values_ = 0u;
   size_t num_coefficients_per_length_ = 0u;
+  size_t next_coefficient_index_ = 0u;
   bool zero_duplicate_already_allowed_ = false;
 
   std::expected<Options, std::string> Start(
@@ -161,6 +177,24 @@ class ValidatingBsdfReader : public BsdfReader {
 
   std::expected<void, std::string> HandleSamplePosition(
       float value) override final;
+
+  std::expected<void, std::string> HandleElevationalSampleChunk(
+      std::span<const float> values) override final;
+
+  std::expected<void, std::string> HandleCdfChunk(
+      std::span<const float> values) override final;
+
+  std::expected<void, std::string> HandleSeriesChunk(
+      std::span<const uint32_t> offsets_and_lengths) override final;
+
+  std::expected<void, std::string> HandleCoefficientChunk(
+      std::span<const float> values) override final;
+
+  std::expected<void, std::string> HandleSampleCountChunk(
+      std::span<const uint32_t> values) override final;
+
+  std::expected<void, std::string> HandleSamplePositionChunk(
+      std::span<const float> values) override final;
 };
 
 }  // namespace libfbsdf
@@ -3,6 +3,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <expected>
+#include <span>
 #include <sstream>
 #include <string>
 
@@ -485,5 +486,41 @@ TEST(ValidatingBsdfReader, TestDataLoads) {
   }
 }
 
+class CoefficientRangeBsdfReader : public ValidatingBsdfReader {
+ public:
+  size_t num_coefficients = 0;
+  bool ranges_were_contiguous = true;
+
+  std::expected<Options, std::string> Start(const Flags& flags,
+                                            uint32_t num_basis_functions,
+                                            size_t num_color_channels,
+                                            float index_of_refraction,
+                                            float roughness_top,
+                                            float roughness_bottom) override {
+    return Options();
+  }
+
+  std::expected<void, std::string> HandleCoefficients(
+      std::vector<float> coefficients) override {
+    return std::unexpected("HandleCoefficients");
+  }
+
+  std::expected<void, std::string> HandleCoefficientRange(
+      size_t first_index, std::span<const float> coefficients) override {
+    ranges_were_contiguous &= first_index == num_coefficients;
+    num_coefficients += coefficients.size();
+    return std::expected<void, std::string>();
+  }
+};
+
+TEST(ValidatingBsdfReader, TestDataLoadsCoefficientRanges) {
+  for (const auto& [file_name, file_params] : kTestDataFiles) {
+    CoefficientRangeBsdfReader reader;
+    EXPECT_TRUE(reader.ReadFrom(*OpenTestData(file_name)));
+    EXPECT_EQ(reader.num_coefficients, file_params.num_coefficients);
+    EXPECT_TRUE(reader.ranges_were_contiguous);
+  }
+}
+
 }  // namespace
 }  // namespace libfbsdf
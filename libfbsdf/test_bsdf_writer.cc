@@ -5,6 +5,8 @@
 #include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <ostream>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -29,6 +31,80 @@ void WriteFloat(std::string& output, float value) {
   WriteUInt32(output, std::bit_cast<uint32_t>(value));
 }
 
+std::string MakeHeader(const Flags& flags, size_t num_elevational_samples,
+                       size_t num_coefficients, size_t longest_series_length,
+                       size_t num_color_channels, size_t num_basis_functions,
+                       size_t metadata_size_bytes, size_t num_parameters,
+                       size_t num_parameter_values, float index_of_refraction,
+                       float roughness_top, float roughness_bottom) {
+  std::string result;
+
+  // identifier
+  result += 'S';
+  result += 'C';
+  result += 'A';
+  result += 'T';
+  result += 'F';
+  result += 'U';
+  result += 'N';
+
+  // version
+  result += '\1';
+
+  // flags
+  char is_bsdf = flags.is_bsdf ? '\1' : '\0';
+  char uses_harmonic_extrapolation =
+      flags.uses_harmonic_extrapolation ? '\2' : '\0';
+
+  result += is_bsdf | uses_harmonic_extrapolation;
+  result += '\0';
+  result += '\0';
+  result += '\0';
+
+  // nNodes
+  WriteUInt32(result, num_elevational_samples);
+
+  // nCoeffs
+  WriteUInt32(result, num_coefficients);
+
+  // nMaxOrder
+  WriteUInt32(result, longest_series_length);
+
+  // nChannels
+  WriteUInt32(result, num_color_channels);
+
+  // nBases
+  WriteUInt32(result, num_basis_functions);
+
+  // nMetadataBytes
+  WriteUInt32(result, metadata_size_bytes);
+
+  // nParameters
+  WriteUInt32(result, num_parameters);
+
+  // nParameterValues
+  WriteUInt32(result, num_parameter_values);
+
+  // eta
+  WriteFloat(result, index_of_refraction);
+
+  // roughness
+  WriteFloat(result, roughness_top);
+  WriteFloat(result, roughness_bottom);
+
+  // reserved
+  result += '\0';
+  result += '\0';
+  result += '\0';
+  result += '\0';
+  result += '\0';
+  result += '\0';
+  result += '\0';
+  result += '\0';
+
+  return result;
+}
+
 }  // namespace
 
 BsdfData::BsdfData(std::vector<float> elevational_samples,
@@ -96,70 +172,12 @@ std::string MakeBsdfFile(const Flags& flags, const BsdfData& bsdf_data,
                          float roughness_bottom) {
   BsdfData::Coefficients coefficients = bsdf_data.SerializeCoefficients();
 
-  std::string result;
-
-  // identifier
-  result += 'S';
-  result += 'C';
-  result += 'A';
-  result += 'T';
-  result += 'F';
-  result += 'U';
-  result += 'N';
-
-  // version
-  result += '\1';
-
-  // flags
-  char is_bsdf = flags.is_bsdf ? '\1' : '\0';
-  char uses_harmonic_extrapolation =
-      flags.uses_harmonic_extrapolation ? '\2' : '\0';
-
-  result += is_bsdf | uses_harmonic_extrapolation;
-  result += '\0';
-  result += '\0';
-  result += '\0';
-
-  // nNodes
-  WriteUInt32(result, bsdf_data.GetElevationalSamples().size());
-
-  // nCoeffs
-  WriteUInt32(result, coefficients.coefficients.size());
-
-  // nMaxOrder
-  WriteUInt32(result, coefficients.max_order);
-
-  // nChannels
-  WriteUInt32(result, bsdf_data.GetNumChannels());
-
-  // nBases
-  WriteUInt32(result, bsdf_data.GetNumBasisFunctions());
-
-  // nMetadataBytes
-  WriteUInt32(result, metadata.size());
-
-  // nParameters
-  WriteUInt32(result, parameter_sample_counts.size());
-
-  // nParameterValues
-  WriteUInt32(result, parameters.size());
-
-  // eta
-  WriteFloat(result, index_of_refraction);
-
-  // roughness
-  WriteFloat(result, roughness_top);
-  WriteFloat(result, roughness_bottom);
-
-  // reserved
-  result += '\0';
-  result += '\0';
-  result += '\0';
-  result += '\0';
-  result += '\0';
-  result += '\0';
-  result += '\0';
-  result += '\0';
+  std::string result = MakeHeader(
+      flags, bsdf_data.GetElevationalSamples().size(),
+      coefficients.coefficients.size(), coefficients.max_order,
+      bsdf_data.GetNumChannels(), bsdf_data.GetNumBasisFunctions(),
+      metadata.size(), parameter_sample_counts.size(), parameters.size(),
+      index_of_refraction, roughness_top, roughness_bottom);
 
   for (float f : bsdf_data.GetElevationalSamples()) {
     WriteFloat(result, f);
@@ -228,5 +246,102 @@ std::string MakeNonFiniteBsdfFile(float index_of_refraction,
                       index_of_refraction, roughness_top, roughness_bottom);
 }
 
+void WriteSyntheticBsdfFile(std::ostream& output,
+                            const SyntheticBsdfParams& params) {
+  static constexpr size_t kBufferSize = 1u << 20u;
+
+  size_t num_samples = params.num_elevational_samples;
+  size_t num_coefficients_per_length =
+      params.num_basis_functions * params.num_color_channels;
+  if (params.longest_series_length == 0 ||
+      num_samples > std::numeric_limits<uint32_t>::max() ||
+      params.num_basis_functions > std::numeric_limits<uint32_t>::max() ||
+      params.num_color_channels > std::numeric_limits<uint32_t>::max() ||
+      params.longest_series_length > std::numeric_limits<uint32_t>::max()) {
+    throw std::length_error("invalid synthetic BSDF parameters");
+  }
+
+  auto series_length = [&](size_t x, size_t y) {
+    return 1u + (x + y) % params.longest_series_length;
+  };
+
+  size_t num_coefficients = 0;
+  size_t longest_series_length = 0;
+  for (size_t y = 0; y < num_samples; y++) {
+    for (size_t x = 0; x < num_samples; x++) {
+      size_t length = series_length(x, y);
+      longest_series_length = std::max(longest_series_length, length);
+      num_coefficients += length * num_coefficients_per_length;
+      if (num_coefficients > std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("too many synthetic BSDF coefficients");
+      }
+    }
+  }
+
+  Flags flags{.is_bsdf = true, .uses_harmonic_extrapolation = false};
+  std::string buffer =
+      MakeHeader(flags, num_samples, num_coefficients, longest_series_length,
+                 params.num_color_channels, params.num_basis_functions, 0, 0,
+                 0, 1.0f, 0.0f, 0.0f);
+
+  auto flush = [&](bool force) {
+    if (force || buffer.size() >= kBufferSize) {
+      output.write(buffer.data(), buffer.size());
+      buffer.clear();
+    }
+  };
+
+  for (size_t i = 0; i < num_samples; i++) {
+    double sample = num_samples == 1 ? 0.0 : -1.0 + 2.0 * i / (num_samples - 1);
+    WriteFloat(buffer, static_cast<float>(sample));
+    flush(false);
+  }
+
+  for (size_t basis = 0; basis < params.num_basis_functions; basis++) {
+    for (size_t y = 0; y < num_samples; y++) {
+      for (size_t x = 0; x < num_samples; x++) {
+        double cdf = num_samples == 1 ? 0.0 : x / (num_samples - 1.0);
+        WriteFloat(buffer, static_cast<float>(cdf));
+        flush(false);
+      }
+    }
+  }
+
+  size_t offset = 0;
+  for (size_t y = 0; y < num_samples; y++) {
+    for (size_t x = 0; x < num_samples; x++) {
+      size_t length = series_length(x, y);
+      WriteUInt32(buffer, offset);
+      WriteUInt32(buffer, length);
+      offset += length * num_coefficients_per_length;
+      flush(false);
+    }
+  }
+
+  for (size_t y = 0; y < num_samples; y++) {
+    for (size_t x = 0; x < num_samples; x++) {
+      size_t length = series_length(x, y);
+      for (size_t basis = 0; basis < params.num_basis_functions; basis++) {
+        for (size_t channel = 0; channel < params.num_color_channels;
+             channel++) {
+          for (size_t k = 0; k < length; k++) {
+            float scale = (basis + 1.0f) * (k + 1.0f);
+            WriteFloat(buffer, (channel + 1.0f) / scale);
+          }
+        }
+      }
+      flush(false);
+    }
+  }
+
+  flush(true);
+}
+
+std::string MakeSyntheticBsdfFile(const SyntheticBsdfParams& params) {
+  std::stringstream output;
+  WriteSyntheticBsdfFile(output, params);
+  return output.str();
+}
+
 }  // namespace testing
 }  // namespace libfbsdf
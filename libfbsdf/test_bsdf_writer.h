@@ -3,6 +3,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <ostream>
 #include <string>
 #include <vector>
 
@@ -71,6 +72,29 @@ std::string MakeMinimalBsdfFile(float index_of_refraction, float roughness_top,
 std::string MakeNonFiniteBsdfFile(float index_of_refraction,
                                   float roughness_top, float roughness_bottom);
 
+// The shape of a synthetic BSDF file produced by `WriteSyntheticBsdfFile`
+struct SyntheticBsdfParams {
+  size_t num_elevational_samples;
+  size_t num_basis_functions;
+  size_t num_color_channels;
+  size_t longest_series_length;
+};
+
+// Writes a synthetic BSDF file to `output`. Unlike `MakeBsdfFile`, the file is
+// written as it is generated rather than being assembled in memory first which
+// allows files far larger than the test data to be produced.
+//
+// The elevational samples of the file are evenly spaced between -1 and 1 and
+// the lengths of its series cycle between 1 and `longest_series_length`. Files
+// with at least 3 elevational samples and either 1 or 3 color channels are
+// valid inputs to `ReadFromStandardBsdf`.
+//
+// Throws `std::length_error` if the file cannot be represented in the format.
+void WriteSyntheticBsdfFile(std::ostream& output,
+                            const SyntheticBsdfParams& params);
+
+std::string MakeSyntheticBsdfFile(const SyntheticBsdfParams& params);
+
 }  // namespace testing
 }  // namespace libfbsdf
 